@@ -269,7 +269,9 @@
 %catches(storage::Exception) storage::Device::copy_to_devicegraph(Devicegraph *devicegraph) const;
 %catches(storage::Exception) storage::Device::detect_resize_info() const;
 %catches(storage::Exception) storage::Device::get_name_sort_key() const;
+%catches(storage::Exception) storage::Device::get_userdata(const std::string &key) const;
 %catches(storage::Exception) storage::Devicegraph::check(const CheckCallbacks *check_callbacks=nullptr) const;
+%catches(storage::Exception) storage::Devicegraph::check_incremental(const CheckCallbacks *check_callbacks=nullptr) const;
 %catches(storage::DeviceNotFoundBySid) storage::Devicegraph::find_device(sid_t sid);
 %catches(storage::DeviceNotFoundBySid) storage::Devicegraph::find_device(sid_t sid) const;
 %catches(storage::HolderNotFoundBySids, storage::WrongNumberOfHolders) storage::Devicegraph::find_holder(sid_t source_sid, sid_t target_sid);
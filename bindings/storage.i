@@ -5,9 +5,12 @@
 %module(directors="1") storage
 
 %ignore "get_impl";
+%ignore "swap_impl";
 %ignore "clone";
 %ignore "operator <<";
 %ignore "get_all_if";
+%ignore storage::Devicegraph::batch;
+%ignore storage::Devicegraph::Batch::Batch(Batch&&);
 
 %rename("==") "operator==";
 %rename("!=") "operator!=";
@@ -126,6 +129,7 @@ use_ostream(storage::PartitionSlot);
 #include "storage/SimpleEtcFstab.h"
 #include "storage/SimpleEtcCrypttab.h"
 #include "storage/Devicegraph.h"
+#include "storage/DevicegraphDiff.h"
 #include "storage/Actiongraph.h"
 #include "storage/Pool.h"
 #include "storage/Environment.h"
@@ -222,6 +226,7 @@ use_ostream(storage::PartitionSlot);
 %include "../../storage/SimpleEtcFstab.h"
 %include "../../storage/SimpleEtcCrypttab.h"
 %include "../../storage/Devicegraph.h"
+%include "../../storage/DevicegraphDiff.h"
 %include "../../storage/Actiongraph.h"
 %include "../../storage/Pool.h"
 %include "../../storage/Environment.h"
@@ -367,6 +367,13 @@ namespace storage
 	    return to_blk_device(actiongraph.get_devicegraph(side)->find_device(blk_device->get_sid()));
 	}
 
+
+	Text
+	Barrier::text(const CommitData& commit_data) const
+	{
+	    return UntranslatedText("Barrier");
+	}
+
     }
 
 }
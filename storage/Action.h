@@ -223,6 +223,24 @@ namespace storage
 
 	};
 
+
+	/**
+	 * Internal action without operation used to link two groups of
+	 * actions with a+b instead of a*b edges, see
+	 * Actiongraph::Impl::add_chain(). Barriers are neither committed nor
+	 * reported to the library user.
+	 */
+	class Barrier : public Base
+	{
+	public:
+
+	    Barrier() : Base(0, false, true) {}
+
+	    virtual Text text(const CommitData& commit_data) const override;
+	    virtual void commit(CommitData& commit_data, const CommitOptions& commit_options) const override {}
+
+	};
+
     }
 
 
@@ -258,6 +276,13 @@ namespace storage
 	return is_action_of_type<const Action::Delete>(action);
     }
 
+
+    inline bool
+    is_barrier(const Action::Base* action)
+    {
+	return is_action_of_type<const Action::Barrier>(action);
+    }
+
 }
 
 #endif
@@ -21,6 +21,9 @@
  */
 
 
+#include <unordered_map>
+#include <condition_variable>
+#include <thread>
 #include <boost/graph/copy.hpp>
 #include <boost/graph/topological_sort.hpp>
 #include <boost/graph/transitive_reduction.hpp>
@@ -29,6 +32,7 @@
 
 #include "storage/Utils/Stopwatch.h"
 #include "storage/Utils/CallbacksImpl.h"
+#include "storage/Utils/LoggerImpl.h"
 #include "storage/Devices/DeviceImpl.h"
 #include "storage/Devices/BlkDevice.h"
 #include "storage/Devices/PartitionTableImpl.h"
@@ -38,6 +42,7 @@
 #include "storage/Filesystems/BtrfsImpl.h"
 #include "storage/Filesystems/MountPointImpl.h"
 #include "storage/Devicegraph.h"
+#include "storage/DevicegraphDiffImpl.h"
 #include "storage/Utils/GraphUtils.h"
 #include "storage/Action.h"
 #include "storage/Actiongraph.h"
@@ -67,9 +72,11 @@ namespace storage
     }
 
 
-    EtcFstab&
+    CommitData::Locked<EtcFstab>
     CommitData::get_etc_fstab()
     {
+	std::unique_lock<std::mutex> lock(etc_files_mutex);
+
 	if (!etc_fstab)
 	{
 	    const Storage& storage = actiongraph.get_storage();
@@ -78,13 +85,15 @@ namespace storage
 	    etc_fstab = make_unique<EtcFstab>(filename);
 	}
 
-	return *etc_fstab.get();
+	return Locked<EtcFstab>(std::move(lock), *etc_fstab.get());
     }
 
 
-    EtcCrypttab&
+    CommitData::Locked<EtcCrypttab>
     CommitData::get_etc_crypttab()
     {
+	std::unique_lock<std::mutex> lock(etc_files_mutex);
+
 	if (!etc_crypttab)
 	{
 	    const Storage& storage = actiongraph.get_storage();
@@ -93,13 +102,15 @@ namespace storage
 	    etc_crypttab = make_unique<EtcCrypttab>(filename);
 	}
 
-	return *etc_crypttab.get();
+	return Locked<EtcCrypttab>(std::move(lock), *etc_crypttab.get());
     }
 
 
-    EtcMdadm&
+    CommitData::Locked<EtcMdadm>
     CommitData::get_etc_mdadm()
     {
+	std::unique_lock<std::mutex> lock(etc_files_mutex);
+
 	if (!etc_mdadm)
 	{
 	    const Storage& storage = actiongraph.get_storage();
@@ -108,7 +119,7 @@ namespace storage
 	    etc_mdadm = make_unique<EtcMdadm>(filename);
 	}
 
-	return *etc_mdadm.get();
+	return Locked<EtcMdadm>(std::move(lock), *etc_mdadm.get());
     }
 
 
@@ -136,15 +147,15 @@ namespace storage
 
 	set_gpt_undersized();
 
-	CheckCallbacksLogger check_callbacks_logger;
-
-	storage.check(&check_callbacks_logger);
+	check(storage);
 
 	Stopwatch stopwatch;
 
+	const DevicegraphDiff::Impl diff(lhs, rhs);
+
 	set_special_flags();
-	get_device_actions();
-	get_holder_actions();
+	get_device_actions(diff);
+	get_holder_actions(diff);
 	remove_duplicates();
 	set_special_actions();
 	add_dependencies();
@@ -156,6 +167,15 @@ namespace storage
     }
 
 
+    void
+    Actiongraph::Impl::check(const Storage& storage)
+    {
+	CheckCallbacksLogger check_callbacks_logger;
+
+	storage.check(&check_callbacks_logger);
+    }
+
+
     void
     Actiongraph::Impl::set_gpt_undersized()
     {
@@ -207,14 +227,14 @@ namespace storage
     bool
     Actiongraph::Impl::empty() const
     {
-	return boost::num_vertices(graph) == 0;
+	return num_actions() == 0;
     }
 
 
     size_t
     Actiongraph::Impl::num_actions() const
     {
-	return boost::num_vertices(graph);
+	return boost::num_vertices(graph) - num_barriers;
     }
 
 
@@ -236,7 +256,8 @@ namespace storage
     Actiongraph::Impl::vertex_descriptor
     Actiongraph::Impl::add_vertex(Action::Base* action)
     {
-	return boost::add_vertex(shared_ptr<Action::Base>(action), graph);
+	return boost::add_vertex(graph_t::vertex_property_type(boost::num_vertices(graph),
+							       shared_ptr<Action::Base>(action)), graph);
     }
 
 
@@ -293,13 +314,29 @@ namespace storage
 	    if (!vector.empty())
 		non_empty_vectors.push_back(vector);
 
-	if (non_empty_vectors.size() > 1)
-	    for (size_t i = 1; i < non_empty_vectors.size(); ++i)
-		// As an alternative implementation, we could add sync actions
-		// here instead of creating all the edges right away
-		for (vertex_descriptor left : non_empty_vectors[i - 1])
-		    for (vertex_descriptor right : non_empty_vectors[i])
+	for (size_t i = 1; i < non_empty_vectors.size(); ++i)
+	{
+	    const vector<vertex_descriptor>& lefts = non_empty_vectors[i - 1];
+	    const vector<vertex_descriptor>& rights = non_empty_vectors[i];
+
+	    if (lefts.size() * rights.size() <= lefts.size() + rights.size())
+	    {
+		for (vertex_descriptor left : lefts)
+		    for (vertex_descriptor right : rights)
 			add_edge(left, right);
+	    }
+	    else
+	    {
+		vertex_descriptor barrier = add_vertex(new Action::Barrier());
+		++num_barriers;
+
+		for (vertex_descriptor left : lefts)
+		    add_edge(left, barrier);
+
+		for (vertex_descriptor right : rights)
+		    add_edge(barrier, right);
+	    }
+	}
     }
 
 
@@ -386,45 +423,26 @@ namespace storage
 
 
     void
-    Actiongraph::Impl::get_device_actions()
+    Actiongraph::Impl::get_device_actions(const DevicegraphDiff::Impl& diff)
     {
-	const set<sid_t> lhs_sids = lhs->get_impl().get_device_sids();
-	const set<sid_t> rhs_sids = rhs->get_impl().get_device_sids();
-
-	vector<sid_t> created_sids;
-	set_difference(rhs_sids.begin(), rhs_sids.end(), lhs_sids.begin(), lhs_sids.end(),
-		       back_inserter(created_sids));
-
-	vector<sid_t> common_sids;
-	set_intersection(lhs_sids.begin(), lhs_sids.end(), rhs_sids.begin(), rhs_sids.end(),
-			 back_inserter(common_sids));
-
-	vector<sid_t> deleted_sids;
-	set_difference(lhs_sids.begin(), lhs_sids.end(), rhs_sids.begin(), rhs_sids.end(),
-		       back_inserter(deleted_sids));
-
-	for (sid_t sid : created_sids)
+	for (Devicegraph::Impl::vertex_descriptor v_rhs : diff.get_created_vertices())
 	{
-	    Devicegraph::Impl::vertex_descriptor v_rhs = rhs->get_impl().find_vertex(sid);
 	    const Device* d_rhs = rhs->get_impl()[v_rhs];
 
 	    d_rhs->get_impl().add_create_actions(*this);
 	}
 
-	for (sid_t sid : common_sids)
+	for (const pair<Devicegraph::Impl::vertex_descriptor, Devicegraph::Impl::vertex_descriptor>& vertices :
+		 diff.get_common_vertices())
 	{
-	    Devicegraph::Impl::vertex_descriptor v_lhs = lhs->get_impl().find_vertex(sid);
-	    const Device* d_lhs = lhs->get_impl()[v_lhs];
-
-	    Devicegraph::Impl::vertex_descriptor v_rhs = rhs->get_impl().find_vertex(sid);
-	    const Device* d_rhs = rhs->get_impl()[v_rhs];
+	    const Device* d_lhs = lhs->get_impl()[vertices.first];
+	    const Device* d_rhs = rhs->get_impl()[vertices.second];
 
 	    d_rhs->get_impl().add_modify_actions(*this, d_lhs);
 	}
 
-	for (sid_t sid : deleted_sids)
+	for (Devicegraph::Impl::vertex_descriptor v_lhs : diff.get_deleted_vertices())
 	{
-	    Devicegraph::Impl::vertex_descriptor v_lhs = lhs->get_impl().find_vertex(sid);
 	    const Device* d_lhs = lhs->get_impl()[v_lhs];
 
 	    d_lhs->get_impl().add_delete_actions(*this);
@@ -433,48 +451,20 @@ namespace storage
 
 
     void
-    Actiongraph::Impl::get_holder_actions()
+    Actiongraph::Impl::get_holder_actions(const DevicegraphDiff::Impl& diff)
     {
-	const set<sid_pair_t> lhs_sid_pairs = lhs->get_impl().get_holder_sid_pairs();
-	const set<sid_pair_t> rhs_sid_pairs = rhs->get_impl().get_holder_sid_pairs();
-
-	vector<sid_pair_t> created_sid_pairs;
-	set_difference(rhs_sid_pairs.begin(), rhs_sid_pairs.end(), lhs_sid_pairs.begin(), lhs_sid_pairs.end(),
-		       back_inserter(created_sid_pairs));
-
-	vector<sid_pair_t> common_sid_pairs;
-	set_intersection(lhs_sid_pairs.begin(), lhs_sid_pairs.end(), rhs_sid_pairs.begin(), rhs_sid_pairs.end(),
-			 back_inserter(common_sid_pairs));
-
-	vector<sid_pair_t> deleted_sid_pairs;
-	set_difference(lhs_sid_pairs.begin(), lhs_sid_pairs.end(), rhs_sid_pairs.begin(), rhs_sid_pairs.end(),
-		       back_inserter(deleted_sid_pairs));
-
-	for (sid_pair_t sid_pair : created_sid_pairs)
+	for (Devicegraph::Impl::edge_descriptor e_rhs : diff.get_created_edges())
 	{
-	    for (Devicegraph::Impl::edge_descriptor e_rhs : rhs->get_impl().find_edges(sid_pair))
-	    {
-		const Holder* h_rhs = rhs->get_impl()[e_rhs];
-
-		h_rhs->get_impl().add_create_actions(*this);
-	    }
-	}
+	    const Holder* h_rhs = rhs->get_impl()[e_rhs];
 
-	/*
-	for (sid_pair_t sid_pair : common_sid_pairs)
-	{
-	    // not needed yet
+	    h_rhs->get_impl().add_create_actions(*this);
 	}
-	*/
 
-	for (sid_pair_t sid_pair : deleted_sid_pairs)
+	for (Devicegraph::Impl::edge_descriptor e_lhs : diff.get_deleted_edges())
 	{
-	    for (Devicegraph::Impl::edge_descriptor e_lhs : lhs->get_impl().find_edges(sid_pair))
-	    {
-		const Holder* h_lhs = lhs->get_impl()[e_lhs];
+	    const Holder* h_lhs = lhs->get_impl()[e_lhs];
 
-		h_lhs->get_impl().add_delete_actions(*this);
-	    }
+	    h_lhs->get_impl().add_delete_actions(*this);
 	}
     }
 
@@ -488,28 +478,56 @@ namespace storage
     void
     Actiongraph::Impl::remove_duplicates()
     {
-	vector<pair<vertex_descriptor, vertex_descriptor>> duplicates;
+	// Group the mount and unmount actions by sid in one pass. Later
+	// actions of a group are merged into the first one. The merges are
+	// sorted by the position of the first action so that the resulting
+	// graph is identical to the one of a pairwise comparison.
 
-	boost::iterator_range<vertex_iterator> range = vertices();
+	struct First
+	{
+	    size_t position;
+	    vertex_descriptor vertex;
+	};
 
-	for (vertex_iterator it1 = range.begin(); it1 != range.end(); ++it1)
+	struct Duplicate
 	{
-	    const Action::Base* action1 = graph[*it1].get();
+	    size_t position;
+	    vertex_descriptor first;
+	    vertex_descriptor second;
+	};
 
-	    for (vertex_iterator it2 = next(it1); it2 != range.end(); ++it2)
-	    {
-		const Action::Base* action2 = graph[*it2].get();
+	unordered_map<sid_t, First> first_mounts;
+	unordered_map<sid_t, First> first_unmounts;
 
-		if (action1->sid == action2->sid)
-		{
-		    if ((is_mount(action1) && is_mount(action2)) ||
-			(is_unmount(action1) && is_unmount(action2)))
-			duplicates.push_back(make_pair(*it1, *it2));
-		}
+	vector<Duplicate> duplicates;
+
+	size_t position = 0;
+
+	for (vertex_descriptor vertex : vertices())
+	{
+	    const Action::Base* action = graph[vertex].get();
+
+	    unordered_map<sid_t, First>* firsts = nullptr;
+	    if (is_mount(action))
+		firsts = &first_mounts;
+	    else if (is_unmount(action))
+		firsts = &first_unmounts;
+
+	    if (firsts)
+	    {
+		const First& first = firsts->emplace(action->sid, First{ position, vertex }).first->second;
+		if (first.vertex != vertex)
+		    duplicates.push_back({ first.position, first.vertex, vertex });
 	    }
+
+	    ++position;
 	}
 
-	for (pair<vertex_descriptor, vertex_descriptor> duplicate : duplicates)
+	stable_sort(duplicates.begin(), duplicates.end(), [](const Duplicate& lhs, const Duplicate& rhs) {
+	    return lhs.position < rhs.position;
+	});
+
+	for (const Duplicate& duplicate : duplicates)
 	{
 	    for (vertex_descriptor parent : parents(duplicate.second))
 		add_edge(parent, duplicate.first);
@@ -520,6 +538,9 @@ namespace storage
 	    clear_vertex(duplicate.second, graph);
 	    remove_vertex(duplicate.second, graph);
 	}
+
+	if (!duplicates.empty())
+	    compact_vertex_index();
     }
 
 
@@ -673,23 +694,44 @@ namespace storage
 	    clear_vertex(vertex, graph);
 	    remove_vertex(vertex, graph);
 	}
+
+	if (!only_syncs.empty())
+	    compact_vertex_index();
     }
 
 
     void
     Actiongraph::Impl::calculate_order()
     {
-	VertexIndexMapGenerator<graph_t> vertex_index_map_generator(graph);
-
 	try
 	{
-	    boost::topological_sort(graph, front_inserter(order),
-				    vertex_index_map(vertex_index_map_generator.get()));
+	    boost::topological_sort(graph, front_inserter(order));
 	}
 	catch (const boost::not_a_dag&)
 	{
 	    ST_THROW(Exception("actiongraph not a DAG"));
 	}
+
+	// Barriers are only needed for the order and are not committed.
+
+	if (num_barriers > 0)
+	{
+	    Order::iterator it = remove_if(order.begin(), order.end(), [this](vertex_descriptor vertex) {
+		return is_barrier(graph[vertex].get());
+	    });
+
+	    order.erase(it, order.end());
+	}
+    }
+
+
+    void
+    Actiongraph::Impl::compact_vertex_index()
+    {
+	size_t index = 0;
+
+	for (vertex_descriptor vertex : vertices())
+	    boost::put(boost::vertex_index, graph, vertex, index++);
     }
 
 
@@ -733,6 +775,19 @@ namespace storage
 
 	CommitData commit_data(*this, Tense::PRESENT_CONTINUOUS);
 
+	if (commit_options.max_parallel_actions > 1)
+	    commit_parallel(commit_data, commit_options, commit_callbacks);
+	else
+	    commit_serial(commit_data, commit_options, commit_callbacks);
+
+	y2mil("commit end");
+    }
+
+
+    void
+    Actiongraph::Impl::commit_serial(CommitData& commit_data, const CommitOptions& commit_options,
+				     const CommitCallbacks* commit_callbacks) const
+    {
 	for (const vertex_descriptor vertex : order)
 	{
 	    const Action::Base* action = graph[vertex].get();
@@ -757,8 +812,252 @@ namespace storage
 		error_callback(commit_callbacks, text, exception);
 	    }
 	}
+    }
+
+
+    namespace
+    {
+
+	/**
+	 * Result of committing one action in a worker thread. The log
+	 * messages and the exception are passed on by the main thread.
+	 */
+	struct CommitResult
+	{
+	    LogBuffer log_buffer;
+	    std::exception_ptr exception = nullptr;
+	};
 
-	y2mil("commit end");
+    }
+
+
+    void
+    Actiongraph::Impl::commit_parallel(CommitData& commit_data, const CommitOptions& commit_options,
+				       const CommitCallbacks* commit_callbacks) const
+    {
+	// The main thread schedules the actions: Every action whose parents
+	// have been committed is ready and passed to one of the worker
+	// threads. If several actions are ready the one first in order is
+	// taken. Barriers are not committed and complete as soon as they are
+	// ready. Loggers and callbacks might be implemented by the bindings
+	// and are only called by the main thread.
+
+	// Actions are identified by their position in order.
+
+	vector<size_t> positions(boost::num_vertices(graph), 0);
+	for (size_t position = 0; position < order.size(); ++position)
+	    positions[boost::get(boost::vertex_index, graph, order[position])] = position;
+
+	vector<size_t> num_pending_parents(boost::num_vertices(graph), 0);
+
+	set<size_t> ready;
+
+	// Marks the vertices as completed and collects the children that
+	// become ready.
+
+	auto complete = [this, &positions, &num_pending_parents, &ready](vector<vertex_descriptor> completed) {
+
+	    while (!completed.empty())
+	    {
+		vertex_descriptor vertex = completed.back();
+		completed.pop_back();
+
+		for (vertex_descriptor child : children(vertex))
+		{
+		    if (--num_pending_parents[boost::get(boost::vertex_index, graph, child)] > 0)
+			continue;
+
+		    if (is_barrier(graph[child].get()))
+			completed.push_back(child);
+		    else
+			ready.insert(positions[boost::get(boost::vertex_index, graph, child)]);
+		}
+	    }
+
+	};
+
+	vector<vertex_descriptor> barriers_without_parents;
+
+	for (vertex_descriptor vertex : vertices())
+	{
+	    size_t num_parents = boost::in_degree(vertex, graph);
+
+	    num_pending_parents[boost::get(boost::vertex_index, graph, vertex)] = num_parents;
+
+	    if (num_parents > 0)
+		continue;
+
+	    if (is_barrier(graph[vertex].get()))
+		barriers_without_parents.push_back(vertex);
+	    else
+		ready.insert(positions[boost::get(boost::vertex_index, graph, vertex)]);
+	}
+
+	complete(barriers_without_parents);
+
+	// The worker threads take dispatched actions from todo and report
+	// committed actions in done.
+
+	vector<Text> texts(order.size());
+	vector<CommitResult> results(order.size());
+
+	std::mutex mutex;
+	std::condition_variable todo_condition;
+	std::condition_variable done_condition;
+	deque<size_t> todo;
+	deque<size_t> done;
+	bool finished = false;
+
+	auto worker = [this, &commit_data, &commit_options, &results, &mutex, &todo_condition,
+		       &done_condition, &todo, &done, &finished]() {
+
+	    while (true)
+	    {
+		size_t position;
+
+		{
+		    std::unique_lock<std::mutex> lock(mutex);
+		    todo_condition.wait(lock, [&todo, &finished]() { return finished || !todo.empty(); });
+
+		    if (todo.empty())
+			return;
+
+		    position = todo.front();
+		    todo.pop_front();
+		}
+
+		CommitResult& result = results[position];
+
+		{
+		    LogRedirect log_redirect(result.log_buffer);
+
+		    try
+		    {
+			graph[order[position]]->commit(commit_data, commit_options);
+		    }
+		    catch (...)
+		    {
+			result.exception = std::current_exception();
+		    }
+		}
+
+		{
+		    std::lock_guard<std::mutex> lock(mutex);
+		    done.push_back(position);
+		}
+
+		done_condition.notify_one();
+	    }
+
+	};
+
+	const size_t num_threads = std::min<size_t>(commit_options.max_parallel_actions, order.size());
+
+	y2mil("committing with " << num_threads << " worker threads");
+
+	vector<std::thread> threads;
+	for (size_t i = 0; i < num_threads; ++i)
+	    threads.emplace_back(worker);
+
+	// After an exception no further actions are dispatched. The exception
+	// is rethrown once all running actions have finished.
+
+	std::exception_ptr exception = nullptr;
+	size_t num_running = 0;
+
+	while (num_running > 0 || (!exception && !ready.empty()))
+	{
+	    try
+	    {
+		while (!exception && !ready.empty() && num_running < num_threads)
+		{
+		    size_t position = *ready.begin();
+		    ready.erase(ready.begin());
+
+		    const Action::Base* action = graph[order[position]].get();
+
+		    texts[position] = action->text(commit_data);
+
+		    y2mil("Commit Action \"" << texts[position].native << "\" [" << action->details() << "]");
+
+		    message_callback(commit_callbacks, texts[position]);
+
+		    if (action->nop)
+		    {
+			complete({ order[position] });
+			continue;
+		    }
+
+		    {
+			std::lock_guard<std::mutex> lock(mutex);
+			todo.push_back(position);
+		    }
+
+		    todo_condition.notify_one();
+
+		    ++num_running;
+		}
+	    }
+	    catch (...)
+	    {
+		exception = std::current_exception();
+	    }
+
+	    if (num_running == 0)
+		continue;
+
+	    size_t position;
+
+	    {
+		std::unique_lock<std::mutex> lock(mutex);
+		done_condition.wait(lock, [&done]() { return !done.empty(); });
+
+		position = done.front();
+		done.pop_front();
+	    }
+
+	    --num_running;
+
+	    CommitResult& result = results[position];
+
+	    result.log_buffer.flush();
+
+	    if (result.exception && !exception)
+	    {
+		try
+		{
+		    try
+		    {
+			std::rethrow_exception(result.exception);
+		    }
+		    catch (const Exception& e)
+		    {
+			ST_CAUGHT(e);
+
+			error_callback(commit_callbacks, texts[position], e);
+		    }
+		}
+		catch (...)
+		{
+		    exception = std::current_exception();
+		}
+	    }
+
+	    complete({ order[position] });
+	}
+
+	{
+	    std::lock_guard<std::mutex> lock(mutex);
+	    finished = true;
+	}
+
+	todo_condition.notify_all();
+
+	for (std::thread& thread : threads)
+	    thread.join();
+
+	if (exception)
+	    std::rethrow_exception(exception);
     }
 
 
@@ -823,7 +1122,12 @@ namespace storage
 	    void operator()(ostream& out, const Actiongraph::Impl::vertex_descriptor& vertex) const
 	    {
 		const Action::Base* action = commit_data.actiongraph[vertex];
-		write_attributes(out, style_callbacks->node(commit_data, action));
+
+		// Barriers are no actions for the user, only keep the edges.
+		if (is_barrier(action))
+		    write_attributes(out, { { "shape", "point" }, { "label", "" } });
+		else
+		    write_attributes(out, style_callbacks->node(commit_data, action));
 	    }
 
 	    void operator()(ostream& out, const Actiongraph::Impl::edge_descriptor& edge) const
@@ -843,13 +1147,10 @@ namespace storage
 
 	fout << "// " << generated_string() << "\n\n";
 
-	VertexIndexMapGenerator<graph_t> vertex_index_map_generator(graph);
-
 	const CommitData commit_data(*this, Tense::SIMPLE_PRESENT);
 
 	const ActiongraphWriter actiongraph_writer(style_callbacks, commit_data);
-	boost::write_graphviz(fout, graph, actiongraph_writer, actiongraph_writer, actiongraph_writer,
-			      vertex_index_map_generator.get());
+	boost::write_graphviz(fout, graph, actiongraph_writer, actiongraph_writer, actiongraph_writer);
 
 	fout.close();
 
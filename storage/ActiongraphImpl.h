@@ -28,11 +28,13 @@
 #include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <boost/noncopyable.hpp>
 #include <boost/graph/adjacency_list.hpp>
 
 #include "storage/Devices/Device.h"
 #include "storage/Actiongraph.h"
+#include "storage/DevicegraphDiff.h"
 #include "storage/Utils/Text.h"
 #include "storage/CommitOptions.h"
 
@@ -78,12 +80,37 @@ namespace storage
 	const Actiongraph::Impl& actiongraph;
 	const Tense tense;
 
-	EtcFstab& get_etc_fstab();
-	EtcCrypttab& get_etc_crypttab();
-	EtcMdadm& get_etc_mdadm();
+	/**
+	 * Reference to one of the etc files that keeps the files locked
+	 * while it exists. Actions can be committed in parallel, so the
+	 * object must only be used through the Locked.
+	 */
+	template <typename Type>
+	class Locked
+	{
+	public:
+
+	    Locked(std::unique_lock<std::mutex>&& lock, Type& object)
+		: lock(std::move(lock)), object(object) {}
+
+	    Type& operator*() const { return object; }
+	    Type* operator->() const { return &object; }
+
+	private:
+
+	    std::unique_lock<std::mutex> lock;
+	    Type& object;
+
+	};
+
+	Locked<EtcFstab> get_etc_fstab();
+	Locked<EtcCrypttab> get_etc_crypttab();
+	Locked<EtcMdadm> get_etc_mdadm();
 
     private:
 
+	std::mutex etc_files_mutex;
+
 	std::unique_ptr<EtcFstab> etc_fstab;
 	std::unique_ptr<EtcCrypttab> etc_crypttab;
 	std::unique_ptr<EtcMdadm> etc_mdadm;
@@ -96,8 +123,12 @@ namespace storage
 
     private:
 
+	// The vertex_index property is required by several algorithms. It is
+	// dense, see compact_vertex_index().
+
 	typedef boost::adjacency_list<boost::vecS, boost::listS, boost::bidirectionalS,
-				      std::shared_ptr<Action::Base>> graph_t;
+				      boost::property<boost::vertex_index_t, size_t, std::shared_ptr<Action::Base>>>
+	    graph_t;
 
     public:
 
@@ -114,6 +145,13 @@ namespace storage
 
 	Impl(const Storage& storage, Devicegraph* lhs, Devicegraph* rhs);
 
+	/**
+	 * Runs the checks of all devicegraphs done before generating an
+	 * actiongraph, logging the errors. Also used when an actiongraph
+	 * is reused.
+	 */
+	static void check(const Storage& storage);
+
 	const Storage& get_storage() const { return storage; }
 
 	Devicegraph* get_devicegraph(Side side) const { return side == LHS ? lhs : rhs; }
@@ -148,11 +186,11 @@ namespace storage
 	/**
 	 * Adds several edges (dependencies) to the graph, linking groups of
 	 * actions in the given order. Thus, every action from the first vector
-	 * will have an edge to every action from the second vector and so on.
+	 * will be done before every action from the second vector and so on.
 	 *
-	 * By definition, the cost of this function is O(n^3). Although
-	 * creating edges is not an expensive operation, take that cost into
-	 * account when creating edges massively.
+	 * If linking two groups directly would need more edges than linking
+	 * them via a barrier action the barrier is used. So linking groups
+	 * of size a and b needs at most a + b edges.
 	 */
 	void add_chain(const vector<vector<vertex_descriptor>>& actions);
 
@@ -193,8 +231,8 @@ namespace storage
 	void set_gpt_undersized();
 
 	void set_special_flags();
-	void get_device_actions();
-	void get_holder_actions();
+	void get_device_actions(const DevicegraphDiff::Impl& diff);
+	void get_holder_actions(const DevicegraphDiff::Impl& diff);
 	void remove_duplicates();
 	void set_special_actions();
 	void add_dependencies();
@@ -202,6 +240,17 @@ namespace storage
 	void remove_only_syncs();
 	void calculate_order();
 
+	void commit_serial(CommitData& commit_data, const CommitOptions& commit_options,
+			   const CommitCallbacks* commit_callbacks) const;
+	void commit_parallel(CommitData& commit_data, const CommitOptions& commit_options,
+			     const CommitCallbacks* commit_callbacks) const;
+
+	/**
+	 * Renumber the vertex_index property of all vertices in the order of
+	 * vertices(). Must be called after removing vertices.
+	 */
+	void compact_vertex_index();
+
 	const Storage& storage;
 
 	Devicegraph* lhs;
@@ -211,6 +260,12 @@ namespace storage
 
 	Order order;
 
+	/**
+	 * Number of barrier actions in the graph. Barriers are not included in
+	 * order and num_actions().
+	 */
+	size_t num_barriers = 0;
+
 	graph_t graph;
 
 	map<sid_t, vector<vertex_descriptor>> cache_for_actions_with_sid;
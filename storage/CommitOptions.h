@@ -37,6 +37,16 @@ namespace storage
 
 	const bool force_rw;
 
+	/**
+	 * Maximal number of actions committed at the same time. With the
+	 * default of 1 the actions are committed one after another. With a
+	 * larger value every action whose predecessors in the actiongraph
+	 * have been committed is run by one of at most that many worker
+	 * threads. The commit callbacks and the logger are still only called
+	 * by the thread that called Storage::commit().
+	 */
+	unsigned int max_parallel_actions = 1;
+
     };
 
 }
@@ -27,7 +27,6 @@
 #include <boost/graph/graph_utility.hpp>
 
 #include "storage/Devicegraph.h"
-#include "storage/Utils/GraphUtils.h"
 #include "storage/Devices/DeviceImpl.h"
 #include "storage/Devices/Bcache.h"
 #include "storage/Devices/BlkDevice.h"
@@ -163,9 +162,9 @@ namespace storage
 
 
     void
-    Devicegraph::save(const string& filename) const
+    Devicegraph::save(const string& filename, DevicegraphFormat format) const
     {
-	get_impl().save(filename);
+	get_impl().save(filename, format);
     }
 
 
@@ -405,6 +404,110 @@ namespace storage
     }
 
 
+    unsigned int
+    Devicegraph::checkpoint()
+    {
+	return get_impl().checkpoint();
+    }
+
+
+    void
+    Devicegraph::rollback(unsigned int checkpoint)
+    {
+	get_impl().rollback(checkpoint);
+    }
+
+
+    void
+    Devicegraph::release_checkpoint(unsigned int checkpoint)
+    {
+	get_impl().release_checkpoint(checkpoint);
+    }
+
+
+    Devicegraph::Batch::Batch(Devicegraph* devicegraph)
+	: devicegraph(devicegraph), checkpoint(0)
+    {
+	ST_CHECK_PTR(devicegraph);
+
+	checkpoint = devicegraph->get_impl().checkpoint();
+	devicegraph->get_impl().begin_batch();
+    }
+
+
+    Devicegraph::Batch::Batch(Batch&& batch)
+	: devicegraph(batch.devicegraph), checkpoint(batch.checkpoint)
+    {
+	batch.devicegraph = nullptr;
+    }
+
+
+    Devicegraph::Batch::~Batch()
+    {
+	if (!devicegraph)
+	    return;
+
+	Devicegraph::Impl& impl = devicegraph->get_impl();
+
+	// Without commit() the batch was aborted, e.g. by an exception. Undo
+	// its modifications before ending it so that no duplicate holders
+	// are left behind. The batch must end even if the rollback fails,
+	// e.g. since clear() invalidated the checkpoint, since otherwise the
+	// indices would never be maintained again.
+
+	try
+	{
+	    impl.rollback(checkpoint);
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+	}
+
+	try
+	{
+	    impl.end_batch();
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+	}
+    }
+
+
+    void
+    Devicegraph::Batch::commit()
+    {
+	if (!devicegraph)
+	    return;
+
+	Devicegraph::Impl& impl = devicegraph->get_impl();
+	devicegraph = nullptr;
+
+	try
+	{
+	    impl.end_batch();
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+
+	    impl.rollback(checkpoint);
+
+	    ST_RETHROW(exception);
+	}
+
+	impl.release_checkpoint(checkpoint);
+    }
+
+
+    Devicegraph::Batch
+    Devicegraph::batch()
+    {
+	return Batch(this);
+    }
+
+
     void
     Devicegraph::check(const CheckCallbacks* check_callbacks) const
     {
@@ -412,6 +515,13 @@ namespace storage
     }
 
 
+    void
+    Devicegraph::check_incremental(const CheckCallbacks* check_callbacks) const
+    {
+	get_impl().check_incremental(check_callbacks);
+    }
+
+
     uint64_t
     Devicegraph::used_features() const
     {
@@ -431,13 +541,12 @@ namespace storage
     {
 	dest.get_impl().clear();
 
-	VertexIndexMapGenerator<Impl::graph_t> vertex_index_map_generator(get_impl().graph);
-
 	CloneCopier copier(*this, dest);
 
 	boost::copy_graph(get_impl().graph, dest.get_impl().graph,
-			  vertex_index_map(vertex_index_map_generator.get()).
-			  vertex_copy(copier).edge_copy(copier));
+			  boost::vertex_copy(copier).edge_copy(copier));
+
+	dest.get_impl().rebuild_indices();
     }
 
 
@@ -46,6 +46,25 @@ namespace storage
     class CheckCallbacks;
 
 
+    /**
+     * File formats for saving devicegraphs, see Devicegraph::save().
+     */
+    enum class DevicegraphFormat
+    {
+	/**
+	 * The XML format, readable and stable.
+	 */
+	XML,
+
+	/**
+	 * A compact binary format that is faster to save and load. The
+	 * format has a version and files written by other versions of
+	 * the library might not be loadable.
+	 */
+	BINARY
+    };
+
+
     class DeviceNotFound : public Exception
     {
     public:
@@ -188,7 +207,8 @@ namespace storage
 	const Storage* get_storage() const;
 
 	/**
-	 * Load the devicegraph from a file.
+	 * Load the devicegraph from a file. The format of the file is
+	 * detected automatically.
 	 *
 	 * @throw Exception
 	 */
@@ -199,7 +219,7 @@ namespace storage
 	 *
 	 * @throw Exception
 	 */
-	void save(const std::string& filename) const;
+	void save(const std::string& filename, DevicegraphFormat format = DevicegraphFormat::XML) const;
 
 	/**
 	 * Query whether the devicegraph is empty.
@@ -370,6 +390,101 @@ namespace storage
 	 */
 	void remove_holder(Holder* holder);
 
+	/**
+	 * Creates a checkpoint of the devicegraph and returns its id. Until
+	 * the checkpoint is rolled back or released, adding and removing
+	 * devices and holders as well as changing their attributes is
+	 * recorded so that it can be undone by rollback(). Checkpoints can
+	 * be nested. Ids are never reused within a devicegraph.
+	 *
+	 * Clearing the devicegraph or restoring it from another devicegraph
+	 * releases all checkpoints.
+	 */
+	unsigned int checkpoint();
+
+	/**
+	 * Undoes the changes of devices and holders since the checkpoint
+	 * was created. Removed devices and holders are put back into the
+	 * devicegraph, so pointers to them stay valid. Releases the
+	 * checkpoint and all later checkpoints.
+	 *
+	 * Devices and holders put back come after all other devices and
+	 * holders in the order of e.g. Device::get_all(), so that order can
+	 * differ from the one at the time of the checkpoint.
+	 *
+	 * @throw Exception
+	 */
+	void rollback(unsigned int checkpoint);
+
+	/**
+	 * Releases the checkpoint and all later checkpoints without undoing
+	 * any changes.
+	 *
+	 * @throw Exception
+	 */
+	void release_checkpoint(unsigned int checkpoint);
+
+	/**
+	 * Scope of a batch of modifications, see batch().
+	 */
+	class Batch
+	{
+	public:
+
+	    /**
+	     * Starts a batch. Batches can be nested.
+	     */
+	    Batch(Devicegraph* devicegraph);
+
+	    Batch(Batch&& batch);
+
+	    Batch(const Batch&) = delete;
+	    Batch& operator=(const Batch&) = delete;
+
+	    /**
+	     * Undoes all modifications done during the batch and ends the
+	     * batch unless commit() was called, e.g. when an exception is
+	     * thrown during the batch. So commit() must be called to keep
+	     * the modifications. Errors are only logged.
+	     */
+	    ~Batch();
+
+	    /**
+	     * Ends the batch. If the batch added a holder between two
+	     * devices that already have a holder of the same type all
+	     * modifications done during the batch are undone.
+	     *
+	     * @throw HolderAlreadyExists
+	     */
+	    void commit();
+
+	private:
+
+	    Devicegraph* devicegraph;
+
+	    unsigned int checkpoint;
+
+	};
+
+	/**
+	 * Starts a batch of modifications that ends when the returned
+	 * object is committed or destroyed. The batch uses a checkpoint to
+	 * undo its modifications if it is not committed, see
+	 * checkpoint(). Devices and holders added during the batch are
+	 * not recorded individually for that, they are simply removed
+	 * again. During the batch adding devices and holders does not
+	 * update the lookup indices of the devicegraph and adding a holder
+	 * does not check for an existing holder of the same type. The
+	 * added devices and holders are indexed on the next lookup or
+	 * when the batch ends, the holders are checked in one pass over
+	 * the devicegraph when the batch ends.
+	 *
+	 * Useful for bulk modifications, e.g. creating many
+	 * partitions. Lookups during the batch give correct results and
+	 * only index what was added since the previous lookup.
+	 */
+	Batch batch();
+
 	/**
 	 * Checks the devicegraph.
 	 *
@@ -379,6 +494,17 @@ namespace storage
 	 */
 	void check(const CheckCallbacks* check_callbacks = nullptr) const;
 
+	/**
+	 * Cheap variant of check(). Only the devices added, modified or
+	 * with added, removed or modified holders since the last successful
+	 * check are checked, together with their parents and children. If
+	 * the devicegraph was not checked before, or was loaded or copied
+	 * since then, this is the same as check().
+	 *
+	 * @throw Exception
+	 */
+	void check_incremental(const CheckCallbacks* check_callbacks = nullptr) const;
+
 	uint64_t used_features() const ST_DEPRECATED;
 
 	/**
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include "storage/DevicegraphDiffImpl.h"
+
+
+namespace storage
+{
+
+    using namespace std;
+
+
+    DevicegraphDiff::DevicegraphDiff(const Devicegraph* lhs, const Devicegraph* rhs)
+	: impl(make_unique<Impl>(lhs, rhs))
+    {
+    }
+
+
+    DevicegraphDiff::~DevicegraphDiff()
+    {
+    }
+
+
+    bool
+    DevicegraphDiff::empty() const
+    {
+	return get_impl().empty();
+    }
+
+
+    vector<const Device*>
+    DevicegraphDiff::get_created_devices() const
+    {
+	return get_impl().get_created_devices();
+    }
+
+
+    vector<const Device*>
+    DevicegraphDiff::get_modified_devices() const
+    {
+	return get_impl().get_modified_devices();
+    }
+
+
+    vector<const Device*>
+    DevicegraphDiff::get_deleted_devices() const
+    {
+	return get_impl().get_deleted_devices();
+    }
+
+
+    vector<const Holder*>
+    DevicegraphDiff::get_created_holders() const
+    {
+	return get_impl().get_created_holders();
+    }
+
+
+    vector<const Holder*>
+    DevicegraphDiff::get_modified_holders() const
+    {
+	return get_impl().get_modified_holders();
+    }
+
+
+    vector<const Holder*>
+    DevicegraphDiff::get_deleted_holders() const
+    {
+	return get_impl().get_deleted_holders();
+    }
+
+}
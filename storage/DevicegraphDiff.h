@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_DEVICEGRAPH_DIFF_H
+#define STORAGE_DEVICEGRAPH_DIFF_H
+
+
+#include <memory>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+
+namespace storage
+{
+
+    class Devicegraph;
+    class Device;
+    class Holder;
+
+
+    /**
+     * The differences between two devicegraphs. Devices are matched by
+     * their sid and holders by the sids of their source and target. This
+     * allows to find out what changed between two devicegraphs without
+     * calculating an actiongraph.
+     *
+     * The devicegraphs must not be modified while the object exists.
+     */
+    class DevicegraphDiff : private boost::noncopyable
+    {
+    public:
+
+	/**
+	 * Compute the differences to get from the LHS (left-hand side) to the
+	 * RHS (right-hand side) devicegraph.
+	 */
+	DevicegraphDiff(const Devicegraph* lhs, const Devicegraph* rhs);
+
+	~DevicegraphDiff();
+
+	/**
+	 * Check whether both devicegraphs have the same devices and holders
+	 * and none of them is modified.
+	 */
+	bool empty() const;
+
+	/**
+	 * Devices only in the RHS devicegraph. Sorted by sid.
+	 */
+	std::vector<const Device*> get_created_devices() const;
+
+	/**
+	 * Devices in both devicegraphs that differ. The devices are from the
+	 * RHS devicegraph. Sorted by sid.
+	 */
+	std::vector<const Device*> get_modified_devices() const;
+
+	/**
+	 * Devices only in the LHS devicegraph. Sorted by sid.
+	 */
+	std::vector<const Device*> get_deleted_devices() const;
+
+	/**
+	 * Holders only in the RHS devicegraph. Sorted by source and target
+	 * sid.
+	 */
+	std::vector<const Holder*> get_created_holders() const;
+
+	/**
+	 * Holders in both devicegraphs that differ. The holders are from the
+	 * RHS devicegraph. Sorted by source and target sid.
+	 */
+	std::vector<const Holder*> get_modified_holders() const;
+
+	/**
+	 * Holders only in the LHS devicegraph. Sorted by source and target
+	 * sid.
+	 */
+	std::vector<const Holder*> get_deleted_holders() const;
+
+    public:
+
+	class Impl;
+
+	Impl& get_impl() { return *impl; }
+	const Impl& get_impl() const { return *impl; }
+
+    private:
+
+	const std::unique_ptr<Impl> impl;
+
+    };
+
+}
+
+
+#endif
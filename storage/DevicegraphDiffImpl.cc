@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2026 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include <algorithm>
+
+#include "storage/DevicegraphDiffImpl.h"
+#include "storage/Devices/DeviceImpl.h"
+#include "storage/Holders/HolderImpl.h"
+
+
+namespace storage
+{
+
+    using namespace std;
+
+
+    namespace
+    {
+
+	template <typename Key, typename Descriptor>
+	void
+	sort_by_key(vector<pair<Key, Descriptor>>& entries)
+	{
+	    stable_sort(entries.begin(), entries.end(), [](const pair<Key, Descriptor>& lhs,
+							    const pair<Key, Descriptor>& rhs) {
+		return lhs.first < rhs.first;
+	    });
+	}
+
+
+	/**
+	 * Joins the entries of the LHS and RHS that are sorted by key. Entries
+	 * with the same key are paired in their order. Surplus entries of a key
+	 * that is in both are dropped.
+	 */
+	template <typename Key, typename Descriptor>
+	void
+	join(const vector<pair<Key, Descriptor>>& lhs, const vector<pair<Key, Descriptor>>& rhs,
+	     vector<Descriptor>& created, vector<pair<Descriptor, Descriptor>>& common,
+	     vector<Descriptor>& deleted)
+	{
+	    typename vector<pair<Key, Descriptor>>::const_iterator it1 = lhs.begin();
+	    typename vector<pair<Key, Descriptor>>::const_iterator it2 = rhs.begin();
+
+	    while (it1 != lhs.end() || it2 != rhs.end())
+	    {
+		if (it2 == rhs.end() || (it1 != lhs.end() && it1->first < it2->first))
+		{
+		    deleted.push_back(it1->second);
+		    ++it1;
+		}
+		else if (it1 == lhs.end() || it2->first < it1->first)
+		{
+		    created.push_back(it2->second);
+		    ++it2;
+		}
+		else
+		{
+		    const Key key = it1->first;
+
+		    for (; it1 != lhs.end() && it1->first == key && it2 != rhs.end() && it2->first == key;
+			 ++it1, ++it2)
+			common.emplace_back(it1->second, it2->second);
+
+		    for (; it1 != lhs.end() && it1->first == key; ++it1)
+			;
+
+		    for (; it2 != rhs.end() && it2->first == key; ++it2)
+			;
+		}
+	    }
+	}
+
+
+	vector<pair<sid_t, Devicegraph::Impl::vertex_descriptor>>
+	sorted_vertices(const Devicegraph::Impl& devicegraph)
+	{
+	    vector<pair<sid_t, Devicegraph::Impl::vertex_descriptor>> ret;
+	    ret.reserve(devicegraph.num_devices());
+
+	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph.vertices())
+		ret.emplace_back(devicegraph[vertex]->get_sid(), vertex);
+
+	    sort_by_key(ret);
+
+	    return ret;
+	}
+
+
+	vector<pair<sid_pair_t, Devicegraph::Impl::edge_descriptor>>
+	sorted_edges(const Devicegraph::Impl& devicegraph)
+	{
+	    vector<pair<sid_pair_t, Devicegraph::Impl::edge_descriptor>> ret;
+	    ret.reserve(devicegraph.num_holders());
+
+	    for (Devicegraph::Impl::edge_descriptor edge : devicegraph.edges())
+	    {
+		const Holder* holder = devicegraph[edge];
+		ret.emplace_back(make_pair(holder->get_source_sid(), holder->get_target_sid()), edge);
+	    }
+
+	    sort_by_key(ret);
+
+	    return ret;
+	}
+
+    }
+
+
+    DevicegraphDiff::Impl::Impl(const Devicegraph* lhs, const Devicegraph* rhs)
+	: lhs(lhs), rhs(rhs)
+    {
+	ST_CHECK_PTR(lhs);
+	ST_CHECK_PTR(rhs);
+
+	join(sorted_vertices(lhs->get_impl()), sorted_vertices(rhs->get_impl()),
+	     created_vertices, common_vertices, deleted_vertices);
+
+	join(sorted_edges(lhs->get_impl()), sorted_edges(rhs->get_impl()),
+	     created_edges, common_edges, deleted_edges);
+    }
+
+
+    bool
+    DevicegraphDiff::Impl::empty() const
+    {
+	if (!created_vertices.empty() || !deleted_vertices.empty() ||
+	    !created_edges.empty() || !deleted_edges.empty())
+	    return false;
+
+	return get_modified_devices().empty() && get_modified_holders().empty();
+    }
+
+
+    vector<const Device*>
+    DevicegraphDiff::Impl::get_created_devices() const
+    {
+	vector<const Device*> ret;
+	ret.reserve(created_vertices.size());
+
+	for (vertex_descriptor vertex : created_vertices)
+	    ret.push_back(rhs->get_impl()[vertex]);
+
+	return ret;
+    }
+
+
+    vector<const Device*>
+    DevicegraphDiff::Impl::get_modified_devices() const
+    {
+	vector<const Device*> ret;
+
+	for (const pair<vertex_descriptor, vertex_descriptor>& vertices : common_vertices)
+	{
+	    const Device* device_lhs = lhs->get_impl()[vertices.first];
+	    const Device* device_rhs = rhs->get_impl()[vertices.second];
+
+	    if (device_lhs->get_impl() != device_rhs->get_impl())
+		ret.push_back(device_rhs);
+	}
+
+	return ret;
+    }
+
+
+    vector<const Device*>
+    DevicegraphDiff::Impl::get_deleted_devices() const
+    {
+	vector<const Device*> ret;
+	ret.reserve(deleted_vertices.size());
+
+	for (vertex_descriptor vertex : deleted_vertices)
+	    ret.push_back(lhs->get_impl()[vertex]);
+
+	return ret;
+    }
+
+
+    vector<const Holder*>
+    DevicegraphDiff::Impl::get_created_holders() const
+    {
+	vector<const Holder*> ret;
+	ret.reserve(created_edges.size());
+
+	for (edge_descriptor edge : created_edges)
+	    ret.push_back(rhs->get_impl()[edge]);
+
+	return ret;
+    }
+
+
+    vector<const Holder*>
+    DevicegraphDiff::Impl::get_modified_holders() const
+    {
+	vector<const Holder*> ret;
+
+	for (const pair<edge_descriptor, edge_descriptor>& edges : common_edges)
+	{
+	    const Holder* holder_lhs = lhs->get_impl()[edges.first];
+	    const Holder* holder_rhs = rhs->get_impl()[edges.second];
+
+	    if (holder_lhs->get_impl() != holder_rhs->get_impl())
+		ret.push_back(holder_rhs);
+	}
+
+	return ret;
+    }
+
+
+    vector<const Holder*>
+    DevicegraphDiff::Impl::get_deleted_holders() const
+    {
+	vector<const Holder*> ret;
+	ret.reserve(deleted_edges.size());
+
+	for (edge_descriptor edge : deleted_edges)
+	    ret.push_back(lhs->get_impl()[edge]);
+
+	return ret;
+    }
+
+}
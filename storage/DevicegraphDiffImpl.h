@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_DEVICEGRAPH_DIFF_IMPL_H
+#define STORAGE_DEVICEGRAPH_DIFF_IMPL_H
+
+
+#include "storage/DevicegraphDiff.h"
+#include "storage/DevicegraphImpl.h"
+
+
+namespace storage
+{
+
+    using std::vector;
+    using std::pair;
+
+
+    /**
+     * The devices and holders of both devicegraphs are collected in one
+     * walk over each devicegraph, sorted by sid and then joined. So the
+     * vertices and edges are available as pairs without looking them up
+     * again.
+     */
+    class DevicegraphDiff::Impl
+    {
+    public:
+
+	typedef Devicegraph::Impl::vertex_descriptor vertex_descriptor;
+	typedef Devicegraph::Impl::edge_descriptor edge_descriptor;
+
+	Impl(const Devicegraph* lhs, const Devicegraph* rhs);
+
+	const Devicegraph* get_lhs() const { return lhs; }
+	const Devicegraph* get_rhs() const { return rhs; }
+
+	/**
+	 * Vertices in the RHS of devices only in the RHS.
+	 */
+	const vector<vertex_descriptor>& get_created_vertices() const { return created_vertices; }
+
+	/**
+	 * Pairs of vertices in the LHS and RHS of devices in both
+	 * devicegraphs, modified or not.
+	 */
+	const vector<pair<vertex_descriptor, vertex_descriptor>>& get_common_vertices() const
+	    { return common_vertices; }
+
+	/**
+	 * Vertices in the LHS of devices only in the LHS.
+	 */
+	const vector<vertex_descriptor>& get_deleted_vertices() const { return deleted_vertices; }
+
+	/**
+	 * Edges in the RHS of holders with source and target sid only in the
+	 * RHS.
+	 */
+	const vector<edge_descriptor>& get_created_edges() const { return created_edges; }
+
+	/**
+	 * Pairs of edges in the LHS and RHS of holders in both devicegraphs,
+	 * modified or not. If there are several holders between the same
+	 * devices they are paired in the order of the devicegraphs.
+	 */
+	const vector<pair<edge_descriptor, edge_descriptor>>& get_common_edges() const
+	    { return common_edges; }
+
+	/**
+	 * Edges in the LHS of holders with source and target sid only in the
+	 * LHS.
+	 */
+	const vector<edge_descriptor>& get_deleted_edges() const { return deleted_edges; }
+
+	bool empty() const;
+
+	vector<const Device*> get_created_devices() const;
+	vector<const Device*> get_modified_devices() const;
+	vector<const Device*> get_deleted_devices() const;
+
+	vector<const Holder*> get_created_holders() const;
+	vector<const Holder*> get_modified_holders() const;
+	vector<const Holder*> get_deleted_holders() const;
+
+    private:
+
+	const Devicegraph* lhs;
+	const Devicegraph* rhs;
+
+	vector<vertex_descriptor> created_vertices;
+	vector<pair<vertex_descriptor, vertex_descriptor>> common_vertices;
+	vector<vertex_descriptor> deleted_vertices;
+
+	vector<edge_descriptor> created_edges;
+	vector<pair<edge_descriptor, edge_descriptor>> common_edges;
+	vector<edge_descriptor> deleted_edges;
+
+    };
+
+}
+
+
+#endif
@@ -22,18 +22,22 @@
 
 
 #include <boost/graph/copy.hpp>
+#include <boost/graph/filtered_graph.hpp>
 #include <boost/graph/reverse_graph.hpp>
 #include <boost/graph/graphviz.hpp>
 #include <boost/graph/graph_utility.hpp>
+#include <boost/property_map/function_property_map.hpp>
 
 #include "storage/DevicegraphImpl.h"
 #include "storage/Utils/GraphUtils.h"
+#include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/XmlFile.h"
 #include "storage/Devices/DeviceImpl.h"
-#include "storage/Devices/Disk.h"
-#include "storage/Filesystems/Nfs.h"
-#include "storage/Filesystems/Tmpfs.h"
-#include "storage/Filesystems/MountPoint.h"
+#include "storage/Devices/BlkDeviceImpl.h"
+#include "storage/Devices/DiskImpl.h"
+#include "storage/Filesystems/NfsImpl.h"
+#include "storage/Filesystems/TmpfsImpl.h"
+#include "storage/Filesystems/MountPointImpl.h"
 #include "storage/Holders/Holder.h"
 #include "storage/StorageImpl.h"
 #include "storage/Utils/Format.h"
@@ -44,38 +48,176 @@
 namespace storage
 {
 
+    namespace
+    {
+
+	typedef Devicegraph::Impl::graph_t graph_t;
+	typedef Devicegraph::Impl::vertex_descriptor vertex_descriptor;
+	typedef Devicegraph::Impl::edge_descriptor edge_descriptor;
+
+
+	/**
+	 * Predicates with the view as compile-time policy for
+	 * boost::filtered_graph. Unlike a std::function the predicates can
+	 * be inlined into the traversal loops.
+	 */
+	template <View view>
+	class VertexInView
+	{
+	public:
+
+	    VertexInView() = default;
+	    VertexInView(const graph_t* graph) : graph(graph) {}
+
+	    bool operator()(vertex_descriptor vertex) const
+	    {
+		return (*graph)[vertex]->get_impl().is_in_view(view);
+	    }
+
+	private:
+
+	    const graph_t* graph = nullptr;
+
+	};
+
+
+	template <View view>
+	class EdgeInView
+	{
+	public:
+
+	    EdgeInView() = default;
+	    EdgeInView(const graph_t* graph) : graph(graph) {}
+
+	    bool operator()(edge_descriptor edge) const
+	    {
+		return (*graph)[edge]->get_impl().is_in_view(view);
+	    }
+
+	private:
+
+	    const graph_t* graph = nullptr;
+
+	};
+
+
+	template <View view>
+	using view_graph_t = boost::filtered_graph<graph_t, EdgeInView<view>, VertexInView<view>>;
+
+
+	template <View view>
+	view_graph_t<view>
+	make_view_graph(const graph_t& graph)
+	{
+	    return view_graph_t<view>(graph, EdgeInView<view>(&graph), VertexInView<view>(&graph));
+	}
+
+
+	/**
+	 * Call func with the graph as seen in the view. For View::ALL all
+	 * devices and holders are visible so func gets the unfiltered graph.
+	 */
+	template <typename Func>
+	auto
+	with_view_graph(const graph_t& graph, View view, Func func)
+	{
+	    switch (view)
+	    {
+		case View::ALL:
+		    return func(graph);
+
+		case View::CLASSIC:
+		    return func(make_view_graph<View::CLASSIC>(graph));
+
+		case View::REMOVE:
+		    return func(make_view_graph<View::REMOVE>(graph));
+	    }
+
+	    ST_THROW(LogicException("invalid value for view"));
+	}
+
+
+	/**
+	 * Breadth first search from vertex returning the discovered vertices
+	 * or only the discovered leaves.
+	 */
+	template <typename Graph>
+	vector<vertex_descriptor>
+	discover_vertices(const Graph& graph, vertex_descriptor vertex, bool only_leaves, bool itself)
+	{
+	    vector<vertex_descriptor> ret;
+	    VertexRecorder<vertex_descriptor> vertex_recorder(only_leaves, ret);
+
+	    boost::breadth_first_search(graph, vertex, visitor(vertex_recorder));
+
+	    if (!itself)
+		ret.erase(remove(ret.begin(), ret.end(), vertex), ret.end());
+
+	    return ret;
+	}
+
+
+	/**
+	 * Finalizer of splitmix64. Spreads the bits of a hash so that sums
+	 * of mixed hashes rarely collide.
+	 */
+	size_t
+	mix_hash(size_t hash)
+	{
+	    unsigned long long x = hash;
+
+	    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+
+	    return x ^ (x >> 31);
+	}
+
+    }
+
+
     bool
     Devicegraph::Impl::operator==(const Impl& rhs) const
     {
-	const set<sid_t> lhs_device_sids = get_device_sids();
-	const set<sid_t> rhs_device_sids = rhs.get_device_sids();
+	if (this == &rhs)
+	    return true;
 
-	if (lhs_device_sids != rhs_device_sids)
-	    return false;
+	update_indices();
+	rhs.update_indices();
 
-	const set<sid_pair_t> lhs_holder_sids = get_holder_sid_pairs();
-	const set<sid_pair_t> rhs_holder_sids = rhs.get_holder_sid_pairs();
+	// The sizes and the hashes reject most unequal devicegraphs
+	// quickly. The content hashes are only recalculated for modified
+	// devices and holders.
 
-	if (lhs_holder_sids != rhs_holder_sids)
+	if (num_devices() != rhs.num_devices() || num_holders() != rhs.num_holders() ||
+	    structure_hash != rhs.structure_hash || get_content_hash() != rhs.get_content_hash())
 	    return false;
 
-	for (sid_t sid : lhs_device_sids)
+	// Equal hashes do not prove equality so compare every device and
+	// the holders leaving it. Since the number of holders is equal this
+	// also compares all holders.
+
+	for (vertex_descriptor lhs_vertex : vertices())
 	{
-	    vertex_descriptor lhs_vertex = find_vertex(sid);
-	    vertex_descriptor rhs_vertex = rhs.find_vertex(sid);
+	    const Device* lhs_device = graph[lhs_vertex].get();
 
-	    if (*graph[lhs_vertex].get() != *rhs.graph[rhs_vertex].get())
+	    std::unordered_map<sid_t, vertex_descriptor>::const_iterator it =
+		rhs.sid_index.find(lhs_device->get_sid());
+	    if (it == rhs.sid_index.end())
 		return false;
-	}
 
-	for (sid_pair_t sid_pair : lhs_holder_sids)
-	{
-	    vector<edge_descriptor> lhs_edges = find_edges(sid_pair);
-	    vector<edge_descriptor> rhs_edges = rhs.find_edges(sid_pair);
+	    vertex_descriptor rhs_vertex = it->second;
+
+	    if (*lhs_device != *rhs.graph[rhs_vertex].get())
+		return false;
+
+	    graph_t::out_edge_iterator lhs_first, lhs_last, rhs_first, rhs_last;
+	    boost::tie(lhs_first, lhs_last) = boost::out_edges(lhs_vertex, graph);
+	    boost::tie(rhs_first, rhs_last) = boost::out_edges(rhs_vertex, rhs.graph);
 
-	    if (!is_permutation(lhs_edges.begin(), lhs_edges.end(), rhs_edges.begin(), rhs_edges.end(),
+	    if (!is_permutation(lhs_first, lhs_last, rhs_first, rhs_last,
 				[&](edge_descriptor lhs_edge, edge_descriptor rhs_edge) {
-				    return *graph[lhs_edge].get() == *rhs.graph[rhs_edge].get();
+				    return graph[target(lhs_edge)]->get_sid() == rhs.graph[rhs.target(rhs_edge)]->get_sid() &&
+					*graph[lhs_edge].get() == *rhs.graph[rhs_edge].get();
 				}))
 		return false;
 	}
@@ -84,96 +226,155 @@ namespace storage
     }
 
 
+    size_t
+    Devicegraph::Impl::get_content_hash() const
+    {
+	if (content_hash_stale || content_hash_generation != generation)
+	{
+	    content_hash_stale = false;
+	    content_hash_generation = generation;
+
+	    // A sum so that the order of the devices and holders does not
+	    // matter. The hashes are mixed before adding them since simple
+	    // differences, e.g. in a size, would otherwise cancel out easily.
+
+	    size_t sum = 0;
+
+	    for (vertex_descriptor vertex : vertices())
+		sum += mix_hash(graph[vertex]->get_impl().get_content_hash());
+
+	    for (edge_descriptor edge : edges())
+	    {
+		size_t seed = graph[edge]->get_impl().get_content_hash();
+		boost::hash_combine(seed, graph[source(edge)]->get_sid());
+		boost::hash_combine(seed, graph[target(edge)]->get_sid());
+
+		sum += mix_hash(seed);
+	    }
+
+	    content_hash = sum;
+	}
+
+	return content_hash;
+    }
+
+
     void
     Devicegraph::Impl::log_diff(std::ostream& log, const Impl& rhs) const
     {
-	// TODO
+	// Only descend into devices and holders that differ.
 
-	const set<sid_t> lhs_device_sids = get_device_sids();
-	const set<sid_t> rhs_device_sids = rhs.get_device_sids();
+	bool device_sids_differ = num_devices() != rhs.num_devices();
 
-	if (lhs_device_sids != rhs_device_sids)
-	    log << "device sids differ\n";
-
-	for (sid_t sid : lhs_device_sids)
+	for (vertex_descriptor lhs_vertex : vertices())
 	{
-	    vertex_descriptor lhs_vertex = find_vertex(sid);
-	    vertex_descriptor rhs_vertex = rhs.find_vertex(sid);
+	    const Device* lhs_device = graph[lhs_vertex].get();
+	    sid_t sid = lhs_device->get_sid();
+
+	    std::unordered_map<sid_t, vertex_descriptor>::const_iterator it = rhs.sid_index.find(sid);
+	    if (it == rhs.sid_index.end())
+	    {
+		device_sids_differ = true;
+		continue;
+	    }
+
+	    const Device* rhs_device = rhs.graph[it->second].get();
 
-	    if (*graph[lhs_vertex].get() != *rhs.graph[rhs_vertex].get())
-		log << "sid " << sid << " device differ\n";
+	    if (*lhs_device == *rhs_device)
+		continue;
 
-	    if (graph[lhs_vertex]->get_impl().get_classname() != graph[rhs_vertex]->get_impl().get_classname())
+	    log << "sid " << sid << " device differ\n";
+
+	    if (lhs_device->get_impl().get_classname() != rhs_device->get_impl().get_classname())
 		log << "devices with sid " << sid << " have different types\n";
 	    else
-		graph[lhs_vertex]->get_impl().log_diff(log, rhs.graph[rhs_vertex]->get_impl());
+		lhs_device->get_impl().log_diff(log, rhs_device->get_impl());
 	}
 
-	const set<sid_pair_t> lhs_holder_sids = get_holder_sid_pairs();
-	const set<sid_pair_t> rhs_holder_sids = rhs.get_holder_sid_pairs();
+	if (device_sids_differ)
+	    log << "device sids differ\n";
+
+	// Holders between the same devices are handled together when
+	// visiting the first of them.
 
-	if (lhs_holder_sids != rhs_holder_sids)
-	    log << "holder sid pairs differ\n";
+	bool holder_sid_pairs_differ = num_holders() != rhs.num_holders();
 
-	for (sid_pair_t sid_pair : lhs_holder_sids)
+	for (edge_descriptor lhs_edge : edges())
 	{
+	    sid_pair_t sid_pair(graph[source(lhs_edge)]->get_sid(), graph[target(lhs_edge)]->get_sid());
+
 	    vector<edge_descriptor> lhs_edges = find_edges(sid_pair);
+	    if (lhs_edges.front() != lhs_edge)
+		continue;
+
 	    vector<edge_descriptor> rhs_edges = rhs.find_edges(sid_pair);
+	    if (rhs_edges.empty())
+	    {
+		holder_sid_pairs_differ = true;
+		continue;
+	    }
 
-	    bool show = false;
+	    if (is_permutation(lhs_edges.begin(), lhs_edges.end(), rhs_edges.begin(), rhs_edges.end(),
+			       [&](edge_descriptor lhs_edge, edge_descriptor rhs_edge) {
+				   return *graph[lhs_edge].get() == *rhs.graph[rhs_edge].get();
+			       }))
+		continue;
 
 	    if (lhs_edges.size() != rhs_edges.size())
-	    {
 		log << "sid " << sid_pair.first << " " << sid_pair.second << " different number of holders\n";
-		show = true;
-	    }
-	    else if (!is_permutation(lhs_edges.begin(), lhs_edges.end(), rhs_edges.begin(), rhs_edges.end(),
-				     [&](edge_descriptor lhs_edge, edge_descriptor rhs_edge) {
-					 return *graph[lhs_edge].get() == *rhs.graph[rhs_edge].get();
-				     }))
-	    {
+	    else
 		log << "sid " << sid_pair.first << " " << sid_pair.second << " holders are not a permutation\n";
-		show = true;
-	    }
 
-	    if (show)
-	    {
-		// TODO: It might be worth sorting the holders according to type to give better
-		// diffs. But so far having more than one holder is the rare exception.
+	    // TODO: It might be worth sorting the holders according to type to give better
+	    // diffs. But so far having more than one holder is the rare exception.
 
-		size_t n = min(lhs_edges.size(), rhs_edges.size());
+	    size_t n = min(lhs_edges.size(), rhs_edges.size());
 
-		for (size_t i = 0; i < n; ++i)
-		{
-		    const Holder* lhs_holder = graph[lhs_edges[i]].get();
-		    const Holder* rhs_holder = rhs.graph[rhs_edges[i]].get();
-
-		    if (*lhs_holder != *rhs_holder)
-			log << "sid " << sid_pair.first << " " << sid_pair.second << " holder pair "
-			    << i << " differ\n";
-
-		    if (lhs_holder->get_impl().get_classname() != rhs_holder->get_impl().get_classname())
-			log << "sid " << sid_pair.first << " " << sid_pair.second << " holder pair "
-			    << i << " have different types\n";
-		    else
-			lhs_holder->get_impl().log_diff(log, rhs_holder->get_impl());
-		}
+	    for (size_t i = 0; i < n; ++i)
+	    {
+		const Holder* lhs_holder = graph[lhs_edges[i]].get();
+		const Holder* rhs_holder = rhs.graph[rhs_edges[i]].get();
+
+		if (*lhs_holder != *rhs_holder)
+		    log << "sid " << sid_pair.first << " " << sid_pair.second << " holder pair "
+			<< i << " differ\n";
+
+		if (lhs_holder->get_impl().get_classname() != rhs_holder->get_impl().get_classname())
+		    log << "sid " << sid_pair.first << " " << sid_pair.second << " holder pair "
+			<< i << " have different types\n";
+		else
+		    lhs_holder->get_impl().log_diff(log, rhs_holder->get_impl());
 	    }
 	}
+
+	if (holder_sid_pairs_differ)
+	    log << "holder sid pairs differ\n";
     }
 
 
     void
     Devicegraph::Impl::check(const CheckCallbacks* check_callbacks) const
     {
+	update_indices();
+
 	{
 	    // check uniqueness of device and holder object and sid
 
 	    // check device and holder back reference
 
-	    set<const Device*> devices;
-	    set<const Holder*> holders;
-	    set<sid_t> sids;
+	    std::unordered_set<const Device*> devices;
+	    devices.reserve(num_devices());
+
+	    std::unordered_set<const Holder*> holders;
+	    holders.reserve(num_holders());
+
+	    std::unordered_set<sid_t> sids;
+	    sids.reserve(num_devices());
+
+	    size_t last_sequence = 0;
+	    size_t num_type_bucket_entries = 0;
+
+	    size_t expected_structure_hash = 0;
 
 	    for (vertex_descriptor vertex : vertices())
 	    {
@@ -189,15 +390,33 @@ namespace storage
 		if (!sids.insert(sid).second)
 		    ST_THROW(LogicException(sformat("sid %d not unique within graph", sid)));
 
-		// check device back reference
+		num_type_bucket_entries += check_vertex(vertex);
+
+		// check type buckets, the sequence numbers must follow the order
+		// of the vertices
+
+		size_t sequence = vertex_sequences.find(vertex)->second;
+		if (devices.size() > 1 && sequence <= last_sequence)
+		    ST_THROW(LogicException(sformat("sid %d wrong in vertex sequences", sid)));
 
-		if (&device->get_impl().get_devicegraph()->get_impl() != this)
-		    ST_THROW(LogicException("wrong graph in back references"));
+		last_sequence = sequence;
 
-		if (device->get_impl().get_vertex() != vertex)
-		    ST_THROW(LogicException("wrong vertex in back references"));
+		expected_structure_hash += vertex_hash(vertex);
 	    }
 
+	    if (sid_index.size() != sids.size())
+		ST_THROW(LogicException("sid index has wrong size"));
+
+	    size_t type_buckets_size = 0;
+	    for (const type_bucket_t& type_bucket : type_buckets)
+		type_buckets_size += type_bucket.size();
+
+	    if (vertices_by_index.size() != devices.size())
+		ST_THROW(LogicException("vertex index has wrong size"));
+
+	    if (vertex_sequences.size() != devices.size() || type_buckets_size != num_type_bucket_entries)
+		ST_THROW(LogicException("type buckets have wrong size"));
+
 	    for (edge_descriptor edge : edges())
 	    {
 		// check uniqueness of holder object
@@ -206,29 +425,25 @@ namespace storage
 		if (!holders.insert(holder).second)
 		    ST_THROW(LogicException("holder object not unique within graph"));
 
-		// check holder back reference
+		check_edge(edge);
 
-		if (&holder->get_impl().get_devicegraph()->get_impl() != this)
-		    ST_THROW(LogicException("wrong graph in back references"));
-
-		if (holder->get_impl().get_edge() != edge)
-		    ST_THROW(LogicException("wrong edge in back references"));
+		expected_structure_hash += edge_hash(edge);
 	    }
+
+	    if (holder_index.size() != holders.size())
+		ST_THROW(LogicException("holder index has wrong size"));
+
+	    if (structure_hash != expected_structure_hash)
+		ST_THROW(LogicException("structure hash is wrong"));
 	}
 
 	{
 	    // Look for cycles in the classic view. With btrfs snapshots cycles are possible.
 
-	    filtered_graph_t filtered_graph(graph, make_edge_filter(View::CLASSIC),
-					    make_vertex_filter(View::CLASSIC));
-
-	    VertexIndexMapGenerator<filtered_graph_t> vertex_index_map_generator(filtered_graph);
-
 	    bool has_cycle = false;
 
 	    CycleDetector cycle_detector(has_cycle);
-	    boost::depth_first_search(filtered_graph, visitor(cycle_detector).
-				      vertex_index_map(vertex_index_map_generator.get()));
+	    boost::depth_first_search(make_view_graph<View::CLASSIC>(graph), visitor(cycle_detector));
 
 	    if (has_cycle)
 		ST_THROW(Exception("devicegraph has a cycle"));
@@ -245,6 +460,228 @@ namespace storage
 	// TODO check that out-edges are consistent, e.g. of same type, only one per Subdevice
 	// TODO check that in-edges are consistent, e.g. of same type, exactly one for Partition
 	// in general subcheck for each device
+
+	checked = true;
+	changed_sids.clear();
+    }
+
+
+    void
+    Devicegraph::Impl::check_incremental(const CheckCallbacks* check_callbacks) const
+    {
+	if (!checked)
+	{
+	    check(check_callbacks);
+	    return;
+	}
+
+	update_indices();
+
+	{
+	    // The sizes of the indices are cheap to check and detect vertices
+	    // missing in an index.
+
+	    if (sid_index.size() != num_devices())
+		ST_THROW(LogicException("sid index has wrong size"));
+
+	    if (vertices_by_index.size() != num_devices())
+		ST_THROW(LogicException("vertex index has wrong size"));
+
+	    if (vertex_sequences.size() != num_devices())
+		ST_THROW(LogicException("type buckets have wrong size"));
+
+	    if (holder_index.size() != num_holders())
+		ST_THROW(LogicException("holder index has wrong size"));
+	}
+
+	vector<vertex_descriptor> changed_vertices;
+	changed_vertices.reserve(changed_sids.size());
+
+	for (sid_t sid : changed_sids)
+	{
+	    std::unordered_map<sid_t, vertex_descriptor>::const_iterator it = sid_index.find(sid);
+	    if (it != sid_index.end())
+		changed_vertices.push_back(it->second);
+	}
+
+	for (vertex_descriptor vertex : changed_vertices)
+	{
+	    check_vertex(vertex);
+
+	    for (edge_descriptor edge : boost::make_iterator_range(boost::in_edges(vertex, graph)))
+		check_edge(edge);
+
+	    for (edge_descriptor edge : boost::make_iterator_range(boost::out_edges(vertex, graph)))
+		check_edge(edge);
+	}
+
+	{
+	    // A new cycle must contain an added holder so it is reachable from
+	    // a changed vertex. A depth first search from all changed vertices
+	    // sharing the colors finds it.
+
+	    bool has_cycle = false;
+
+	    CycleDetector cycle_detector(has_cycle);
+
+	    vector<boost::default_color_type> colors(num_devices(), boost::white_color);
+	    auto color_map = boost::make_iterator_property_map(colors.begin(), boost::get(boost::vertex_index, graph));
+
+	    view_graph_t<View::CLASSIC> view_graph = make_view_graph<View::CLASSIC>(graph);
+
+	    for (vertex_descriptor vertex : changed_vertices)
+	    {
+		if (colors[boost::get(boost::vertex_index, graph, vertex)] == boost::white_color)
+		    boost::depth_first_visit(view_graph, vertex, cycle_detector, color_map);
+	    }
+
+	    if (has_cycle)
+		ST_THROW(Exception("devicegraph has a cycle"));
+	}
+
+	{
+	    // The checks of a device can depend on its parents and children,
+	    // e.g. an encryption must not be bigger than its parent, so they
+	    // are also checked.
+
+	    vector<vertex_descriptor> check_vertices;
+	    std::unordered_set<vertex_descriptor> seen;
+
+	    auto add = [&check_vertices, &seen](vertex_descriptor vertex) {
+		if (seen.insert(vertex).second)
+		    check_vertices.push_back(vertex);
+	    };
+
+	    for (vertex_descriptor vertex : changed_vertices)
+	    {
+		add(vertex);
+
+		for (vertex_descriptor parent : boost::make_iterator_range(boost::inv_adjacent_vertices(vertex, graph)))
+		    add(parent);
+
+		for (vertex_descriptor child : boost::make_iterator_range(boost::adjacent_vertices(vertex, graph)))
+		    add(child);
+	    }
+
+	    for (vertex_descriptor vertex : check_vertices)
+	    {
+		const Device* device = graph[vertex].get();
+		device->get_impl().check(check_callbacks);
+	    }
+	}
+
+	changed_sids.clear();
+    }
+
+
+    size_t
+    Devicegraph::Impl::check_vertex(vertex_descriptor vertex) const
+    {
+	const Device* device = graph[vertex].get();
+	sid_t sid = device->get_sid();
+
+	// check sid index
+
+	std::unordered_map<sid_t, vertex_descriptor>::const_iterator it = sid_index.find(sid);
+	if (it == sid_index.end() || it->second != vertex)
+	    ST_THROW(LogicException(sformat("sid %d wrong in sid index", sid)));
+
+	// check name index
+
+	const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(device);
+	if (blk_device && !contains(find_vertices_by_name(blk_device->get_name()), vertex))
+	    ST_THROW(LogicException(sformat("%s missing in name index", blk_device->get_name())));
+
+	// check uuid index
+
+	string uuid = device->get_impl().get_indexed_uuid();
+	if (!uuid.empty() && !contains(find_vertices_by_uuid(uuid), vertex))
+	    ST_THROW(LogicException(sformat("%s missing in uuid index", uuid)));
+
+	// check type buckets
+
+	std::unordered_map<vertex_descriptor, size_t>::const_iterator it2 = vertex_sequences.find(vertex);
+	if (it2 == vertex_sequences.end())
+	    ST_THROW(LogicException(sformat("sid %d wrong in vertex sequences", sid)));
+
+	size_t num_type_bucket_entries = 0;
+
+	device_types_t device_types = device->get_impl().get_device_types();
+
+	for (unsigned int i = 0; i < num_device_types; ++i)
+	{
+	    if (device_types & (device_types_t(1) << i))
+	    {
+		type_bucket_t::const_iterator it3 = type_buckets[i].find(it2->second);
+		if (it3 == type_buckets[i].end() || it3->second != vertex)
+		    ST_THROW(LogicException(sformat("sid %d missing in type bucket", sid)));
+
+		++num_type_bucket_entries;
+	    }
+	}
+
+	// check vertex index
+
+	size_t index = boost::get(boost::vertex_index, graph, vertex);
+	if (index >= vertices_by_index.size() || vertices_by_index[index] != vertex)
+	    ST_THROW(LogicException(sformat("sid %d has wrong vertex index", sid)));
+
+	// check device back reference
+
+	if (&device->get_impl().get_devicegraph()->get_impl() != this)
+	    ST_THROW(LogicException("wrong graph in back references"));
+
+	if (device->get_impl().get_vertex() != vertex)
+	    ST_THROW(LogicException("wrong vertex in back references"));
+
+	return num_type_bucket_entries;
+    }
+
+
+    void
+    Devicegraph::Impl::check_edge(edge_descriptor edge) const
+    {
+	const Holder* holder = graph[edge].get();
+
+	// check holder back reference
+
+	if (&holder->get_impl().get_devicegraph()->get_impl() != this)
+	    ST_THROW(LogicException("wrong graph in back references"));
+
+	if (holder->get_impl().get_edge() != edge)
+	    ST_THROW(LogicException("wrong edge in back references"));
+
+	// check holder index
+
+	if (!contains(find_edges(holder->get_source_sid(), holder->get_target_sid()), edge))
+	    ST_THROW(LogicException("holder missing in holder index"));
+    }
+
+
+    void
+    Devicegraph::Impl::mark_changed(vertex_descriptor vertex)
+    {
+	if (checked)
+	    changed_sids.insert(graph[vertex]->get_sid());
+    }
+
+
+    void
+    Devicegraph::Impl::mark_changed(const Device* device)
+    {
+	std::lock_guard<std::mutex> lock(undo_mutex);
+
+	changed_sids.insert(device->get_sid());
+    }
+
+
+    void
+    Devicegraph::Impl::mark_changed(const Holder* holder)
+    {
+	std::lock_guard<std::mutex> lock(undo_mutex);
+
+	changed_sids.insert(holder->get_source_sid());
+	changed_sids.insert(holder->get_target_sid());
     }
 
 
@@ -312,216 +749,1146 @@ namespace storage
     }
 
 
-    boost::iterator_range<Devicegraph::Impl::edge_iterator>
-    Devicegraph::Impl::edges() const
-    {
-	return boost::make_iterator_range(boost::edges(graph));
-    }
+    boost::iterator_range<Devicegraph::Impl::edge_iterator>
+    Devicegraph::Impl::edges() const
+    {
+	return boost::make_iterator_range(boost::edges(graph));
+    }
+
+
+    Devicegraph::Impl::vertex_descriptor
+    Devicegraph::Impl::add_vertex(Device* device)
+    {
+	return add_vertex(shared_ptr<Device>(device));
+    }
+
+
+    Devicegraph::Impl::vertex_descriptor
+    Devicegraph::Impl::add_vertex(const shared_ptr<Device>& device)
+    {
+	vertex_descriptor vertex = boost::add_vertex(graph_t::vertex_property_type(vertices_by_index.size(),
+										  device), graph);
+	vertices_by_index.push_back(vertex);
+
+	// If the sid is already in the index the devicegraph is broken. That
+	// is detected by check() so simply keep the first vertex here.
+
+	sid_index.emplace(device->get_sid(), vertex);
+
+	if (batch_depth == 0)
+	    index_additions();
+
+	if (is_recording())
+	{
+	    std::lock_guard<std::mutex> lock(undo_mutex);
+
+	    if (batch_depth > 0)
+		batch_added_devices.push_back(device->get_sid());
+	    else
+		undo_log.emplace_back(UndoEntry::Type::ADD_VERTEX, device);
+
+	    recorded_devices.insert(device.get());
+	}
+
+	mark_changed(vertex);
+
+	++generation;
+
+	return vertex;
+    }
+
+
+    Devicegraph::Impl::edge_descriptor
+    Devicegraph::Impl::add_edge(vertex_descriptor source_vertex, vertex_descriptor target_vertex,
+				Holder* holder)
+    {
+	// Check that no holder of the same type exists. During a batch the
+	// holder index is not maintained so the check is done when the batch
+	// ends.
+
+	if (batch_depth > 0)
+	{
+	    holders_unchecked = true;
+	}
+	else
+	{
+	    sid_t source_sid = graph[source_vertex]->get_sid();
+	    sid_t target_sid = graph[target_vertex]->get_sid();
+
+	    for (edge_descriptor edge : find_edges(source_sid, target_sid))
+	    {
+		if (typeid(*graph[edge].get()) == typeid(*holder))
+		    ST_THROW(HolderAlreadyExists(source_sid, target_sid));
+	    }
+	}
+
+	// TODO should also set devicegraph and edge in holder but the
+	// devicegraph is not available here
+
+	return add_edge(source_vertex, target_vertex, shared_ptr<Holder>(holder));
+    }
+
+
+    Devicegraph::Impl::edge_descriptor
+    Devicegraph::Impl::add_edge(vertex_descriptor source_vertex, vertex_descriptor target_vertex,
+				const shared_ptr<Holder>& holder)
+    {
+	pair<Devicegraph::Impl::edge_descriptor, bool> tmp =
+	    boost::add_edge(source_vertex, target_vertex, holder, graph);
+
+	// Since parallel edges are allowed tmp.second must always be true.
+
+	if (!tmp.second)
+	    ST_THROW(LogicException("boost::add_edge behaved unexpectedly"));
+
+	unindexed_edges.push_back(tmp.first);
+
+	if (batch_depth == 0)
+	    index_additions();
+
+	if (is_recording())
+	{
+	    std::lock_guard<std::mutex> lock(undo_mutex);
+
+	    if (batch_depth > 0)
+		batch_added_holders.emplace_back(holder.get(), sid_pair_t(graph[source_vertex]->get_sid(),
+									  graph[target_vertex]->get_sid()));
+	    else
+		undo_log.emplace_back(UndoEntry::Type::ADD_EDGE, holder, graph[source_vertex]->get_sid(),
+				      graph[target_vertex]->get_sid());
+
+	    recorded_holders.insert(holder.get());
+	}
+
+	mark_changed(source_vertex);
+	mark_changed(target_vertex);
+
+	++generation;
+
+	return tmp.first;
+    }
+
+
+    set<sid_t>
+    Devicegraph::Impl::get_device_sids() const
+    {
+	set<sid_t> sids;
+
+	for (vertex_descriptor vertex : vertices())
+	    sids.insert(graph[vertex]->get_sid());
+
+	return sids;
+    }
+
+
+    set<sid_pair_t>
+    Devicegraph::Impl::get_holder_sid_pairs() const
+    {
+	set<sid_pair_t> sids;
+
+	for (edge_descriptor edge : edges())
+	    sids.insert(make_pair(graph[edge]->get_source_sid(), graph[edge]->get_target_sid()));
+
+	return sids;
+    }
+
+
+    bool
+    Devicegraph::Impl::device_exists(sid_t sid) const
+    {
+	return sid_index.find(sid) != sid_index.end();
+    }
+
+
+    bool
+    Devicegraph::Impl::holder_exists(sid_t source_sid, sid_t target_sid) const
+    {
+	update_indices();
+
+	return holder_index.find(make_pair(source_sid, target_sid)) != holder_index.end();
+    }
+
+
+    Devicegraph::Impl::vertex_descriptor
+    Devicegraph::Impl::find_vertex(sid_t sid) const
+    {
+	std::unordered_map<sid_t, vertex_descriptor>::const_iterator it = sid_index.find(sid);
+	if (it == sid_index.end())
+	    ST_THROW(DeviceNotFoundBySid(sid));
+
+	return it->second;
+    }
+
+
+    namespace
+    {
+
+	void
+	erase_from_index(Devicegraph::Impl::string_index_t& index, const string& key,
+			 Devicegraph::Impl::vertex_descriptor vertex)
+	{
+	    typedef Devicegraph::Impl::string_index_t::iterator iterator;
+
+	    pair<iterator, iterator> range = index.equal_range(key);
+	    for (iterator it = range.first; it != range.second; ++it)
+	    {
+		if (it->second == vertex)
+		{
+		    index.erase(it);
+		    return;
+		}
+	    }
+	}
+
+    }
+
+
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::find_in_index(const string_index_t& index, const string& key) const
+    {
+	update_indices();
+
+	vector<vertex_descriptor> ret;
+
+	pair<string_index_t::const_iterator, string_index_t::const_iterator> range = index.equal_range(key);
+	for (string_index_t::const_iterator it = range.first; it != range.second; ++it)
+	    ret.push_back(it->second);
+
+	// In the rare case of several vertices restore the order of
+	// vertices() so that the result does not depend on the hash map.
+
+	if (ret.size() > 1)
+	{
+	    vector<vertex_descriptor> tmp;
+
+	    for (vertex_descriptor vertex : vertices())
+	    {
+		if (contains(ret, vertex))
+		    tmp.push_back(vertex);
+	    }
+
+	    ret.swap(tmp);
+	}
+
+	return ret;
+    }
+
+
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::find_vertices_by_name(const string& name) const
+    {
+	indices_lock_t lock = lock_indices();
+
+	return find_in_index(name_index, name);
+    }
+
+
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::find_vertices_by_sysfs_path(const string& sysfs_path) const
+    {
+	indices_lock_t lock = lock_indices();
+
+	return find_in_index(sysfs_path_index, sysfs_path);
+    }
+
+
+    void
+    Devicegraph::Impl::remove_from_name_index(vertex_descriptor vertex)
+    {
+	indices_lock_t lock = lock_indices();
+
+	if (!is_indexed(vertex))
+	    return;
+
+	const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(graph[vertex].get());
+	if (!blk_device)
+	    return;
+
+	const BlkDevice::Impl& impl = blk_device->get_impl();
+
+	erase_from_index(name_index, impl.get_name(), vertex);
+
+	if (!impl.get_sysfs_path().empty())
+	    erase_from_index(sysfs_path_index, impl.get_sysfs_path(), vertex);
+    }
+
+
+    void
+    Devicegraph::Impl::add_to_name_index(vertex_descriptor vertex)
+    {
+	indices_lock_t lock = lock_indices();
+
+	if (!is_indexed(vertex))
+	    return;
+
+	const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(graph[vertex].get());
+	if (!blk_device)
+	    return;
+
+	const BlkDevice::Impl& impl = blk_device->get_impl();
+
+	name_index.emplace(impl.get_name(), vertex);
+
+	if (!impl.get_sysfs_path().empty())
+	    sysfs_path_index.emplace(impl.get_sysfs_path(), vertex);
+    }
+
+
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::find_vertices_by_uuid(const string& uuid) const
+    {
+	indices_lock_t lock = lock_indices();
+
+	// Devices with an empty UUID are not in the uuid index. Finding them
+	// requires a scan.
+
+	if (uuid.empty())
+	{
+	    vector<vertex_descriptor> ret;
+
+	    for (vertex_descriptor vertex : vertices())
+	    {
+		if (graph[vertex]->get_impl().get_indexed_uuid().empty())
+		    ret.push_back(vertex);
+	    }
+
+	    return ret;
+	}
+
+	return find_in_index(uuid_index, uuid);
+    }
+
+
+    void
+    Devicegraph::Impl::remove_from_uuid_index(vertex_descriptor vertex)
+    {
+	indices_lock_t lock = lock_indices();
+
+	if (!is_indexed(vertex))
+	    return;
+
+	string uuid = graph[vertex]->get_impl().get_indexed_uuid();
+	if (!uuid.empty())
+	    erase_from_index(uuid_index, uuid, vertex);
+    }
+
+
+    void
+    Devicegraph::Impl::add_to_uuid_index(vertex_descriptor vertex)
+    {
+	indices_lock_t lock = lock_indices();
+
+	if (!is_indexed(vertex))
+	    return;
+
+	string uuid = graph[vertex]->get_impl().get_indexed_uuid();
+	if (!uuid.empty())
+	    uuid_index.emplace(uuid, vertex);
+    }
+
+
+    void
+    Devicegraph::Impl::add_to_type_buckets(vertex_descriptor vertex)
+    {
+	size_t sequence = next_sequence++;
+	vertex_sequences[vertex] = sequence;
+
+	device_types_t device_types = graph[vertex]->get_impl().get_device_types();
+
+	for (unsigned int i = 0; i < num_device_types; ++i)
+	{
+	    if (device_types & (device_types_t(1) << i))
+		type_buckets[i].emplace_hint(type_buckets[i].end(), sequence, vertex);
+	}
+    }
+
+
+    void
+    Devicegraph::Impl::remove_from_type_buckets(vertex_descriptor vertex)
+    {
+	std::unordered_map<vertex_descriptor, size_t>::iterator it = vertex_sequences.find(vertex);
+	if (it == vertex_sequences.end())
+	    return;
+
+	device_types_t device_types = graph[vertex]->get_impl().get_device_types();
+
+	for (unsigned int i = 0; i < num_device_types; ++i)
+	{
+	    if (device_types & (device_types_t(1) << i))
+		type_buckets[i].erase(it->second);
+	}
+
+	vertex_sequences.erase(it);
+    }
+
+
+    Devicegraph::Impl::edge_descriptor
+    Devicegraph::Impl::find_edge(sid_t source_sid, sid_t target_sid) const
+    {
+	vector<Devicegraph::Impl::edge_descriptor> edges = find_edges(source_sid, target_sid);
+
+	if (edges.empty())
+	    ST_THROW(HolderNotFoundBySids(source_sid, target_sid));
+
+	if (edges.size() != 1)
+	    ST_THROW(WrongNumberOfHolders(edges.size(), 1));
+
+	return edges.front();
+    }
+
+
+    vector<Devicegraph::Impl::edge_descriptor>
+    Devicegraph::Impl::find_edges(sid_t source_sid, sid_t target_sid) const
+    {
+	update_indices();
+
+	vector<Devicegraph::Impl::edge_descriptor> ret;
+
+	pair<holder_index_t::const_iterator, holder_index_t::const_iterator> range =
+	    holder_index.equal_range(make_pair(source_sid, target_sid));
+	for (holder_index_t::const_iterator it = range.first; it != range.second; ++it)
+	    ret.push_back(it->second);
+
+	// In the case of parallel edges restore the order of the out edges of
+	// the source so that the result does not depend on the hash map.
+
+	if (ret.size() > 1)
+	{
+	    vector<edge_descriptor> tmp;
+
+	    for (edge_descriptor edge : boost::make_iterator_range(boost::out_edges(source(ret.front()), graph)))
+	    {
+		if (contains(ret, edge))
+		    tmp.push_back(edge);
+	    }
+
+	    ret.swap(tmp);
+	}
+
+	return ret;
+    }
+
+
+    vector<Devicegraph::Impl::edge_descriptor>
+    Devicegraph::Impl::find_edges(sid_pair_t sid_pair) const
+    {
+	return find_edges(sid_pair.first, sid_pair.second);
+    }
+
+
+    Devicegraph::Impl::edge_descriptor
+    Devicegraph::Impl::set_source(edge_descriptor old_edge, vertex_descriptor source_vertex)
+    {
+	vertex_descriptor target_vertex = boost::target(old_edge, graph);
+
+	Holder* new_holder = graph[old_edge].get()->clone();
+
+	Devicegraph::Impl::edge_descriptor new_edge = add_edge(source_vertex, target_vertex,
+							       new_holder);
+
+	// set back-reference
+	new_holder->get_impl().set_edge(new_edge);
+
+	remove_edge(old_edge);
+
+	return new_edge;
+    }
+
+
+    void
+    Devicegraph::Impl::clear()
+    {
+	graph.clear();
+	sid_index.clear();
+	name_index.clear();
+	sysfs_path_index.clear();
+	uuid_index.clear();
+	holder_index.clear();
+
+	for (type_bucket_t& type_bucket : type_buckets)
+	    type_bucket.clear();
+	vertex_sequences.clear();
+	vertices_by_index.clear();
+
+	structure_hash = 0;
+
+	indexed_vertices = 0;
+	unindexed_edges.clear();
+	holders_unchecked = false;
+
+	invalidate_checkpoints();
+
+	checked = false;
+	changed_sids.clear();
+
+	++generation;
+    }
+
+
+    void
+    Devicegraph::Impl::remove_vertex(vertex_descriptor vertex)
+    {
+	// Removing is rare during a batch, so simply index all additions
+	// to keep the unindexed vertices at the end of vertices_by_index.
+
+	index_additions();
+
+	std::unordered_map<sid_t, vertex_descriptor>::iterator it = sid_index.find(graph[vertex]->get_sid());
+	if (it != sid_index.end() && it->second == vertex)
+	    sid_index.erase(it);
+
+	remove_from_name_index(vertex);
+	remove_from_uuid_index(vertex);
+	remove_from_type_buckets(vertex);
+
+	for (edge_descriptor edge : boost::make_iterator_range(boost::in_edges(vertex, graph)))
+	{
+	    remove_from_holder_index(edge);
+	    structure_hash -= edge_hash(edge);
+	}
+
+	for (edge_descriptor edge : boost::make_iterator_range(boost::out_edges(vertex, graph)))
+	{
+	    remove_from_holder_index(edge);
+	    structure_hash -= edge_hash(edge);
+	}
+
+	structure_hash -= vertex_hash(vertex);
+
+	size_t index = boost::get(boost::vertex_index, graph, vertex);
+	vertex_descriptor last_vertex = vertices_by_index.back();
+	boost::put(boost::vertex_index, graph, last_vertex, index);
+	vertices_by_index[index] = last_vertex;
+	vertices_by_index.pop_back();
+	--indexed_vertices;
+
+	if (is_recording())
+	{
+	    std::lock_guard<std::mutex> lock(undo_mutex);
+
+	    // The edges must be recorded before the vertex so that the vertex
+	    // is put back before them.
+
+	    for (edge_descriptor edge : boost::make_iterator_range(boost::in_edges(vertex, graph)))
+	    {
+		undo_log.emplace_back(UndoEntry::Type::REMOVE_EDGE, graph[edge], graph[source(edge)]->get_sid(),
+				      graph[target(edge)]->get_sid());
+		removed_holders.insert(graph[edge].get());
+	    }
+
+	    for (edge_descriptor edge : boost::make_iterator_range(boost::out_edges(vertex, graph)))
+	    {
+		undo_log.emplace_back(UndoEntry::Type::REMOVE_EDGE, graph[edge], graph[source(edge)]->get_sid(),
+				      graph[target(edge)]->get_sid());
+		removed_holders.insert(graph[edge].get());
+	    }
+
+	    undo_log.emplace_back(UndoEntry::Type::REMOVE_VERTEX, graph[vertex]);
+	}
+
+	if (checked)
+	{
+	    for (vertex_descriptor tmp : boost::make_iterator_range(boost::inv_adjacent_vertices(vertex, graph)))
+		mark_changed(tmp);
+
+	    for (vertex_descriptor tmp : boost::make_iterator_range(boost::adjacent_vertices(vertex, graph)))
+		mark_changed(tmp);
+
+	    changed_sids.erase(graph[vertex]->get_sid());
+	}
+
+	boost::clear_vertex(vertex, graph);
+	boost::remove_vertex(vertex, graph);
+
+	++generation;
+    }
+
+
+    void
+    Devicegraph::Impl::remove_edge(edge_descriptor edge)
+    {
+	index_additions();
+
+	remove_from_holder_index(edge);
+
+	structure_hash -= edge_hash(edge);
+
+	if (is_recording())
+	{
+	    std::lock_guard<std::mutex> lock(undo_mutex);
+
+	    undo_log.emplace_back(UndoEntry::Type::REMOVE_EDGE, graph[edge], graph[source(edge)]->get_sid(),
+				  graph[target(edge)]->get_sid());
+	    removed_holders.insert(graph[edge].get());
+	}
+
+	mark_changed(source(edge));
+	mark_changed(target(edge));
+
+	boost::remove_edge(edge, graph);
+
+	++generation;
+    }
+
+
+    void
+    Devicegraph::Impl::add_to_holder_index(edge_descriptor edge)
+    {
+	sid_pair_t sid_pair(graph[source(edge)]->get_sid(), graph[target(edge)]->get_sid());
+
+	holder_index.emplace(sid_pair, edge);
+    }
+
+
+    void
+    Devicegraph::Impl::remove_from_holder_index(edge_descriptor edge)
+    {
+	sid_pair_t sid_pair(graph[source(edge)]->get_sid(), graph[target(edge)]->get_sid());
+
+	pair<holder_index_t::iterator, holder_index_t::iterator> range = holder_index.equal_range(sid_pair);
+	for (holder_index_t::iterator it = range.first; it != range.second; ++it)
+	{
+	    if (it->second == edge)
+	    {
+		holder_index.erase(it);
+		return;
+	    }
+	}
+    }
+
+
+    size_t
+    Devicegraph::Impl::vertex_hash(vertex_descriptor vertex) const
+    {
+	const Device* device = graph[vertex].get();
+
+	size_t seed = 0;
+	boost::hash_combine(seed, device->get_sid());
+	boost::hash_combine(seed, typeid(*device).hash_code());
+
+	return seed;
+    }
+
+
+    size_t
+    Devicegraph::Impl::edge_hash(edge_descriptor edge) const
+    {
+	const Holder* holder = graph[edge].get();
+
+	size_t seed = 0;
+	boost::hash_combine(seed, graph[source(edge)]->get_sid());
+	boost::hash_combine(seed, graph[target(edge)]->get_sid());
+	boost::hash_combine(seed, typeid(*holder).hash_code());
+
+	return seed;
+    }
+
+
+    void
+    Devicegraph::Impl::swap(Devicegraph::Impl& x)
+    {
+	graph.swap(x.graph);
+	sid_index.swap(x.sid_index);
+	name_index.swap(x.name_index);
+	sysfs_path_index.swap(x.sysfs_path_index);
+	uuid_index.swap(x.uuid_index);
+	holder_index.swap(x.holder_index);
+	type_buckets.swap(x.type_buckets);
+	vertex_sequences.swap(x.vertex_sequences);
+	std::swap(next_sequence, x.next_sequence);
+	vertices_by_index.swap(x.vertices_by_index);
+	std::swap(structure_hash, x.structure_hash);
+	std::swap(checked, x.checked);
+	changed_sids.swap(x.changed_sids);
+	std::swap(indexed_vertices, x.indexed_vertices);
+	unindexed_edges.swap(x.unindexed_edges);
+	std::swap(holders_unchecked, x.holders_unchecked);
+
+	invalidate_checkpoints();
+	x.invalidate_checkpoints();
+
+	++generation;
+	++x.generation;
+    }
+
+
+    unsigned int
+    Devicegraph::Impl::checkpoint()
+    {
+	checkpoints.push_back({ next_checkpoint_id++, undo_log.size(), batch_added_devices.size(),
+		batch_added_holders.size() });
+
+	// Every device and holder must be copied again before its first
+	// modification after the new checkpoint.
+
+	recorded_devices.clear();
+	recorded_holders.clear();
+
+	return checkpoints.back().id;
+    }
+
+
+    vector<Devicegraph::Impl::Checkpoint>::iterator
+    Devicegraph::Impl::find_checkpoint(unsigned int checkpoint)
+    {
+	vector<Checkpoint>::iterator it = find_if(checkpoints.begin(), checkpoints.end(),
+						  [checkpoint](const Checkpoint& tmp) { return tmp.id == checkpoint; });
+	if (it == checkpoints.end())
+	    ST_THROW(Exception(sformat("invalid checkpoint %d", checkpoint)));
+
+	return it;
+    }
+
+
+    void
+    Devicegraph::Impl::rollback(unsigned int checkpoint)
+    {
+	const Checkpoint& tmp = *find_checkpoint(checkpoint);
+
+	size_t position = tmp.position;
+	size_t batch_added_devices_position = tmp.batch_added_devices_position;
+	size_t batch_added_holders_position = tmp.batch_added_holders_position;
+
+	rolling_back = true;
+	content_hash_stale = true;
+
+	try
+	{
+	    while (undo_log.size() > position)
+	    {
+		undo(undo_log.back());
+		undo_log.pop_back();
+	    }
+
+	    // Undoing the undo log restored every device and holder added
+	    // during a batch since the checkpoint, so simply remove them now.
+
+	    while (batch_added_holders.size() > batch_added_holders_position)
+	    {
+		remove_batch_added_holder(batch_added_holders.back());
+		batch_added_holders.pop_back();
+	    }
+
+	    while (batch_added_devices.size() > batch_added_devices_position)
+	    {
+		remove_vertex(find_vertex(batch_added_devices.back()));
+		batch_added_devices.pop_back();
+	    }
+	}
+	catch (...)
+	{
+	    rolling_back = false;
+	    invalidate_checkpoints();
+	    throw;
+	}
+
+	rolling_back = false;
+
+	release_checkpoint(checkpoint);
+    }
+
+
+    void
+    Devicegraph::Impl::release_checkpoint(unsigned int checkpoint)
+    {
+	checkpoints.erase(find_checkpoint(checkpoint), checkpoints.end());
+
+	if (checkpoints.empty())
+	    invalidate_checkpoints();
+	else
+	    update_recorded();
+    }
+
+
+    void
+    Devicegraph::Impl::record_device_change(const Device* device)
+    {
+	std::lock_guard<std::mutex> lock(undo_mutex);
+
+	if (recorded_devices.count(device) > 0)
+	    return;
+
+	// Only devices in the devicegraph are recorded, e.g. not copies of
+	// them made for other devicegraphs.
+
+	std::unordered_map<sid_t, vertex_descriptor>::const_iterator it = sid_index.find(device->get_sid());
+	if (it == sid_index.end() || graph[it->second].get() != device)
+	    return;
+
+	undo_log.emplace_back(UndoEntry::Type::CHANGE_VERTEX, graph[it->second], shared_ptr<Device>(device->clone()));
+	recorded_devices.insert(device);
+    }
+
+
+    void
+    Devicegraph::Impl::record_holder_change(const Holder* holder)
+    {
+	std::lock_guard<std::mutex> lock(undo_mutex);
+
+	if (recorded_holders.count(holder) > 0 || removed_holders.count(holder) > 0)
+	    return;
+
+	// Only holders in the devicegraph are recorded, e.g. not copies of
+	// them made for other devicegraphs.
+
+	edge_descriptor edge = holder->get_impl().get_edge();
+	if (graph[edge].get() != holder)
+	    return;
+
+	undo_log.emplace_back(UndoEntry::Type::CHANGE_EDGE, graph[edge], graph[source(edge)]->get_sid(),
+			      graph[target(edge)]->get_sid(), shared_ptr<Holder>(holder->clone()));
+	recorded_holders.insert(holder);
+    }
+
+
+    void
+    Devicegraph::Impl::undo(const UndoEntry& undo_entry)
+    {
+	switch (undo_entry.type)
+	{
+	    case UndoEntry::Type::ADD_VERTEX:
+	    {
+		remove_vertex(find_vertex(undo_entry.device->get_sid()));
+	    }
+	    break;
+
+	    case UndoEntry::Type::REMOVE_VERTEX:
+	    {
+		vertex_descriptor vertex = add_vertex(undo_entry.device);
+
+		// set back-reference
+		Device::Impl& device_impl = undo_entry.device->get_impl();
+		device_impl.set_devicegraph_and_vertex(device_impl.get_devicegraph(), vertex);
+	    }
+	    break;
+
+	    case UndoEntry::Type::CHANGE_VERTEX:
+	    {
+		vertex_descriptor vertex = find_vertex(undo_entry.device->get_sid());
+
+		// The name and the UUID might change.
+
+		remove_from_name_index(vertex);
+		remove_from_uuid_index(vertex);
 
+		undo_entry.device->swap_impl(*undo_entry.old_device);
 
-    Devicegraph::Impl::vertex_descriptor
-    Devicegraph::Impl::add_vertex(Device* device)
-    {
-	return boost::add_vertex(shared_ptr<Device>(device), graph);
-    }
+		// set back-reference
+		Device::Impl& device_impl = undo_entry.device->get_impl();
+		device_impl.set_devicegraph_and_vertex(device_impl.get_devicegraph(), vertex);
 
+		mark_changed(vertex);
 
-    Devicegraph::Impl::edge_descriptor
-    Devicegraph::Impl::add_edge(vertex_descriptor source_vertex, vertex_descriptor target_vertex,
-				Holder* holder)
-    {
-	// Check that no holder of the same type exists.
+		add_to_name_index(vertex);
+		add_to_uuid_index(vertex);
 
-	sid_t source_sid = graph[source_vertex]->get_sid();
-	sid_t target_sid = graph[target_vertex]->get_sid();
+		++generation;
+	    }
+	    break;
 
-	for (edge_descriptor edge : find_edges(source_sid, target_sid))
-	{
-	    if (typeid(*graph[edge].get()) == typeid(*holder))
-		ST_THROW(HolderAlreadyExists(graph[source_vertex]->get_sid(),
-					     graph[target_vertex]->get_sid()));
-	}
+	    case UndoEntry::Type::ADD_EDGE:
+	    {
+		for (edge_descriptor edge : find_edges(undo_entry.source_sid, undo_entry.target_sid))
+		{
+		    if (graph[edge] == undo_entry.holder)
+		    {
+			remove_edge(edge);
+			return;
+		    }
+		}
 
-	pair<Devicegraph::Impl::edge_descriptor, bool> tmp =
-	    boost::add_edge(source_vertex, target_vertex, shared_ptr<Holder>(holder), graph);
+		ST_THROW(LogicException("holder of undo log not found"));
+	    }
+	    break;
 
-	// Since parallel edges are allowed tmp.second must always be true.
+	    case UndoEntry::Type::REMOVE_EDGE:
+	    {
+		edge_descriptor edge = add_edge(find_vertex(undo_entry.source_sid),
+						find_vertex(undo_entry.target_sid), undo_entry.holder);
 
-	if (!tmp.second)
-	    ST_THROW(LogicException("boost::add_edge behaved unexpectedly"));
+		// set back-reference
+		undo_entry.holder->get_impl().set_edge(edge);
 
-	// TODO should also set devicegraph and edge in holder but the
-	// devicegraph is not available here
+		removed_holders.erase(undo_entry.holder.get());
+	    }
+	    break;
 
-	return tmp.first;
-    }
+	    case UndoEntry::Type::CHANGE_EDGE:
+	    {
+		for (edge_descriptor edge : find_edges(undo_entry.source_sid, undo_entry.target_sid))
+		{
+		    if (graph[edge] == undo_entry.holder)
+		    {
+			undo_entry.holder->swap_impl(*undo_entry.old_holder);
 
+			// set back-reference
+			undo_entry.holder->get_impl().set_edge(edge);
 
-    set<sid_t>
-    Devicegraph::Impl::get_device_sids() const
-    {
-	set<sid_t> sids;
+			mark_changed(source(edge));
+			mark_changed(target(edge));
 
-	for (vertex_descriptor vertex : vertices())
-	    sids.insert(graph[vertex]->get_sid());
+			++generation;
 
-	return sids;
+			return;
+		    }
+		}
+
+		ST_THROW(LogicException("holder of undo log not found"));
+	    }
+	    break;
+	}
     }
 
 
-    set<sid_pair_t>
-    Devicegraph::Impl::get_holder_sid_pairs() const
+    void
+    Devicegraph::Impl::remove_batch_added_holder(const pair<const Holder*, sid_pair_t>& batch_added_holder)
     {
-	set<sid_pair_t> sids;
-
-	for (edge_descriptor edge : edges())
-	    sids.insert(make_pair(graph[edge]->get_source_sid(), graph[edge]->get_target_sid()));
+	for (edge_descriptor edge : find_edges(batch_added_holder.second.first, batch_added_holder.second.second))
+	{
+	    if (graph[edge].get() == batch_added_holder.first)
+	    {
+		remove_edge(edge);
+		return;
+	    }
+	}
 
-	return sids;
+	ST_THROW(LogicException("holder added during batch not found"));
     }
 
 
-    bool
-    Devicegraph::Impl::device_exists(sid_t sid) const
+    void
+    Devicegraph::Impl::update_recorded()
     {
-	for (vertex_descriptor vertex : vertices())
+	recorded_devices.clear();
+	recorded_holders.clear();
+
+	for (size_t i = checkpoints.back().position; i < undo_log.size(); ++i)
 	{
-	    if (graph[vertex]->get_sid() == sid)
-		return true;
+	    const UndoEntry& undo_entry = undo_log[i];
+
+	    switch (undo_entry.type)
+	    {
+		case UndoEntry::Type::ADD_VERTEX:
+		case UndoEntry::Type::CHANGE_VERTEX:
+		    recorded_devices.insert(undo_entry.device.get());
+		    break;
+
+		case UndoEntry::Type::ADD_EDGE:
+		case UndoEntry::Type::CHANGE_EDGE:
+		    recorded_holders.insert(undo_entry.holder.get());
+		    break;
+
+		case UndoEntry::Type::REMOVE_VERTEX:
+		case UndoEntry::Type::REMOVE_EDGE:
+		    break;
+	    }
 	}
 
-	return false;
+	for (size_t i = checkpoints.back().batch_added_devices_position; i < batch_added_devices.size(); ++i)
+	    recorded_devices.insert(graph[find_vertex(batch_added_devices[i])].get());
+
+	for (size_t i = checkpoints.back().batch_added_holders_position; i < batch_added_holders.size(); ++i)
+	    recorded_holders.insert(batch_added_holders[i].first);
     }
 
 
-    bool
-    Devicegraph::Impl::holder_exists(sid_t source_sid, sid_t target_sid) const
+    void
+    Devicegraph::Impl::invalidate_checkpoints()
     {
-	for (edge_descriptor edge : edges())
-	{
-	    if (graph[source(edge)]->get_sid() == source_sid &&
-		graph[target(edge)]->get_sid() == target_sid)
-		return true;
-	}
+	undo_log.clear();
+	checkpoints.clear();
+
+	batch_added_devices.clear();
+	batch_added_holders.clear();
 
-	return false;
+	recorded_devices.clear();
+	recorded_holders.clear();
+	removed_holders.clear();
     }
 
 
-    Devicegraph::Impl::vertex_descriptor
-    Devicegraph::Impl::find_vertex(sid_t sid) const
+    void
+    Devicegraph::Impl::rebuild_indices()
     {
+	sid_index.clear();
+	sid_index.reserve(num_devices());
+
+	vertices_by_index.clear();
+	vertices_by_index.reserve(num_devices());
+
 	for (vertex_descriptor vertex : vertices())
 	{
-	    if (graph[vertex]->get_sid() == sid)
-		return vertex;
+	    boost::put(boost::vertex_index, graph, vertex, vertices_by_index.size());
+	    vertices_by_index.push_back(vertex);
+
+	    sid_index.emplace(graph[vertex]->get_sid(), vertex);
 	}
 
-	ST_THROW(DeviceNotFoundBySid(sid));
-    }
+	name_index.clear();
+	sysfs_path_index.clear();
+	uuid_index.clear();
 
+	for (type_bucket_t& type_bucket : type_buckets)
+	    type_bucket.clear();
+	vertex_sequences.clear();
+	vertex_sequences.reserve(num_devices());
 
-    Devicegraph::Impl::edge_descriptor
-    Devicegraph::Impl::find_edge(sid_t source_sid, sid_t target_sid) const
-    {
-	vector<Devicegraph::Impl::edge_descriptor> edges = find_edges(source_sid, target_sid);
+	holder_index.clear();
+	holder_index.reserve(num_holders());
 
-	if (edges.empty())
-	    ST_THROW(HolderNotFoundBySids(source_sid, target_sid));
+	structure_hash = 0;
 
-	if (edges.size() != 1)
-	    ST_THROW(WrongNumberOfHolders(edges.size(), 1));
+	indexed_vertices = 0;
+	unindexed_edges.assign(edges().begin(), edges().end());
 
-	return edges.front();
+	index_additions();
+
+	checked = false;
+	changed_sids.clear();
+
+	++generation;
     }
 
 
-    vector<Devicegraph::Impl::edge_descriptor>
-    Devicegraph::Impl::find_edges(sid_t source_sid, sid_t target_sid) const
+    void
+    Devicegraph::Impl::index_additions()
     {
-	vector<Devicegraph::Impl::edge_descriptor> ret;
+	// The vertices are indexed in the order they were added, so the
+	// type buckets stay in the order of vertices().
 
-	for (edge_descriptor edge : edges())
+	while (indexed_vertices < vertices_by_index.size())
+	{
+	    vertex_descriptor vertex = vertices_by_index[indexed_vertices++];
+
+	    add_to_name_index(vertex);
+	    add_to_uuid_index(vertex);
+	    add_to_type_buckets(vertex);
+
+	    structure_hash += vertex_hash(vertex);
+	}
+
+	for (edge_descriptor edge : unindexed_edges)
 	{
-	    if (graph[source(edge)]->get_sid() == source_sid &&
-		graph[target(edge)]->get_sid() == target_sid)
-		ret.push_back(edge);
+	    add_to_holder_index(edge);
+
+	    structure_hash += edge_hash(edge);
 	}
 
-	return ret;
+	unindexed_edges.clear();
     }
 
 
-    vector<Devicegraph::Impl::edge_descriptor>
-    Devicegraph::Impl::find_edges(sid_pair_t sid_pair) const
+    bool
+    Devicegraph::Impl::is_indexed(vertex_descriptor vertex) const
     {
-	return find_edges(sid_pair.first, sid_pair.second);
+	return boost::get(boost::vertex_index, graph, vertex) < indexed_vertices;
     }
 
 
-    Devicegraph::Impl::edge_descriptor
-    Devicegraph::Impl::set_source(edge_descriptor old_edge, vertex_descriptor source_vertex)
+    void
+    Devicegraph::Impl::update_indices() const
     {
-	vertex_descriptor target_vertex = boost::target(old_edge, graph);
-
-	Holder* new_holder = graph[old_edge].get()->clone();
-
-	Devicegraph::Impl::edge_descriptor new_edge = add_edge(source_vertex, target_vertex,
-							       new_holder);
-
-	// set back-reference
-	new_holder->get_impl().set_edge(new_edge);
+	// Only during a batch vertices and edges are not indexed. Indexing
+	// them does not change the graph, so the const_cast is harmless.
+	// But since this is a const function concurrent callers must not
+	// index at the same time or see the indices half updated. The index
+	// lock is taken first since indexing takes it anyway and the lookups
+	// by name and uuid call this function while holding it. Only the
+	// additions since the last lookup are indexed, so lookups during a
+	// batch stay cheap.
+
+	indices_lock_t indices_lock = lock_indices();
+	std::lock_guard<std::mutex> lock(traversal_cache_mutex);
+
+	if (indexed_vertices < vertices_by_index.size() || !unindexed_edges.empty())
+	    const_cast<Impl*>(this)->index_additions();
+    }
 
-	remove_edge(old_edge);
 
-	return new_edge;
+    void
+    Devicegraph::Impl::begin_batch()
+    {
+	++batch_depth;
     }
 
 
     void
-    Devicegraph::Impl::clear()
+    Devicegraph::Impl::end_batch()
     {
-	graph.clear();
+	if (batch_depth == 0)
+	    ST_THROW(LogicException("no batch active"));
+
+	if (--batch_depth > 0)
+	    return;
+
+	update_indices();
+
+	if (holders_unchecked)
+	{
+	    holders_unchecked = false;
+	    check_holders_unique();
+	}
     }
 
 
     void
-    Devicegraph::Impl::remove_vertex(vertex_descriptor vertex)
+    Devicegraph::Impl::check_holders_unique() const
     {
-	boost::clear_vertex(vertex, graph);
-	boost::remove_vertex(vertex, graph);
+	for (edge_descriptor edge : edges())
+	{
+	    // Handle all holders between two devices together when visiting
+	    // the first of them.
+
+	    vector<edge_descriptor> tmp = find_edges(graph[source(edge)]->get_sid(), graph[target(edge)]->get_sid());
+	    if (tmp.size() < 2 || tmp.front() != edge)
+		continue;
+
+	    for (size_t i = 0; i < tmp.size(); ++i)
+	    {
+		for (size_t j = i + 1; j < tmp.size(); ++j)
+		{
+		    if (typeid(*graph[tmp[i]].get()) == typeid(*graph[tmp[j]].get()))
+			ST_THROW(HolderAlreadyExists(graph[source(edge)]->get_sid(),
+						     graph[target(edge)]->get_sid()));
+		}
+	    }
+	}
     }
 
 
-    void
-    Devicegraph::Impl::remove_edge(edge_descriptor edge)
+    bool
+    Devicegraph::Impl::OutEdgeInView::operator()(edge_descriptor edge) const
     {
-	boost::remove_edge(edge, graph);
+	if (view == View::ALL)
+	    return true;
+
+	return (*graph)[edge]->get_impl().is_in_view(view) &&
+	    (*graph)[boost::target(edge, *graph)]->get_impl().is_in_view(view);
     }
 
 
-    void
-    Devicegraph::Impl::swap(Devicegraph::Impl& x)
+    bool
+    Devicegraph::Impl::InEdgeInView::operator()(edge_descriptor edge) const
     {
-	graph.swap(x.graph);
+	if (view == View::ALL)
+	    return true;
+
+	return (*graph)[edge]->get_impl().is_in_view(view) &&
+	    (*graph)[boost::source(edge, *graph)]->get_impl().is_in_view(view);
     }
 
 
     size_t
     Devicegraph::Impl::num_children(vertex_descriptor vertex, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
-
-	return boost::out_degree(vertex, filtered_graph);
+	return boost::size(out_edges(vertex, view));
     }
 
 
     size_t
     Devicegraph::Impl::num_parents(vertex_descriptor vertex, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
-
-	return boost::in_degree(vertex, filtered_graph);
+	return boost::size(in_edges(vertex, view));
     }
 
 
@@ -539,27 +1906,27 @@ namespace storage
     }
 
 
-    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::child_range_t
     Devicegraph::Impl::children(vertex_descriptor vertex, View view) const
     {
-	vector<vertex_descriptor> ret;
+	out_edge_range_t range = out_edges(vertex, view);
 
-	for (edge_descriptor edge : out_edges(vertex, view))
-	    ret.push_back(target(edge));
+	EdgeTarget edge_target(&graph);
 
-	return ret;
+	return child_range_t(child_iterator(range.begin(), edge_target),
+			     child_iterator(range.end(), edge_target));
     }
 
 
-    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::parent_range_t
     Devicegraph::Impl::parents(vertex_descriptor vertex, View view) const
     {
-	vector<vertex_descriptor> ret;
+	in_edge_range_t range = in_edges(vertex, view);
 
-	for (edge_descriptor edge : in_edges(vertex, view))
-	    ret.push_back(source(edge));
+	EdgeSource edge_source(&graph);
 
-	return ret;
+	return parent_range_t(parent_iterator(range.begin(), edge_source),
+			      parent_iterator(range.end(), edge_source));
     }
 
 
@@ -587,18 +1954,18 @@ namespace storage
     vector<Devicegraph::Impl::vertex_descriptor>
     Devicegraph::Impl::descendants(vertex_descriptor vertex, bool itself, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
-
-	VertexIndexMapGenerator<filtered_graph_t> vertex_index_map_generator(filtered_graph);
+	const traversal_key_t traversal_key(vertex, Traversal::DESCENDANTS, view, itself);
 
 	vector<vertex_descriptor> ret;
-	VertexRecorder<vertex_descriptor> vertex_recorder(false, ret);
 
-	boost::breadth_first_search(filtered_graph, vertex, visitor(vertex_recorder).
-				    vertex_index_map(vertex_index_map_generator.get()));
+	if (find_in_traversal_cache(traversal_key, ret))
+	    return ret;
+
+	ret = with_view_graph(graph, view, [vertex, itself](const auto& view_graph) {
+	    return discover_vertices(view_graph, vertex, false, itself);
+	});
 
-	if (!itself)
-	    ret.erase(remove(ret.begin(), ret.end(), vertex), ret.end());
+	add_to_traversal_cache(traversal_key, ret);
 
 	return ret;
     }
@@ -607,21 +1974,18 @@ namespace storage
     vector<Devicegraph::Impl::vertex_descriptor>
     Devicegraph::Impl::ancestors(vertex_descriptor vertex, bool itself, View view) const
     {
-	typedef boost::reverse_graph<filtered_graph_t> reverse_graph_t;
-
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
-	reverse_graph_t reverse_graph(filtered_graph);
-
-	VertexIndexMapGenerator<reverse_graph_t> vertex_index_map_generator(reverse_graph);
+	const traversal_key_t traversal_key(vertex, Traversal::ANCESTORS, view, itself);
 
 	vector<vertex_descriptor> ret;
-	VertexRecorder<vertex_descriptor> vertex_recorder(false, ret);
 
-	boost::breadth_first_search(reverse_graph, vertex, visitor(vertex_recorder).
-				    vertex_index_map(vertex_index_map_generator.get()));
+	if (find_in_traversal_cache(traversal_key, ret))
+	    return ret;
 
-	if (!itself)
-	    ret.erase(remove(ret.begin(), ret.end(), vertex), ret.end());
+	ret = with_view_graph(graph, view, [vertex, itself](const auto& view_graph) {
+	    return discover_vertices(boost::make_reverse_graph(view_graph), vertex, false, itself);
+	});
+
+	add_to_traversal_cache(traversal_key, ret);
 
 	return ret;
     }
@@ -630,18 +1994,18 @@ namespace storage
     vector<Devicegraph::Impl::vertex_descriptor>
     Devicegraph::Impl::leaves(vertex_descriptor vertex, bool itself, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
-
-	VertexIndexMapGenerator<filtered_graph_t> vertex_index_map_generator(filtered_graph);
+	const traversal_key_t traversal_key(vertex, Traversal::LEAVES, view, itself);
 
 	vector<vertex_descriptor> ret;
-	VertexRecorder<vertex_descriptor> vertex_recorder(true, ret);
 
-	boost::breadth_first_search(filtered_graph, vertex, visitor(vertex_recorder).
-				    vertex_index_map(vertex_index_map_generator.get()));
+	if (find_in_traversal_cache(traversal_key, ret))
+	    return ret;
 
-	if (!itself)
-	    ret.erase(remove(ret.begin(), ret.end(), vertex), ret.end());
+	ret = with_view_graph(graph, view, [vertex, itself](const auto& view_graph) {
+	    return discover_vertices(view_graph, vertex, true, itself);
+	});
+
+	add_to_traversal_cache(traversal_key, ret);
 
 	return ret;
     }
@@ -650,35 +2014,97 @@ namespace storage
     vector<Devicegraph::Impl::vertex_descriptor>
     Devicegraph::Impl::roots(vertex_descriptor vertex, bool itself, View view) const
     {
-	typedef boost::reverse_graph<filtered_graph_t> reverse_graph_t;
-
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
-	reverse_graph_t reverse_graph(filtered_graph);
-
-	VertexIndexMapGenerator<reverse_graph_t> vertex_index_map_generator(filtered_graph);
+	const traversal_key_t traversal_key(vertex, Traversal::ROOTS, view, itself);
 
 	vector<vertex_descriptor> ret;
-	VertexRecorder<vertex_descriptor> vertex_recorder(true, ret);
 
-	boost::breadth_first_search(reverse_graph, vertex, visitor(vertex_recorder).
-				    vertex_index_map(vertex_index_map_generator.get()));
+	if (find_in_traversal_cache(traversal_key, ret))
+	    return ret;
+
+	ret = with_view_graph(graph, view, [vertex, itself](const auto& view_graph) {
+	    return discover_vertices(boost::make_reverse_graph(view_graph), vertex, true, itself);
+	});
 
-	if (!itself)
-	    ret.erase(remove(ret.begin(), ret.end(), vertex), ret.end());
+	add_to_traversal_cache(traversal_key, ret);
 
 	return ret;
     }
 
 
+    size_t
+    Devicegraph::Impl::TraversalKeyHash::operator()(const traversal_key_t& traversal_key) const
+    {
+	size_t seed = 0;
+
+	boost::hash_combine(seed, std::get<0>(traversal_key));
+	boost::hash_combine(seed, (unsigned int)(std::get<1>(traversal_key)));
+	boost::hash_combine(seed, (unsigned int)(std::get<2>(traversal_key)));
+	boost::hash_combine(seed, std::get<3>(traversal_key));
+
+	return seed;
+    }
+
+
+    bool
+    Devicegraph::Impl::find_in_traversal_cache(const traversal_key_t& traversal_key,
+					       vector<vertex_descriptor>& vertices) const
+    {
+	if (std::get<2>(traversal_key) == View::REMOVE)
+	    return false;
+
+	std::lock_guard<std::mutex> lock(traversal_cache_mutex);
+
+	if (traversal_cache_generation != generation)
+	{
+	    traversal_cache.clear();
+	    traversal_cache_size = 0;
+	    traversal_cache_generation = generation;
+	    return false;
+	}
+
+	traversal_cache_t::const_iterator it = traversal_cache.find(traversal_key);
+	if (it == traversal_cache.end())
+	    return false;
+
+	vertices = it->second;
+
+	return true;
+    }
+
+
+    void
+    Devicegraph::Impl::add_to_traversal_cache(const traversal_key_t& traversal_key,
+					      const vector<vertex_descriptor>& vertices) const
+    {
+	if (std::get<2>(traversal_key) == View::REMOVE)
+	    return;
+
+	std::lock_guard<std::mutex> lock(traversal_cache_mutex);
+
+	if (traversal_cache_generation != generation)
+	    return;
+
+	// Bound the memory used by the cache. Clearing everything is simpler
+	// than tracking the least recently used entries and traversals are
+	// cheap to recalculate.
+
+	if (traversal_cache_size + vertices.size() > max_traversal_cache_size)
+	{
+	    traversal_cache.clear();
+	    traversal_cache_size = 0;
+	}
+
+	if (traversal_cache.emplace(traversal_key, vertices).second)
+	    traversal_cache_size += vertices.size();
+    }
+
+
     Devicegraph::Impl::edge_descriptor
     Devicegraph::Impl::in_edge(vertex_descriptor vertex, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
-
-	boost::iterator_range<filtered_graph_t::in_edge_iterator> range =
-	    boost::make_iterator_range(boost::in_edges(vertex, filtered_graph));
+	in_edge_range_t range = in_edges(vertex, view);
 
-	size_t size = distance(range.begin(), range.end());
+	size_t size = boost::size(range);
 	if (size != 1)
 	    ST_THROW(WrongNumberOfParents(size, 1));
 
@@ -689,12 +2115,9 @@ namespace storage
     Devicegraph::Impl::edge_descriptor
     Devicegraph::Impl::out_edge(vertex_descriptor vertex, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
+	out_edge_range_t range = out_edges(vertex, view);
 
-	boost::iterator_range<filtered_graph_t::out_edge_iterator> range =
-	    boost::make_iterator_range(boost::out_edges(vertex, filtered_graph));
-
-	size_t size = distance(range.begin(), range.end());
+	size_t size = boost::size(range);
 	if (size != 1)
 	    ST_THROW(WrongNumberOfChildren(size, 1));
 
@@ -702,27 +2125,29 @@ namespace storage
     }
 
 
-    vector<Devicegraph::Impl::edge_descriptor>
+    Devicegraph::Impl::in_edge_range_t
     Devicegraph::Impl::in_edges(vertex_descriptor vertex, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
+	in_edge_iterator first, last;
+	boost::tie(first, last) = boost::in_edges(vertex, graph);
 
-	boost::iterator_range<filtered_graph_t::in_edge_iterator> range =
-	    boost::make_iterator_range(boost::in_edges(vertex, filtered_graph));
+	InEdgeInView in_edge_in_view(&graph, view);
 
-	return vector<edge_descriptor>(range.begin(), range.end());
+	return in_edge_range_t(view_in_edge_iterator(in_edge_in_view, first, last),
+			       view_in_edge_iterator(in_edge_in_view, last, last));
     }
 
 
-    vector<Devicegraph::Impl::edge_descriptor>
+    Devicegraph::Impl::out_edge_range_t
     Devicegraph::Impl::out_edges(vertex_descriptor vertex, View view) const
     {
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
+	out_edge_iterator first, last;
+	boost::tie(first, last) = boost::out_edges(vertex, graph);
 
-	boost::iterator_range<filtered_graph_t::out_edge_iterator> range =
-	    boost::make_iterator_range(boost::out_edges(vertex, filtered_graph));
+	OutEdgeInView out_edge_in_view(&graph, view);
 
-	return vector<edge_descriptor>(range.begin(), range.end());
+	return out_edge_range_t(view_out_edge_iterator(out_edge_in_view, first, last),
+				view_out_edge_iterator(out_edge_in_view, last, last));
     }
 
 
@@ -734,51 +2159,82 @@ namespace storage
 
 	clear();
 
-	XmlFile xml(filename);
-
-	const xmlNode* root_node = xml.getRootElement();
-	if (!root_node)
-	    ST_THROW(Exception("root node not found"));
+	// The devices are loaded while reading the file. Since save() writes
+	// the devices before the holders all devices exist when the holders
+	// are loaded.
+	//
+	// Loading is one batch. Unlike Devicegraph::Batch no checkpoint is
+	// used since a failed load is undone by clearing the devicegraph
+	// again, so the added devices and holders are not recorded.
 
-	const xmlNode* devicegraph_node = getChildNode(root_node, "Devicegraph");
-	if (!devicegraph_node)
-	    ST_THROW(Exception("Devicegraph node not found"));
+	begin_batch();
 
-	const xmlNode* devices_node = getChildNode(devicegraph_node, "Devices");
-	if (devices_node)
+	try
 	{
-	    for (const xmlNode* device_node : getChildNodes(devices_node))
-	    {
-		const string& classname = (const char*) device_node->parent->name;
+	    const XmlStreamReader::entry_fnc load_entry = [devicegraph](const string& section,
+									 const xmlNode* entry_node) {
 
-		map<string, device_load_fnc>::const_iterator it = device_load_registry.find(classname);
-		if (it == device_load_registry.end())
-		    ST_THROW(Exception(sformat("unknown device class name %s", classname)));
+		const xmlNode* node = entry_node->children;
+		if (!node)
+		    return;
 
-		const Device* device = it->second(devicegraph, device_node);
-		Storage::Impl::raise_global_sid(device->get_sid());
-	    }
-	}
+		const string& classname = (const char*) entry_node->name;
 
-	const xmlNode* holders_node = getChildNode(devicegraph_node, "Holders");
-	if (holders_node)
-	{
-	    for (const xmlNode* holder_node : getChildNodes(holders_node))
-	    {
-		const string& classname = (const char*) holder_node->parent->name;
+		if (section == "Devices")
+		{
+		    map<string, device_load_fnc>::const_iterator it = device_load_registry.find(classname);
+		    if (it == device_load_registry.end())
+			ST_THROW(Exception(sformat("unknown device class name %s", classname)));
 
-		map<string, holder_load_fnc>::const_iterator it = holder_load_registry.find(classname);
-		if (it == holder_load_registry.end())
-		    ST_THROW(Exception(sformat("unknown holder class name %s", classname)));
+		    const Device* device = it->second(devicegraph, node);
+		    Storage::Impl::raise_global_sid(device->get_sid());
+		}
+		else if (section == "Holders")
+		{
+		    map<string, holder_load_fnc>::const_iterator it = holder_load_registry.find(classname);
+		    if (it == holder_load_registry.end())
+			ST_THROW(Exception(sformat("unknown holder class name %s", classname)));
+
+		    it->second(devicegraph, node);
+		}
 
-		it->second(devicegraph, holder_node);
+	    };
+
+	    // The binary format holds the same elements as the XML format, so
+	    // both are loaded by the same function.
+
+	    if (XmlBinaryReader::is_binary_file(filename))
+	    {
+		XmlBinaryReader xml(filename);
+		xml.read("Devicegraph", load_entry);
+	    }
+	    else
+	    {
+		XmlStreamReader xml(filename);
+		xml.read("Devicegraph", load_entry);
 	    }
 	}
+	catch (...)
+	{
+	    clear();
+	    end_batch();
+	    throw;
+	}
+
+	try
+	{
+	    end_batch();
+	}
+	catch (...)
+	{
+	    clear();
+	    throw;
+	}
     }
 
 
     void
-    Devicegraph::Impl::save(const string& filename) const
+    Devicegraph::Impl::save(const string& filename, DevicegraphFormat format) const
     {
 	XmlFile xml;
 
@@ -806,7 +2262,20 @@ namespace storage
 	    holder->get_impl().save(holder_node);
 	}
 
-	if (!xml.save_to_file(filename))
+	bool ok = false;
+
+	switch (format)
+	{
+	    case DevicegraphFormat::XML:
+		ok = xml.save_to_file(filename);
+		break;
+
+	    case DevicegraphFormat::BINARY:
+		ok = xml.save_to_binary_file(filename);
+		break;
+	}
+
+	if (!ok)
 	    ST_THROW(Exception(sformat("failed to write '%s'", filename)));
     }
 
@@ -889,31 +2358,25 @@ namespace storage
     {
 	ST_CHECK_PTR(style_callbacks);
 
-	filtered_graph_t filtered_graph(graph, make_edge_filter(view), make_vertex_filter(view));
-
 	ofstream fout(filename);
 
 	fout << "// " << generated_string() << "\n\n";
 
-	// Build up a property map with the sid to be used for the
-	// vertex id. Same as VertexIndexMapGenerator but with the sid
-	// instead of a generated index. Why? For once the sid is
-	// needed as id for the ranks. Also other programs can query
-	// the id when the user clicks on a node and thus can lookup
-	// the device easily.
-
-	typedef map<vertex_descriptor, sid_t> vertex_id_map_t;
+	// Use a property map with the sid for the vertex id instead of
+	// the vertex index. Why? For once the sid is needed as id for
+	// the ranks. Also other programs can query the id when the user
+	// clicks on a node and thus can lookup the device easily.
 
-	vertex_id_map_t vertex_id_map;
-
-	boost::associative_property_map<vertex_id_map_t> vertex_id_property_map(vertex_id_map);
-
-	for (vertex_descriptor vertex : vertices())
-	    boost::put(vertex_id_property_map, vertex, graph[vertex].get()->get_sid());
+	auto vertex_id_property_map = boost::make_function_property_map<vertex_descriptor>(
+	    [this](vertex_descriptor vertex) { return graph[vertex]->get_sid(); }
+	);
 
 	const DevicegraphWriter devicegraph_writer(style_callbacks, *this);
-	boost::write_graphviz(fout, filtered_graph, devicegraph_writer, devicegraph_writer,
-			      devicegraph_writer, vertex_id_property_map);
+
+	with_view_graph(graph, view, [&](const auto& view_graph) {
+	    boost::write_graphviz(fout, view_graph, devicegraph_writer, devicegraph_writer,
+				  devicegraph_writer, vertex_id_property_map);
+	});
 
 	fout.close();
 
@@ -921,26 +2384,4 @@ namespace storage
 	    ST_THROW(IOException(sformat("failed to write '%s'", filename)));
     }
 
-
-    Devicegraph::Impl::vertex_filter_t
-    Devicegraph::Impl::make_vertex_filter(View view) const
-    {
-	// graph is needed by reference and view by value
-	return [&, view](Devicegraph::Impl::vertex_descriptor vertex) {
-	    const Device* device = graph[vertex].get();
-	    return device->get_impl().is_in_view(view);
-	};
-    }
-
-
-    Devicegraph::Impl::edge_filter_t
-    Devicegraph::Impl::make_edge_filter(View view) const
-    {
-	// graph is needed by reference and view by value
-	return [&, view](Devicegraph::Impl::edge_descriptor edge) {
-	    const Holder* holder = graph[edge].get();
-	    return holder->get_impl().is_in_view(view);
-	};
-    }
-
 }
@@ -26,9 +26,19 @@
 
 
 #include <set>
+#include <map>
+#include <atomic>
+#include <tuple>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <boost/noncopyable.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/filtered_graph.hpp>
+#include <boost/iterator/filter_iterator.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+#include <boost/range/iterator_range.hpp>
 
 #include "storage/Devices/Device.h"
 #include "storage/Holders/Holder.h"
@@ -42,11 +52,38 @@ namespace storage
     using std::vector;
     using std::set;
     using std::pair;
+    using std::shared_ptr;
 
 
     using sid_pair_t = pair<sid_t, sid_t>;
 
 
+    /**
+     * Compact tag for each device class. Used as bit position in
+     * device_types_t and as index of the type buckets of the devicegraph.
+     */
+    enum class DeviceType : unsigned int
+    {
+	DEVICE, BLK_DEVICE, PARTITIONABLE, DISK, DASD, MULTIPATH, DM_RAID, MD, MD_CONTAINER,
+	MD_MEMBER, BCACHE, BCACHE_CSET, PARTITION_TABLE, MSDOS, GPT, DASD_PT, IMPLICIT_PT,
+	PARTITION, STRAY_BLK_DEVICE, LVM_PV, LVM_VG, LVM_LV, ENCRYPTION, PLAIN_ENCRYPTION, LUKS,
+	MOUNTABLE, FILESYSTEM, BLK_FILESYSTEM, EXT, EXT2, EXT3, EXT4, BTRFS, BTRFS_SUBVOLUME,
+	BTRFS_QGROUP, NTFS, VFAT, EXFAT, REISERFS, XFS, JFS, F2FS, SWAP, ISO9660, UDF, BITLOCKER,
+	NFS, TMPFS, MOUNT_POINT
+    };
+
+    const unsigned int num_device_types = (unsigned int)(DeviceType::MOUNT_POINT) + 1;
+
+    /**
+     * Set of device types, see Device::Impl::get_device_types().
+     */
+    typedef unsigned long long device_types_t;
+
+    static_assert(num_device_types <= sizeof(device_types_t) * 8, "too many device types");
+
+    template <typename Type> struct DeviceTraits;
+
+
     class Devicegraph::Impl : private boost::noncopyable
     {
 
@@ -62,8 +99,13 @@ namespace storage
 	// properties, see:
 	// http://www.boost.org/doc/libs/1_56_0/libs/graph/doc/bundles.html
 
+	// With VertexList=boost::listS the adjacency_list does not have a
+	// vertex_index property. Since many algorithms need one it is kept as
+	// internal property, see add_vertex() and remove_vertex().
+
 	typedef boost::adjacency_list<boost::listS, boost::listS, boost::bidirectionalS,
-				      std::shared_ptr<Device>, std::shared_ptr<Holder>> graph_t;
+				      boost::property<boost::vertex_index_t, size_t, std::shared_ptr<Device>>,
+				      std::shared_ptr<Holder>> graph_t;
 
 	typedef graph_t::vertex_descriptor vertex_descriptor;
 	typedef graph_t::edge_descriptor edge_descriptor;
@@ -79,19 +121,118 @@ namespace storage
 
 	typedef graph_t::vertices_size_type vertices_size_type;
 
-	typedef std::function<bool(Devicegraph::Impl::vertex_descriptor)> vertex_filter_t;
-	typedef std::function<bool(Devicegraph::Impl::edge_descriptor)> edge_filter_t;
+	/**
+	 * Predicates for the out and in edges visible in a view. Like in
+	 * boost::filtered_graph the holder and the device at the other end of
+	 * the edge must be in the view.
+	 */
+	class OutEdgeInView
+	{
+	public:
+
+	    OutEdgeInView() = default;
+	    OutEdgeInView(const graph_t* graph, View view) : graph(graph), view(view) {}
+
+	    bool operator()(edge_descriptor edge) const;
+
+	private:
+
+	    const graph_t* graph = nullptr;
+	    View view = View::ALL;
+
+	};
+
+	class InEdgeInView
+	{
+	public:
+
+	    InEdgeInView() = default;
+	    InEdgeInView(const graph_t* graph, View view) : graph(graph), view(view) {}
+
+	    bool operator()(edge_descriptor edge) const;
+
+	private:
+
+	    const graph_t* graph = nullptr;
+	    View view = View::ALL;
+
+	};
+
+	class EdgeTarget
+	{
+	public:
+
+	    EdgeTarget() = default;
+	    EdgeTarget(const graph_t* graph) : graph(graph) {}
+
+	    vertex_descriptor operator()(edge_descriptor edge) const { return boost::target(edge, *graph); }
+
+	private:
+
+	    const graph_t* graph = nullptr;
+
+	};
+
+	class EdgeSource
+	{
+	public:
+
+	    EdgeSource() = default;
+	    EdgeSource(const graph_t* graph) : graph(graph) {}
+
+	    vertex_descriptor operator()(edge_descriptor edge) const { return boost::source(edge, *graph); }
+
+	private:
+
+	    const graph_t* graph = nullptr;
+
+	};
+
+	// Lazy ranges over the edges, children and parents of a vertex
+	// visible in a view. Creating and iterating them does not allocate
+	// memory. The ranges are invalidated by adding or removing edges of
+	// the vertex.
+
+	typedef boost::filter_iterator<OutEdgeInView, out_edge_iterator> view_out_edge_iterator;
+	typedef boost::filter_iterator<InEdgeInView, in_edge_iterator> view_in_edge_iterator;
+
+	typedef boost::transform_iterator<EdgeTarget, view_out_edge_iterator> child_iterator;
+	typedef boost::transform_iterator<EdgeSource, view_in_edge_iterator> parent_iterator;
+
+	typedef boost::iterator_range<view_out_edge_iterator> out_edge_range_t;
+	typedef boost::iterator_range<view_in_edge_iterator> in_edge_range_t;
 
-	typedef boost::filtered_graph<graph_t, edge_filter_t, vertex_filter_t> filtered_graph_t;
+	typedef boost::iterator_range<child_iterator> child_range_t;
+	typedef boost::iterator_range<parent_iterator> parent_range_t;
 
+	typedef std::unordered_multimap<string, vertex_descriptor> string_index_t;
 
-	Impl(Storage* storage) : storage(storage) {}
+	typedef std::unique_lock<std::recursive_mutex> indices_lock_t;
+
+	typedef std::unordered_multimap<sid_pair_t, edge_descriptor, boost::hash<sid_pair_t>> holder_index_t;
+
+
+	Impl(Storage* storage)
+	    : storage(storage), type_buckets(num_device_types), next_sequence(0), generation(0),
+	      traversal_cache_size(0), traversal_cache_generation(0),
+	      structure_hash(0), content_hash(0), content_hash_generation(0), content_hash_stale(true),
+	      next_checkpoint_id(0), rolling_back(false), checked(false), batch_depth(0),
+	      indexed_vertices(0), holders_unchecked(false) {}
 
 	bool operator==(const Impl& rhs) const;
 	bool operator!=(const Impl& rhs) const { return !(*this == rhs); }
 
 	void check(const CheckCallbacks* check_callbacks) const;
 
+	/**
+	 * Like check() but only checks the devices added, modified or with
+	 * changed holders since the last successful check. Since the checks
+	 * of a device can look at its parents and children these are also
+	 * checked. Falls back to check() if the devicegraph was never
+	 * checked.
+	 */
+	void check_incremental(const CheckCallbacks* check_callbacks) const;
+
 	uf_t used_features(UsedFeaturesDependencyType used_features_dependency_type) const;
 
 	void log_diff(std::ostream& log, const Impl& rhs) const;
@@ -127,6 +268,49 @@ namespace storage
 	bool holder_exists(sid_t source_sid, sid_t target_sid) const;
 
 	vertex_descriptor find_vertex(sid_t sid) const;
+
+	/**
+	 * Find the vertices of block devices by name or sysfs path using the
+	 * name index. Only block devices are included in the name index.
+	 * Udev links are not included since the udev ids and paths in the
+	 * devicegraph can be outdated, see BlkDevice::Impl::find_by_any_name().
+	 */
+	vector<vertex_descriptor> find_vertices_by_name(const string& name) const;
+	vector<vertex_descriptor> find_vertices_by_sysfs_path(const string& sysfs_path) const;
+
+	/**
+	 * Remove the vertex from or add the vertex to the name index. Must be
+	 * called before and after changing the name or sysfs path of a block
+	 * device in the devicegraph.
+	 */
+	void remove_from_name_index(vertex_descriptor vertex);
+	void add_to_name_index(vertex_descriptor vertex);
+
+	/**
+	 * Find the vertices of devices by UUID using the uuid index. Only
+	 * devices with a non-empty Device::Impl::get_indexed_uuid() are
+	 * included in the uuid index. Searching for an empty UUID scans all
+	 * vertices.
+	 */
+	vector<vertex_descriptor> find_vertices_by_uuid(const string& uuid) const;
+
+	/**
+	 * Remove the vertex from or add the vertex to the uuid index. Must be
+	 * called before and after changing the UUID of a device in the
+	 * devicegraph.
+	 */
+	void remove_from_uuid_index(vertex_descriptor vertex);
+	void add_to_uuid_index(vertex_descriptor vertex);
+
+	/**
+	 * Locks the name and uuid indices. Must be held while changing the
+	 * name, sysfs path, udev links or UUID of a device in the
+	 * devicegraph since actions committed in parallel do that
+	 * concurrently, see CommitOptions::max_parallel_actions. The
+	 * functions above lock the indices themselves.
+	 */
+	indices_lock_t lock_indices() const { return indices_lock_t(indices_mutex); }
+
 	edge_descriptor find_edge(sid_t source_sid, sid_t target_sid) const;
 	vector<edge_descriptor> find_edges(sid_t source_sid, sid_t target_sid) const;
 	vector<edge_descriptor> find_edges(sid_pair_t sid_pair) const;
@@ -144,14 +328,104 @@ namespace storage
 
 	void clear();
 
+	/**
+	 * The generation of the devicegraph. It is increased by every
+	 * modification of the structure of the graph, e.g. adding or
+	 * removing a device or holder. Used to invalidate caches.
+	 */
+	unsigned long long get_generation() const { return generation; }
+
+	/**
+	 * Hash of the structure of the devicegraph, so of the sids and types
+	 * of all devices and holders. Devicegraphs with different structure
+	 * hashes are never equal. The attributes of the devices and holders
+	 * are not included.
+	 */
+	size_t get_structure_hash() const { update_indices(); return structure_hash; }
+
+	/**
+	 * Hash of the content of the devicegraph, so of all devices and
+	 * holders including their attributes, see
+	 * Device::Impl::get_content_hash(). Devicegraphs with different
+	 * content hashes are not equal. Cached until the structure of the
+	 * graph or a device or holder is modified.
+	 */
+	size_t get_content_hash() const;
+
 	void remove_vertex(vertex_descriptor vertex);
 	void remove_edge(edge_descriptor edge);
 
+	/**
+	 * Begin or end a batch of modifications, see Devicegraph::batch().
+	 * During a batch adding vertices and edges does not update the
+	 * indices, except for the sid index and the vertex index, and adding
+	 * an edge does not check for an existing edge of the same type. The
+	 * vertices and edges added are indexed on the next lookup or when
+	 * the outermost batch ends, the holders are checked when it ends.
+	 * Additions during a batch are not recorded in the undo log.
+	 *
+	 * @throw HolderAlreadyExists
+	 */
+	void begin_batch();
+	void end_batch();
+
+	/**
+	 * Create a checkpoint and return its id. Until the checkpoint is
+	 * rolled back or released all additions and removals of vertices and
+	 * edges are recorded in an undo log. For devices and holders a copy
+	 * is recorded before their first modification after the checkpoint,
+	 * see record_change(). Checkpoints can be nested. Ids are never
+	 * reused.
+	 */
+	unsigned int checkpoint();
+
+	/**
+	 * Undo all additions, removals and modifications of vertices and
+	 * edges since the checkpoint was created. The cost is proportional to
+	 * the number of recorded changes. Releases the checkpoint and all
+	 * later checkpoints.
+	 *
+	 * @throw Exception
+	 */
+	void rollback(unsigned int checkpoint);
+
+	/**
+	 * Release the checkpoint and all later checkpoints without undoing
+	 * the changes.
+	 *
+	 * @throw Exception
+	 */
+	void release_checkpoint(unsigned int checkpoint);
+
+	/**
+	 * Invalidates the content hash, marks the affected devices for
+	 * check_incremental() and records the state of the device or holder
+	 * before it is modified if a checkpoint is active. Called by
+	 * about_to_modify() of Device::Impl and Holder::Impl.
+	 */
+	void record_change(const Device* device)
+	{
+	    content_hash_stale = true;
+	    if (checked)
+		mark_changed(device);
+	    if (is_recording())
+		record_device_change(device);
+	}
+
+	void record_change(const Holder* holder)
+	{
+	    content_hash_stale = true;
+	    if (checked)
+		mark_changed(holder);
+	    if (is_recording())
+		record_holder_change(holder);
+	}
+
 	boost::iterator_range<vertex_iterator> vertices() const;
 	boost::iterator_range<edge_iterator> edges() const;
 
 	void load(Devicegraph* devicegraph, const string& filename);
-	void save(const string& filename) const;
+	void save(const string& filename, DevicegraphFormat format) const;
 
 	void print(std::ostream& out) const;
 
@@ -164,12 +438,8 @@ namespace storage
 	vertex_descriptor child(vertex_descriptor vertex, View view = View::CLASSIC) const;
 	vertex_descriptor parent(vertex_descriptor vertex, View view = View::CLASSIC) const;
 
-	// TODO use iterator base functions instead of vector based below
-	// boost::iterator_range<adjacency_iterator> children(vertex_descriptor vertex) const;
-	// boost::iterator_range<inv_adjacency_iterator> parents(vertex_descriptor vertex) const;
-
-	vector<vertex_descriptor> children(vertex_descriptor vertex, View view = View::CLASSIC) const;
-	vector<vertex_descriptor> parents(vertex_descriptor vertex, View view = View::CLASSIC) const;
+	child_range_t children(vertex_descriptor vertex, View view = View::CLASSIC) const;
+	parent_range_t parents(vertex_descriptor vertex, View view = View::CLASSIC) const;
 	vector<vertex_descriptor> siblings(vertex_descriptor vertex, bool itself, View view = View::CLASSIC) const;
 	vector<vertex_descriptor> descendants(vertex_descriptor vertex, bool itself, View view = View::CLASSIC) const;
 	vector<vertex_descriptor> ancestors(vertex_descriptor vertex, bool itself, View view = View::CLASSIC) const;
@@ -179,22 +449,26 @@ namespace storage
 	edge_descriptor in_edge(vertex_descriptor vertex, View view = View::CLASSIC) const;
 	edge_descriptor out_edge(vertex_descriptor vertex, View view = View::CLASSIC) const;
 
-	vector<edge_descriptor> in_edges(vertex_descriptor vertex, View view = View::CLASSIC) const;
-	vector<edge_descriptor> out_edges(vertex_descriptor vertex, View view = View::CLASSIC) const;
+	in_edge_range_t in_edges(vertex_descriptor vertex, View view = View::CLASSIC) const;
+	out_edge_range_t out_edges(vertex_descriptor vertex, View view = View::CLASSIC) const;
 
 
+	/**
+	 * Get all devices of Type using the type buckets. The devices are in
+	 * the order of vertices(). Type must have a device_type in its
+	 * DeviceTraits.
+	 */
 	template<typename Type>
 	vector<Type*>
 	get_devices_of_type() const
 	{
+	    const type_bucket_t& type_bucket = get_type_bucket<Type>();
+
 	    vector<Type*> ret;
+	    ret.reserve(type_bucket.size());
 
-	    for (vertex_descriptor vertex : vertices())
-	    {
-		Type* device = dynamic_cast<Type*>(graph[vertex].get());
-		if (device)
-		    ret.push_back(device);
-	    }
+	    for (const type_bucket_t::value_type& value : type_bucket)
+		ret.push_back(static_cast<Type*>(graph[value.second].get()));
 
 	    return ret;
 	}
@@ -206,10 +480,10 @@ namespace storage
 	{
 	    vector<Type*> ret;
 
-	    for (vertex_descriptor vertex : vertices())
+	    for (const type_bucket_t::value_type& value : get_type_bucket<Type>())
 	    {
-		Type* device = dynamic_cast<Type*>(graph[vertex].get());
-		if (device && pred(device))
+		Type* device = static_cast<Type*>(graph[value.second].get());
+		if (pred(device))
 		    ret.push_back(device);
 	    }
 
@@ -217,9 +491,13 @@ namespace storage
 	}
 
 
-	template <typename Type>
+	/**
+	 * Get the devices of Type for the vertices. Range can be a vector or
+	 * one of the lazy ranges, e.g. child_range_t.
+	 */
+	template <typename Type, typename Range>
 	vector<Type*>
-	filter_devices_of_type(const vector<vertex_descriptor>& vertices)
+	filter_devices_of_type(const Range& vertices)
 	{
 	    vector<Type*> ret;
 
@@ -234,9 +512,9 @@ namespace storage
 	}
 
 
-	template <typename Type>
+	template <typename Type, typename Range>
 	vector<const Type*>
-	filter_devices_of_type(const vector<vertex_descriptor>& vertices) const
+	filter_devices_of_type(const Range& vertices) const
 	{
 	    vector<const Type*> ret;
 
@@ -251,9 +529,9 @@ namespace storage
 	}
 
 
-	template <typename Type>
+	template <typename Type, typename Range>
 	vector<Type*>
-	filter_holders_of_type(const vector<edge_descriptor>& edges)
+	filter_holders_of_type(const Range& edges)
 	{
 	    vector<Type*> ret;
 
@@ -268,9 +546,9 @@ namespace storage
 	}
 
 
-	template <typename Type>
+	template <typename Type, typename Range>
 	vector<const Type*>
-	filter_holders_of_type(const vector<edge_descriptor>& edges) const
+	filter_holders_of_type(const Range& edges) const
 	{
 	    vector<const Type*> ret;
 
@@ -287,6 +565,12 @@ namespace storage
 
 	void swap(Devicegraph::Impl& x);
 
+	/**
+	 * Rebuild the lookup indices from the graph. Only needed after the
+	 * graph was modified directly, e.g. by boost::copy_graph.
+	 */
+	void rebuild_indices();
+
 	Storage* get_storage() { return storage; }
 	const Storage* get_storage() const { return storage; }
 
@@ -294,11 +578,274 @@ namespace storage
 
     private:
 
-	vertex_filter_t make_vertex_filter(View view) const;
-	edge_filter_t make_edge_filter(View view) const;
+	enum class Traversal { DESCENDANTS, ANCESTORS, LEAVES, ROOTS };
+
+	typedef std::tuple<vertex_descriptor, Traversal, View, bool> traversal_key_t;
+
+	struct TraversalKeyHash
+	{
+	    size_t operator()(const traversal_key_t& traversal_key) const;
+	};
+
+	typedef std::unordered_map<traversal_key_t, vector<vertex_descriptor>, TraversalKeyHash> traversal_cache_t;
+
+	bool find_in_traversal_cache(const traversal_key_t& traversal_key, vector<vertex_descriptor>& vertices) const;
+	void add_to_traversal_cache(const traversal_key_t& traversal_key, const vector<vertex_descriptor>& vertices) const;
+
+	static const size_t max_traversal_cache_size = 256 * 1024;
+
+	// Vertices of one device type ordered by the sequence number of the
+	// vertex, so in the order of vertices().
+	typedef std::map<size_t, vertex_descriptor> type_bucket_t;
+
+	template <typename Type>
+	const type_bucket_t&
+	get_type_bucket() const
+	{
+	    typedef typename std::remove_const<Type>::type BaseType;
+
+	    update_indices();
+
+	    return type_buckets[(unsigned int)(DeviceTraits<BaseType>::device_type)];
+	}
+
+	void add_to_type_buckets(vertex_descriptor vertex);
+	void remove_from_type_buckets(vertex_descriptor vertex);
+
+	vector<vertex_descriptor> find_in_index(const string_index_t& index, const string& key) const;
+
+	void add_to_holder_index(edge_descriptor edge);
+	void remove_from_holder_index(edge_descriptor edge);
+
+	/**
+	 * Add the vertices and edges added during a batch to the indices not
+	 * maintained during a batch. Must be called by all functions reading
+	 * these indices. Outside of a batch all vertices and edges are
+	 * always indexed.
+	 */
+	void update_indices() const;
+	void index_additions();
+
+	/**
+	 * Whether the vertex is in the indices not maintained during a
+	 * batch, see indexed_vertices.
+	 */
+	bool is_indexed(vertex_descriptor vertex) const;
+
+	/**
+	 * Check that no two edges between the same vertices have the same
+	 * type. Only needed after a batch.
+	 */
+	void check_holders_unique() const;
+
+	size_t vertex_hash(vertex_descriptor vertex) const;
+	size_t edge_hash(edge_descriptor edge) const;
+
+	/**
+	 * Checks the indices and back references of the vertex. Returns the
+	 * number of type buckets containing the vertex.
+	 */
+	size_t check_vertex(vertex_descriptor vertex) const;
+
+	/**
+	 * Checks the holder index and back references of the edge.
+	 */
+	void check_edge(edge_descriptor edge) const;
+
+	void mark_changed(vertex_descriptor vertex);
+
+	/**
+	 * Like mark_changed(vertex_descriptor) for a device or for the
+	 * source and target of a holder about to be modified. Locks since
+	 * actions committed in parallel can modify devices.
+	 */
+	void mark_changed(const Device* device);
+	void mark_changed(const Holder* holder);
+
+	vertex_descriptor add_vertex(const shared_ptr<Device>& device);
+	edge_descriptor add_edge(vertex_descriptor source_vertex, vertex_descriptor target_vertex,
+				 const shared_ptr<Holder>& holder);
+
+	// Entry of the undo log. The device and holder objects are kept alive
+	// by the undo log so that they can be put back into the graph. For
+	// modifications the entry also holds a copy of the device or holder
+	// made before the modification.
+	struct UndoEntry
+	{
+	    enum class Type { ADD_VERTEX, REMOVE_VERTEX, CHANGE_VERTEX, ADD_EDGE, REMOVE_EDGE, CHANGE_EDGE };
+
+	    UndoEntry(Type type, const shared_ptr<Device>& device, const shared_ptr<Device>& old_device = nullptr)
+		: type(type), device(device), old_device(old_device), holder(), old_holder(),
+		  source_sid(0), target_sid(0) {}
+
+	    UndoEntry(Type type, const shared_ptr<Holder>& holder, sid_t source_sid, sid_t target_sid,
+		      const shared_ptr<Holder>& old_holder = nullptr)
+		: type(type), device(), old_device(), holder(holder), old_holder(old_holder),
+		  source_sid(source_sid), target_sid(target_sid) {}
+
+	    Type type;
+	    shared_ptr<Device> device;
+	    shared_ptr<Device> old_device;
+	    shared_ptr<Holder> holder;
+	    shared_ptr<Holder> old_holder;
+	    sid_t source_sid;
+	    sid_t target_sid;
+	};
+
+	struct Checkpoint
+	{
+	    unsigned int id;
+	    size_t position;
+	    size_t batch_added_devices_position;
+	    size_t batch_added_holders_position;
+	};
+
+	bool is_recording() const { return !checkpoints.empty() && !rolling_back; }
+
+	void record_device_change(const Device* device);
+	void record_holder_change(const Holder* holder);
+
+	vector<Checkpoint>::iterator find_checkpoint(unsigned int checkpoint);
+
+	void undo(const UndoEntry& undo_entry);
+
+	/**
+	 * Recalculate recorded_devices and recorded_holders from the undo
+	 * log after checkpoints were rolled back or released.
+	 */
+	void update_recorded();
+
+	void invalidate_checkpoints();
+
+	/**
+	 * Remove a holder added during a batch when rolling back.
+	 *
+	 * @throw LogicException
+	 */
+	void remove_batch_added_holder(const pair<const Holder*, sid_pair_t>& batch_added_holder);
 
 	Storage* storage;
 
+	// Index to find the vertex of a sid in constant time. Must be kept in
+	// sync with the graph by all functions adding or removing vertices.
+	std::unordered_map<sid_t, vertex_descriptor> sid_index;
+
+	// Indices to find block devices by name or sysfs path in constant
+	// time. Must be kept in sync with the graph and the block devices, see
+	// remove_from_name_index() and add_to_name_index().
+	string_index_t name_index;
+	string_index_t sysfs_path_index;
+
+	// Index to find devices by UUID in constant time. Must be kept in sync
+	// with the graph and the devices, see remove_from_uuid_index() and
+	// add_to_uuid_index().
+	string_index_t uuid_index;
+
+	// Protects the name and uuid indices, see lock_indices(). Recursive
+	// since the setters of the devices hold it while calling
+	// remove_from_name_index() and add_to_name_index() or the uuid
+	// counterparts.
+	mutable std::recursive_mutex indices_mutex;
+
+	// Index to find the edges between two sids in constant time. A
+	// multimap since parallel edges are allowed. Must be kept in sync
+	// with the graph by all functions adding or removing edges.
+	holder_index_t holder_index;
+
+	// Buckets with the vertices of each device type, indexed by
+	// DeviceType. A device is in the buckets of its class and all base
+	// classes, see Device::Impl::get_device_types(). The sequence number
+	// of a vertex keeps the buckets in the order of vertices(). Must be
+	// kept in sync with the graph by all functions adding or removing
+	// vertices.
+	vector<type_bucket_t> type_buckets;
+	std::unordered_map<vertex_descriptor, size_t> vertex_sequences;
+	size_t next_sequence;
+
+	// The vertices by their vertex_index property. The vertex index is
+	// dense (0 <= index < number of vertices), when removing a vertex the
+	// last vertex takes over its index. Must be kept in sync with the
+	// graph by all functions adding or removing vertices.
+	vector<vertex_descriptor> vertices_by_index;
+
+	// Generation of the devicegraph, see get_generation(). Must be
+	// increased by all functions modifying the structure of the graph.
+	// Atomic since it is read under the traversal_cache_mutex while the
+	// graph may be modified by another thread, e.g. during a parallel
+	// commit.
+	std::atomic<unsigned long long> generation;
+
+	// Cache for the results of descendants(), ancestors(), leaves() and
+	// roots(). Only valid while traversal_cache_generation equals
+	// generation. Results for View::REMOVE are not cached since that view
+	// depends on attributes of devices and holders, e.g. the id of btrfs
+	// qgroups, and those changes do not increase the generation. The
+	// cache is cleared once it holds more than max_traversal_cache_size
+	// vertices in total. Protected by the mutex since it is modified by
+	// const functions. The mutex also serializes rebuilding stale indices
+	// in update_indices().
+	mutable traversal_cache_t traversal_cache;
+	mutable size_t traversal_cache_size;
+	mutable unsigned long long traversal_cache_generation;
+	mutable std::mutex traversal_cache_mutex;
+
+	// Sum of the hashes of all vertices and edges, see
+	// get_structure_hash(). A sum so that it can be updated when a vertex
+	// or edge is added or removed. Must be kept in sync with the graph by
+	// all functions adding or removing vertices or edges.
+	size_t structure_hash;
+
+	// Cache for get_content_hash(). Only valid while
+	// content_hash_generation equals generation and content_hash_stale
+	// is false. Atomic since devices are modified by several threads
+	// during a parallel commit.
+	mutable size_t content_hash;
+	mutable unsigned long long content_hash_generation;
+	mutable std::atomic<bool> content_hash_stale;
+
+	// Undo log and the ids and positions in the undo log of the active
+	// checkpoints, see checkpoint() and rollback(). Only recorded while a
+	// checkpoint is active. The undo_mutex protects the undo log and the
+	// recorded devices and holders against concurrent modifications of
+	// devices and holders, e.g. during a parallel commit.
+	vector<UndoEntry> undo_log;
+	vector<Checkpoint> checkpoints;
+
+	// Devices and holders added during a batch while a checkpoint is
+	// active. Unlike other modifications they are not recorded in the
+	// undo log since rolling back only has to remove them again, see
+	// rollback(). Protected by the undo_mutex.
+	vector<sid_t> batch_added_devices;
+	vector<pair<const Holder*, sid_pair_t>> batch_added_holders;
+	unsigned int next_checkpoint_id;
+	bool rolling_back;
+
+	// Devices and holders that need no copy before a modification: those
+	// added or already copied since the last checkpoint and the removed
+	// holders. Removed holders are included since their edge is no longer
+	// valid.
+	std::unordered_set<const Device*> recorded_devices;
+	std::unordered_set<const Holder*> recorded_holders;
+	std::unordered_set<const Holder*> removed_holders;
+	std::mutex undo_mutex;
+
+	// Whether check() succeeded and the sids of the devices added,
+	// modified or with changed holders since then, see
+	// check_incremental(). Only recorded while checked is true.
+	mutable bool checked;
+	mutable std::unordered_set<sid_t> changed_sids;
+
+	// Nesting depth of batches, the vertices and edges added during a
+	// batch but not yet in the indices not maintained during a batch and
+	// whether edges were added without checking for an existing edge of
+	// the same type, see begin_batch(). The vertices not yet indexed are
+	// always the last ones in vertices_by_index, since removing a vertex
+	// or an edge indexes all additions first.
+	unsigned int batch_depth;
+	size_t indexed_vertices;
+	vector<edge_descriptor> unindexed_edges;
+	bool holders_unchecked;
+
     };
 
 }
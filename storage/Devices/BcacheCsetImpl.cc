@@ -22,6 +22,7 @@
 
 #include <regex>
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/StorageTmpl.h"
@@ -66,6 +67,19 @@ namespace storage
     }
 
 
+    void
+    BcacheCset::Impl::set_uuid(const string& uuid)
+    {
+	about_to_modify();
+
+	Devicegraph::Impl::indices_lock_t lock = lock_indices();
+
+	remove_from_uuid_index();
+	Impl::uuid = uuid;
+	add_to_uuid_index();
+    }
+
+
     void
     BcacheCset::Impl::save(xmlNode* node) const
     {
@@ -125,6 +139,8 @@ namespace storage
     void
     BcacheCset::Impl::probe_pass_1b(Prober& prober)
     {
+	about_to_modify();
+
 	static regex cache_regex("cache[0-9]+", regex::extended);
 	static regex bdev_regex("bdev[0-9]+", regex::extended);
 	static regex volume_regex("volume[0-9]+", regex::extended);
@@ -203,6 +219,17 @@ namespace storage
     }
 
 
+    size_t
+    BcacheCset::Impl::calculate_content_hash() const
+    {
+	size_t seed = Device::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, uuid);
+
+	return seed;
+    }
+
+
     void
     BcacheCset::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -278,7 +305,7 @@ namespace storage
 
 	    if (regex_match(line, match, set_uuid_regex) && match.size() == 2)
 	    {
-		uuid = match[1];
+		set_uuid(match[1]);
 		y2mil("found set-uuid " << uuid);
 		break;
 	    }
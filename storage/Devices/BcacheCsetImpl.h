@@ -38,7 +38,11 @@ namespace storage
     class BlkDevice;
 
 
-    template <> struct DeviceTraits<BcacheCset> { static const char* classname; };
+    template <> struct DeviceTraits<BcacheCset>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::BCACHE_CSET;
+    };
 
 
     class BcacheCset::Impl : public Device::Impl
@@ -52,6 +56,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<BcacheCset>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Device::Impl::get_device_types() | device_type_bit<BcacheCset>(); }
+
 	virtual string get_displayname() const override { return "bcache cache"; }
 
 	virtual string get_pretty_classname() const override;
@@ -76,9 +83,12 @@ namespace storage
 	virtual uf_t used_features(UsedFeaturesDependencyType used_features_dependency_type) const override;
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
+
+	virtual string get_indexed_uuid() const override { return uuid; }
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
@@ -21,6 +21,7 @@
 
 
 #include <regex>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Utils/Algorithm.h"
 #include "storage/Utils/AppUtil.h"
@@ -287,6 +288,8 @@ namespace storage
     void
     Bcache::Impl::probe_pass_1a(Prober& prober)
     {
+	about_to_modify();
+
 	Partitionable::Impl::probe_pass_1a(prober);
 
 	SystemInfo& system_info = prober.get_system_info();
@@ -311,6 +314,8 @@ namespace storage
     void
     Bcache::Impl::probe_pass_1b(Prober& prober)
     {
+	about_to_modify();
+
 	Partitionable::Impl::probe_pass_1b(prober);
 
 	if (get_type() == BcacheType::BACKED)
@@ -345,6 +350,8 @@ namespace storage
     void
     Bcache::Impl::set_number(unsigned int number)
     {
+	about_to_modify();
+
 	std::pair<string, unsigned int> pair = device_to_name_and_number(get_name());
 
 	set_name(name_and_number_to_device(pair.first, number));
@@ -399,6 +406,8 @@ namespace storage
     void
     Bcache::Impl::add_bcache_cset(BcacheCset* bcache_cset)
     {
+	about_to_modify();
+
 	ST_CHECK_PTR(bcache_cset);
 
 	if(get_type() == BcacheType::FLASH_ONLY)
@@ -414,6 +423,8 @@ namespace storage
     void
     Bcache::Impl::remove_bcache_cset()
     {
+	about_to_modify();
+
 	if(get_type() == BcacheType::FLASH_ONLY)
 	    ST_THROW(LogicException("A Caching Set cannot be removed from a flash-only bcache"));
 
@@ -429,6 +440,8 @@ namespace storage
     void
     Bcache::Impl::update_sysfs_name_and_path()
     {
+	about_to_modify();
+
 	set_sysfs_name(get_name().substr(strlen(DEV_DIR "/")));
 	set_sysfs_path("/devices/virtual/block/" + get_sysfs_name());
     }
@@ -450,6 +463,20 @@ namespace storage
     }
 
 
+    size_t
+    Bcache::Impl::calculate_content_hash() const
+    {
+	size_t seed = Partitionable::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, type);
+	boost::hash_combine(seed, cache_mode);
+	boost::hash_combine(seed, writeback_percent);
+	boost::hash_combine(seed, sequential_cutoff);
+
+	return seed;
+    }
+
+
     void
     Bcache::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -483,6 +510,8 @@ namespace storage
     void
     Bcache::Impl::parent_has_new_region(const Device* parent)
     {
+	about_to_modify();
+
 	calculate_region();
     }
 
@@ -490,6 +519,8 @@ namespace storage
     void
     Bcache::Impl::calculate_region()
     {
+	about_to_modify();
+
 	if(get_type() == BcacheType::BACKED)
 	{
 	    const BlkDevice* blk_device = get_backing_device();
@@ -40,7 +40,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Bcache> { static const char* classname; };
+    template <> struct DeviceTraits<Bcache>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::BCACHE;
+    };
 
     template <> struct EnumTraits<BcacheType> { static const vector<string> names; };
 
@@ -57,6 +61,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Bcache>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Partitionable::Impl::get_device_types() | device_type_bit<Bcache>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_name_sort_key() const override;
@@ -97,15 +104,16 @@ namespace storage
 	BcacheType get_type() const { return type; }
 
 	CacheMode get_cache_mode() const { return cache_mode; }
-	void set_cache_mode(CacheMode mode) { cache_mode = mode; }
+	void set_cache_mode(CacheMode mode) { about_to_modify(); cache_mode = mode; }
 
 	unsigned long long get_sequential_cutoff() const { return sequential_cutoff; }
-	void set_sequential_cutoff(unsigned long long size) { sequential_cutoff = size; }
+	void set_sequential_cutoff(unsigned long long size) { about_to_modify(); sequential_cutoff = size; }
 
 	unsigned get_writeback_percent() const { return writeback_percent; }
-	void set_writeback_percent(unsigned percent) { writeback_percent = percent; }
+	void set_writeback_percent(unsigned percent) { about_to_modify(); writeback_percent = percent; }
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
@@ -23,6 +23,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/range/adaptor/reversed.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/HumanString.h"
@@ -30,6 +31,8 @@
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/Mockup.h"
+#include "storage/Utils/RegionImpl.h"
+#include "storage/Utils/TopologyImpl.h"
 #include "storage/Devices/BlkDeviceImpl.h"
 #include "storage/Devices/EncryptionImpl.h"
 #include "storage/Devices/BcacheImpl.h"
@@ -70,11 +73,17 @@ namespace storage
 	: Device::Impl(node), name(), active(true), read_only(false), region(0, 0, 512), topology(),
 	  udev_paths(), udev_ids(), dm_table_name()
     {
-	if (!getChildValue(node, "name", name))
+	string tmp;
+
+	if (!getChildValue(node, "name", tmp))
 	    ST_THROW(Exception("no name"));
+	name = tmp;
+
+	if (getChildValue(node, "sysfs-name", tmp))
+	    sysfs_name = tmp;
 
-	getChildValue(node, "sysfs-name", sysfs_name);
-	getChildValue(node, "sysfs-path", sysfs_path);
+	if (getChildValue(node, "sysfs-path", tmp))
+	    sysfs_path = tmp;
 
 	getChildValue(node, "active", active);
 	getChildValue(node, "read-only", read_only);
@@ -83,8 +92,8 @@ namespace storage
 
 	getChildValue(node, "topology", topology);
 
-	getChildValue(node, "udev-path", udev_paths);
-	getChildValue(node, "udev-id", udev_ids);
+	getChildValue(node, "udev-path", udev_paths.get_for_write());
+	getChildValue(node, "udev-id", udev_ids.get_for_write());
 
 	getChildValue(node, "dm-table-name", dm_table_name);
     }
@@ -93,13 +102,17 @@ namespace storage
     void
     BlkDevice::Impl::probe_pass_1a(Prober& prober)
     {
+	about_to_modify();
+
 	Device::Impl::probe_pass_1a(prober);
 
 	if (active)
 	{
 	    SystemInfo& system_info = prober.get_system_info();
 
-	    const CmdUdevadmInfo& cmd_udevadm_info = system_info.getCmdUdevadmInfo(name);
+	    const CmdUdevadmInfo& cmd_udevadm_info = system_info.getCmdUdevadmInfo(get_name());
+
+	    remove_from_name_index();
 
 	    sysfs_name = cmd_udevadm_info.get_name();
 	    sysfs_path = cmd_udevadm_info.get_path();
@@ -112,14 +125,16 @@ namespace storage
 	    if (!cmd_udevadm_info.get_by_path_links().empty())
 	    {
 		udev_paths = cmd_udevadm_info.get_by_path_links();
-		process_udev_paths(udev_paths);
+		process_udev_paths(udev_paths.get_for_write());
 	    }
 
 	    if (!cmd_udevadm_info.get_by_id_links().empty())
 	    {
 		udev_ids = cmd_udevadm_info.get_by_id_links();
-		process_udev_ids(udev_ids);
+		process_udev_ids(udev_ids.get_for_write());
 	    }
+
+	    add_to_name_index();
 	}
     }
 
@@ -127,6 +142,8 @@ namespace storage
     void
     BlkDevice::Impl::probe_size(Prober& prober)
     {
+	about_to_modify();
+
 	SystemInfo& system_info = prober.get_system_info();
 
 	const File& size_file = get_sysfs_file(system_info, "size");
@@ -147,6 +164,8 @@ namespace storage
     void
     BlkDevice::Impl::probe_topology(Prober& prober)
     {
+	about_to_modify();
+
 	SystemInfo& system_info = prober.get_system_info();
 
 	const File& alignment_offset_file = get_sysfs_file(system_info, "alignment_offset");
@@ -164,10 +183,10 @@ namespace storage
     {
 	Device::Impl::save(node);
 
-	setChildValue(node, "name", name);
+	setChildValue(node, "name", get_name());
 
-	setChildValueIf(node, "sysfs-name", sysfs_name, !sysfs_name.empty());
-	setChildValueIf(node, "sysfs-path", sysfs_path, !sysfs_path.empty());
+	setChildValueIf(node, "sysfs-name", get_sysfs_name(), !sysfs_name.empty());
+	setChildValueIf(node, "sysfs-path", get_sysfs_path(), !sysfs_path.empty());
 
 	setChildValueIf(node, "active", active, !active);
 	setChildValueIf(node, "read-only", read_only, read_only);
@@ -176,8 +195,8 @@ namespace storage
 
 	setChildValue(node, "topology", topology);
 
-	setChildValueIf(node, "udev-path", udev_paths, !udev_paths.empty());
-	setChildValueIf(node, "udev-id", udev_ids, !udev_ids.empty());
+	setChildValueIf(node, "udev-path", *udev_paths, !udev_paths->empty());
+	setChildValueIf(node, "udev-id", *udev_ids, !udev_ids->empty());
 
 	setChildValueIf(node, "dm-table-name", dm_table_name, !dm_table_name.empty());
     }
@@ -199,13 +218,68 @@ namespace storage
     void
     BlkDevice::Impl::set_name(const string& name)
     {
+	about_to_modify();
+
+	Devicegraph::Impl::indices_lock_t lock = lock_indices();
+
+	remove_from_name_index();
 	Impl::name = name;
+	add_to_name_index();
+    }
+
+
+    void
+    BlkDevice::Impl::set_sysfs_path(const string& sysfs_path)
+    {
+	about_to_modify();
+
+	Devicegraph::Impl::indices_lock_t lock = lock_indices();
+
+	remove_from_name_index();
+	Impl::sysfs_path = sysfs_path;
+	add_to_name_index();
+    }
+
+
+    void
+    BlkDevice::Impl::set_udev_paths(const vector<string>& udev_paths)
+    {
+	about_to_modify();
+
+	Impl::udev_paths = udev_paths;
+    }
+
+
+    void
+    BlkDevice::Impl::set_udev_ids(const vector<string>& udev_ids)
+    {
+	about_to_modify();
+
+	Impl::udev_ids = udev_ids;
+    }
+
+
+    void
+    BlkDevice::Impl::remove_from_name_index()
+    {
+	if (has_devicegraph())
+	    get_devicegraph()->get_impl().remove_from_name_index(get_vertex());
+    }
+
+
+    void
+    BlkDevice::Impl::add_to_name_index()
+    {
+	if (has_devicegraph())
+	    get_devicegraph()->get_impl().add_to_name_index(get_vertex());
     }
 
 
     void
     BlkDevice::Impl::set_region(const Region& region)
     {
+	about_to_modify();
+
 	Impl::region = region;
 
 	for (Device* child : get_non_impl()->get_children())
@@ -223,6 +297,8 @@ namespace storage
     void
     BlkDevice::Impl::set_size(unsigned long long size)
     {
+	about_to_modify();
+
 	// Direct to virtual set_region so that derived classes can perform
 	// checks and that children can be informed.
 
@@ -252,10 +328,10 @@ namespace storage
     {
 	vector<MountByType> ret = { MountByType::DEVICE };
 
-	if (!udev_paths.empty())
+	if (!udev_paths->empty())
 	    ret.push_back(MountByType::PATH);
 
-	if (!udev_ids.empty())
+	if (!udev_ids->empty())
 	    ret.push_back(MountByType::ID);
 
 	return ret;
@@ -316,43 +392,64 @@ namespace storage
     }
 
 
-    bool
-    BlkDevice::Impl::exists_by_any_name(const Devicegraph* devicegraph, const string& name,
-					SystemInfo& system_info)
+    namespace
     {
-	if (!devicegraph->get_impl().is_system() && !devicegraph->get_impl().is_probed())
-	    ST_THROW(Exception("function called on wrong devicegraph"));
 
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	/**
+	 * Find the vertex of a block device by any name. First the name index
+	 * of the devicegraph is used. If that fails the name is resolved to a
+	 * sysfs path using udevadm. Udev links are always resolved by udevadm
+	 * since the udev ids and paths in the devicegraph can be outdated,
+	 * e.g. after a device was replaced.
+	 */
+	bool
+	find_vertex_by_any_name(const Devicegraph* devicegraph, const string& name,
+				SystemInfo& system_info, Devicegraph::Impl::vertex_descriptor& vertex)
 	{
-	    const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(devicegraph->get_impl()[vertex]);
-	    if (blk_device)
+	    const Devicegraph::Impl& devicegraph_impl = devicegraph->get_impl();
+
+	    if (!devicegraph_impl.is_system() && !devicegraph_impl.is_probed())
+		ST_THROW(Exception("function called on wrong devicegraph"));
+
+	    vector<Devicegraph::Impl::vertex_descriptor> tmp = devicegraph_impl.find_vertices_by_name(name);
+	    if (!tmp.empty())
 	    {
-		if (blk_device->get_name() == name)
-		    return true;
+		vertex = tmp.front();
+		return true;
 	    }
-	}
-
-	try
-	{
-	    string sysfs_path = system_info.getCmdUdevadmInfo(name).get_path();
 
-	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	    try
 	    {
-		const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(devicegraph->get_impl()[vertex]);
-		if (blk_device && blk_device->get_impl().active)
+		string sysfs_path = system_info.getCmdUdevadmInfo(name).get_path();
+
+		for (Devicegraph::Impl::vertex_descriptor tmp_vertex :
+			 devicegraph_impl.find_vertices_by_sysfs_path(sysfs_path))
 		{
-		    if (blk_device->get_sysfs_path() == sysfs_path)
+		    if (to_blk_device(devicegraph_impl[tmp_vertex])->is_active())
+		    {
+			vertex = tmp_vertex;
 			return true;
+		    }
 		}
 	    }
+	    catch (const Exception& exception)
+	    {
+		ST_CAUGHT(exception);
+	    }
+
+	    return false;
 	}
-	catch (const Exception& exception)
-	{
-	    ST_CAUGHT(exception);
-	}
 
-	return false;
+    }
+
+
+    bool
+    BlkDevice::Impl::exists_by_any_name(const Devicegraph* devicegraph, const string& name,
+					SystemInfo& system_info)
+    {
+	Devicegraph::Impl::vertex_descriptor vertex;
+
+	return find_vertex_by_any_name(devicegraph, name, system_info, vertex);
     }
 
 
@@ -360,39 +457,12 @@ namespace storage
     BlkDevice::Impl::find_by_any_name(Devicegraph* devicegraph, const string& name,
 				      SystemInfo& system_info)
     {
-	if (!devicegraph->get_impl().is_system() && !devicegraph->get_impl().is_probed())
-	    ST_THROW(Exception("function called on wrong devicegraph"));
+	Devicegraph::Impl::vertex_descriptor vertex;
 
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	{
-	    BlkDevice* blk_device = dynamic_cast<BlkDevice*>(devicegraph->get_impl()[vertex]);
-	    if (blk_device)
-	    {
-		if (blk_device->get_name() == name)
-		    return blk_device;
-	    }
-	}
-
-	try
-	{
-	    string sysfs_path = system_info.getCmdUdevadmInfo(name).get_path();
+	if (!find_vertex_by_any_name(devicegraph, name, system_info, vertex))
+	    ST_THROW(DeviceNotFoundByName(name));
 
-	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	    {
-		BlkDevice* blk_device = dynamic_cast<BlkDevice*>(devicegraph->get_impl()[vertex]);
-		if (blk_device && blk_device->get_impl().active)
-		{
-		    if (blk_device->get_sysfs_path() == sysfs_path)
-			return blk_device;
-		}
-	    }
-	}
-	catch (const Exception& exception)
-	{
-	    ST_CAUGHT(exception);
-	}
-
-	ST_THROW(DeviceNotFoundByName(name));
+	return to_blk_device(devicegraph->get_impl()[vertex]);
     }
 
 
@@ -400,39 +470,12 @@ namespace storage
     BlkDevice::Impl::find_by_any_name(const Devicegraph* devicegraph, const string& name,
 				      SystemInfo& system_info)
     {
-	if (!devicegraph->get_impl().is_system() && !devicegraph->get_impl().is_probed())
-	    ST_THROW(Exception("function called on wrong devicegraph"));
+	Devicegraph::Impl::vertex_descriptor vertex;
 
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	{
-	    const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(devicegraph->get_impl()[vertex]);
-	    if (blk_device)
-	    {
-		if (blk_device->get_name() == name)
-		    return blk_device;
-	    }
-	}
-
-	try
-	{
-	    string sysfs_path = system_info.getCmdUdevadmInfo(name).get_path();
+	if (!find_vertex_by_any_name(devicegraph, name, system_info, vertex))
+	    ST_THROW(DeviceNotFoundByName(name));
 
-	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
-	    {
-		const BlkDevice* blk_device = dynamic_cast<const BlkDevice*>(devicegraph->get_impl()[vertex]);
-		if (blk_device && blk_device->get_impl().active)
-		{
-		    if (blk_device->get_sysfs_path() == sysfs_path)
-			return blk_device;
-		}
-	    }
-	}
-	catch (const Exception& exception)
-	{
-	    ST_CAUGHT(exception);
-	}
-
-	ST_THROW(DeviceNotFoundByName(name));
+	return to_blk_device(devicegraph->get_impl()[vertex]);
     }
 
 
@@ -608,6 +651,26 @@ namespace storage
     }
 
 
+    size_t
+    BlkDevice::Impl::calculate_content_hash() const
+    {
+	size_t seed = Device::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, name);
+	boost::hash_combine(seed, sysfs_name);
+	boost::hash_combine(seed, sysfs_path);
+	boost::hash_combine(seed, region.get_impl());
+	boost::hash_combine(seed, topology.get_impl());
+	boost::hash_combine(seed, active);
+	boost::hash_combine(seed, read_only);
+	boost::hash_combine(seed, udev_paths);
+	boost::hash_combine(seed, udev_ids);
+	boost::hash_combine(seed, dm_table_name);
+
+	return seed;
+    }
+
+
     void
     BlkDevice::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -615,10 +678,10 @@ namespace storage
 
 	Device::Impl::log_diff(log, rhs);
 
-	storage::log_diff(log, "name", name, rhs.name);
+	storage::log_diff(log, "name", get_name(), rhs.get_name());
 
-	storage::log_diff(log, "sysfs-name", sysfs_name, rhs.sysfs_name);
-	storage::log_diff(log, "sysfs-path", sysfs_path, rhs.sysfs_path);
+	storage::log_diff(log, "sysfs-name", get_sysfs_name(), rhs.get_sysfs_name());
+	storage::log_diff(log, "sysfs-path", get_sysfs_path(), rhs.get_sysfs_path());
 
 	storage::log_diff(log, "active", active, rhs.active);
 	storage::log_diff(log, "read-only", read_only, rhs.read_only);
@@ -627,8 +690,8 @@ namespace storage
 
 	storage::log_diff(log, "topology", topology, rhs.topology);
 
-	storage::log_diff(log, "udev-paths", udev_paths, rhs.udev_paths);
-	storage::log_diff(log, "udev-ids", udev_ids, rhs.udev_ids);
+	storage::log_diff(log, "udev-paths", *udev_paths, *rhs.udev_paths);
+	storage::log_diff(log, "udev-ids", *udev_ids, *rhs.udev_ids);
 
 	storage::log_diff(log, "dm-table-name", dm_table_name, rhs.dm_table_name);
     }
@@ -656,11 +719,11 @@ namespace storage
 	out << " region:" << get_region()
 	    << " topology:" << topology;
 
-	if (!udev_paths.empty())
-	    out << " udev-paths:" << udev_paths;
+	if (!udev_paths->empty())
+	    out << " udev-paths:" << *udev_paths;
 
-	if (!udev_ids.empty())
-	    out << " udev-ids:" << udev_ids;
+	if (!udev_ids->empty())
+	    out << " udev-ids:" << *udev_ids;
 
 	if (!dm_table_name.empty())
 	    out << " dm-table-name:" << dm_table_name;
@@ -724,7 +787,8 @@ namespace storage
 
 	Devicegraph* devicegraph = get_devicegraph();
 
-	vector<Devicegraph::Impl::edge_descriptor> out_edges = devicegraph->get_impl().out_edges(get_vertex());
+	vector<Devicegraph::Impl::edge_descriptor> out_edges =
+	    boost::copy_range<vector<Devicegraph::Impl::edge_descriptor>>(devicegraph->get_impl().out_edges(get_vertex()));
 
 	Encryption* encryption = it->second(devicegraph, dm_name);
 	encryption->get_impl().Encryption::Impl::set_type(type);
@@ -750,13 +814,15 @@ namespace storage
     void
     BlkDevice::Impl::remove_encryption()
     {
+	about_to_modify();
+
 	Devicegraph* devicegraph = get_devicegraph();
 
 	Encryption* encryption = get_encryption();
 	Devicegraph::Impl::vertex_descriptor encryption_vertex = encryption->get_impl().get_vertex();
 
 	vector<Devicegraph::Impl::edge_descriptor> out_edges =
-	    devicegraph->get_impl().out_edges(encryption_vertex);
+	    boost::copy_range<vector<Devicegraph::Impl::edge_descriptor>>(devicegraph->get_impl().out_edges(encryption_vertex));
 
 	for (Devicegraph::Impl::edge_descriptor out_edge : out_edges)
 	{
@@ -796,7 +862,7 @@ namespace storage
 	// TODO reuse code with create_encryption
 
 	vector<Devicegraph::Impl::edge_descriptor> out_edges =
-	    devicegraph->get_impl().out_edges(get_vertex());
+	    boost::copy_range<vector<Devicegraph::Impl::edge_descriptor>>(devicegraph->get_impl().out_edges(get_vertex()));
 
 	Bcache* bcache = Bcache::create(devicegraph, name);
 	Devicegraph::Impl::vertex_descriptor bcache_vertex = bcache->get_impl().get_vertex();
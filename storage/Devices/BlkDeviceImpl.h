@@ -27,6 +27,7 @@
 
 #include "storage/Utils/Region.h"
 #include "storage/Utils/Topology.h"
+#include "storage/Utils/InternedString.h"
 #include "storage/Devices/BlkDevice.h"
 #include "storage/Devices/DeviceImpl.h"
 
@@ -41,7 +42,11 @@ namespace storage
     class File;
 
 
-    template <> struct DeviceTraits<BlkDevice> { static const char* classname; };
+    template <> struct DeviceTraits<BlkDevice>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::BLK_DEVICE;
+    };
 
 
     /**
@@ -55,6 +60,9 @@ namespace storage
     {
     public:
 
+	virtual device_types_t get_device_types() const override
+	    { return Device::Impl::get_device_types() | device_type_bit<BlkDevice>(); }
+
 	virtual string get_displayname() const override { return get_name(); }
 
 	virtual string get_name_sort_key() const override { return get_name(); }
@@ -63,14 +71,14 @@ namespace storage
 
 	virtual bool is_usable_as_blk_device() const { return active; }
 
-	const string& get_name() const { return name; }
+	const string& get_name() const { return name.get(); }
 	void set_name(const string& name);
 
-	const string& get_sysfs_name() const { return sysfs_name; }
-	void set_sysfs_name(const string& sysfs_name) { Impl::sysfs_name = sysfs_name; }
+	const string& get_sysfs_name() const { return sysfs_name.get(); }
+	void set_sysfs_name(const string& sysfs_name) { about_to_modify(); Impl::sysfs_name = sysfs_name; }
 
-	const string& get_sysfs_path() const { return sysfs_path; }
-	void set_sysfs_path(const string& sysfs_path) { Impl::sysfs_path = sysfs_path; }
+	const string& get_sysfs_path() const { return sysfs_path.get(); }
+	void set_sysfs_path(const string& sysfs_path);
 
 	const File& get_sysfs_file(SystemInfo& system_info, const char* filename) const;
 
@@ -83,7 +91,7 @@ namespace storage
 	virtual vector<MountByType> possible_mount_bys() const;
 
 	bool is_active() const { return active; }
-	void set_active(bool active) { Impl::active = active; }
+	void set_active(bool active) { about_to_modify(); Impl::active = active; }
 
 	bool is_read_only() const { return read_only; }
 
@@ -96,18 +104,18 @@ namespace storage
 	Text get_size_text() const;
 
 	const Topology& get_topology() const { return topology; }
-	void set_topology(const Topology& topology) { Impl::topology = topology; }
+	void set_topology(const Topology& topology) { about_to_modify(); Impl::topology = topology; }
 
-	const vector<string>& get_udev_paths() const { return udev_paths; }
-	void set_udev_paths(const vector<string>& udev_paths) { Impl::udev_paths = udev_paths; }
+	const vector<string>& get_udev_paths() const { return *udev_paths; }
+	void set_udev_paths(const vector<string>& udev_paths);
 
-	const vector<string>& get_udev_ids() const { return udev_ids; }
-	void set_udev_ids(const vector<string>& udev_ids) { Impl::udev_ids = udev_ids; }
+	const vector<string>& get_udev_ids() const { return *udev_ids; }
+	void set_udev_ids(const vector<string>& udev_ids);
 
 	string get_mount_by_name(MountByType mount_by_type) const;
 
 	const string& get_dm_table_name() const { return dm_table_name; }
-	virtual void set_dm_table_name(const string& dm_table_name) { Impl::dm_table_name = dm_table_name; }
+	virtual void set_dm_table_name(const string& dm_table_name) { about_to_modify(); Impl::dm_table_name = dm_table_name; }
 
 	BlkFilesystem* create_blk_filesystem(FsType fs_type);
 
@@ -174,6 +182,7 @@ namespace storage
 	virtual void add_modify_actions(Actiongraph::Impl& actiongraph, const Device* lhs) const override;
 
 	virtual bool equal(const Device::Impl& rhs) const override = 0;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override = 0;
 	virtual void print(std::ostream& out) const override = 0;
 
@@ -197,10 +206,18 @@ namespace storage
 
     private:
 
-	string name;
+	/**
+	 * Remove the block device from or add it to the name index of the
+	 * devicegraph. Must be called before and after changing the name or
+	 * sysfs path.
+	 */
+	void remove_from_name_index();
+	void add_to_name_index();
+
+	InternedString name;
 
-	string sysfs_name;
-	string sysfs_path;
+	InternedString sysfs_name;
+	InternedString sysfs_path;
 
 	/**
 	 * Some blk devices can be inactive, e.g. MDs, LVM LVs or LUKSes.
@@ -225,8 +242,8 @@ namespace storage
 	 */
 	Topology topology;
 
-	vector<string> udev_paths;
-	vector<string> udev_ids;
+	CopyOnWrite<vector<string>> udev_paths;
+	CopyOnWrite<vector<string>> udev_ids;
 
 	string dm_table_name;
 
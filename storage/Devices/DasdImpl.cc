@@ -21,6 +21,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Devices/DasdImpl.h"
 #include "storage/Devicegraph.h"
 #include "storage/Storage.h"
@@ -197,6 +199,8 @@ namespace storage
     void
     Dasd::Impl::probe_pass_1a(Prober& prober)
     {
+	about_to_modify();
+
 	Partitionable::Impl::probe_pass_1a(prober);
 
 	SystemInfo& system_info = prober.get_system_info();
@@ -269,6 +273,20 @@ namespace storage
     }
 
 
+    size_t
+    Dasd::Impl::calculate_content_hash() const
+    {
+	size_t seed = Partitionable::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, bus_id);
+	boost::hash_combine(seed, rotational);
+	boost::hash_combine(seed, type);
+	boost::hash_combine(seed, format);
+
+	return seed;
+    }
+
+
     void
     Dasd::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
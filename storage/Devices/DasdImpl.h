@@ -36,7 +36,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Dasd> { static const char* classname; };
+    template <> struct DeviceTraits<Dasd>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::DASD;
+    };
 
     template <> struct EnumTraits<DasdType> { static const vector<string> names; };
     template <> struct EnumTraits<DasdFormat> { static const vector<string> names; };
@@ -54,6 +58,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Dasd>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Partitionable::Impl::get_device_types() | device_type_bit<Dasd>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_name_sort_key() const override;
@@ -67,16 +74,16 @@ namespace storage
 	virtual void check(const CheckCallbacks* check_callbacks) const override;
 
 	string get_bus_id() const { return bus_id; }
-	void set_bus_id(string bus_id) { Impl::bus_id = bus_id; }
+	void set_bus_id(string bus_id) { about_to_modify(); Impl::bus_id = bus_id; }
 
 	bool is_rotational() const { return rotational; }
-	void set_rotational(bool rotational) { Impl::rotational = rotational; }
+	void set_rotational(bool rotational) { about_to_modify(); Impl::rotational = rotational; }
 
 	DasdType get_type() const { return type; }
-	void set_type(DasdType type) { Impl::type = type; }
+	void set_type(DasdType type) { about_to_modify(); Impl::type = type; }
 
 	DasdFormat get_format() const { return format; }
-	void set_format(DasdFormat format) { Impl::format = format; }
+	void set_format(DasdFormat format) { about_to_modify(); Impl::format = format; }
 
 	virtual bool is_usable_as_blk_device() const override { return false; }
 
@@ -90,6 +97,7 @@ namespace storage
 	virtual uf_t used_features(UsedFeaturesDependencyType used_features_dependency_type) const override;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
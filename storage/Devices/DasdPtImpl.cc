@@ -61,6 +61,8 @@ namespace storage
     void
     DasdPt::Impl::probe_pass_1c(Prober& prober)
     {
+	about_to_modify();
+
 	PartitionTable::Impl::probe_pass_1c(prober);
     }
 
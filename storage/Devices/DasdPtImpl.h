@@ -35,7 +35,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<DasdPt> { static const char* classname; };
+    template <> struct DeviceTraits<DasdPt>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::DASD_PT;
+    };
 
 
     class DasdPt::Impl : public PartitionTable::Impl
@@ -49,6 +53,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<DasdPt>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return PartitionTable::Impl::get_device_types() | device_type_bit<DasdPt>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "DasdPt"; }
@@ -53,6 +53,16 @@ namespace storage
     }
 
 
+    void
+    Device::swap_impl(Device& device)
+    {
+	if (typeid(*impl) != typeid(*device.impl))
+	    ST_THROW(LogicException("swapping impl of different classes"));
+
+	impl.swap(device.impl);
+    }
+
+
     string
     Device::get_displayname() const
     {
@@ -447,6 +457,27 @@ namespace storage
     }
 
 
+    bool
+    Device::has_userdata(const string& key) const
+    {
+	return get_impl().has_userdata(key);
+    }
+
+
+    const string&
+    Device::get_userdata(const string& key) const
+    {
+	return get_impl().get_userdata(key);
+    }
+
+
+    void
+    Device::set_userdata(const string& key, const string& value)
+    {
+	get_impl().set_userdata(key, value);
+    }
+
+
     bool
     Device::compare_by_sid(const Device* lhs, const Device* rhs)
     {
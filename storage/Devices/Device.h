@@ -231,6 +231,25 @@ namespace storage
 	 */
 	void set_userdata(const std::map<std::string, std::string>& userdata);
 
+	/**
+	 * Check whether the userdata of the device has an entry for key.
+	 */
+	bool has_userdata(const std::string& key) const;
+
+	/**
+	 * Return the value of the userdata entry for key. Unlike get_userdata()
+	 * this does not require the caller to handle the whole map.
+	 *
+	 * @throw Exception
+	 */
+	const std::string& get_userdata(const std::string& key) const;
+
+	/**
+	 * Set the userdata entry for key, keeping all other entries. The
+	 * userdata is only copied if it is shared with a copy of the device.
+	 */
+	void set_userdata(const std::string& key, const std::string& value);
+
 	friend std::ostream& operator<<(std::ostream& out, const Device& device);
 
 	/**
@@ -289,6 +308,12 @@ namespace storage
 	Impl& get_impl() { return *impl; }
 	const Impl& get_impl() const { return *impl; }
 
+	/**
+	 * Swaps the Impl with the Impl of another device of the same
+	 * class. Used to restore the device when rolling back a checkpoint.
+	 */
+	void swap_impl(Device& device);
+
 	virtual Device* clone() const = 0;
 
 	void save(xmlNode* node) const ST_DEPRECATED;
@@ -310,7 +335,7 @@ namespace storage
 
 	void add_to_devicegraph(Devicegraph* devicegraph);
 
-	const std::unique_ptr<Impl> impl;
+	std::unique_ptr<Impl> impl;
 
     };
 
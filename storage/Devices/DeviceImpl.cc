@@ -21,6 +21,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Devices/DeviceImpl.h"
 #include "storage/Devices/BlkDevice.h"
 #include "storage/Devicegraph.h"
@@ -176,6 +178,55 @@ namespace storage
     }
 
 
+    void
+    Device::Impl::remove_from_uuid_index()
+    {
+	if (has_devicegraph())
+	    get_devicegraph()->get_impl().remove_from_uuid_index(get_vertex());
+    }
+
+
+    void
+    Device::Impl::add_to_uuid_index()
+    {
+	if (has_devicegraph())
+	    get_devicegraph()->get_impl().add_to_uuid_index(get_vertex());
+    }
+
+
+    Devicegraph::Impl::indices_lock_t
+    Device::Impl::lock_indices() const
+    {
+	if (!has_devicegraph())
+	    return Devicegraph::Impl::indices_lock_t();
+
+	return get_devicegraph()->get_impl().lock_indices();
+    }
+
+
+    void
+    Device::Impl::about_to_modify()
+    {
+	if (has_devicegraph())
+	    get_devicegraph()->get_impl().record_change(get_non_impl());
+
+	content_hash_valid = false;
+    }
+
+
+    size_t
+    Device::Impl::get_content_hash() const
+    {
+	if (!content_hash_valid)
+	{
+	    content_hash = calculate_content_hash();
+	    content_hash_valid = true;
+	}
+
+	return content_hash;
+    }
+
+
     Devicegraph*
     Device::Impl::get_devicegraph()
     {
@@ -209,7 +260,7 @@ namespace storage
     bool
     Device::Impl::has_children(View view) const
     {
-	return devicegraph->get_impl().num_children(vertex, view) > 0;
+	return !devicegraph->get_impl().children(vertex, view).empty();
     }
 
 
@@ -223,7 +274,7 @@ namespace storage
     bool
     Device::Impl::has_parents(View view) const
     {
-	return devicegraph->get_impl().num_parents(vertex, view) > 0;
+	return !devicegraph->get_impl().parents(vertex, view).empty();
     }
 
 
@@ -237,6 +288,8 @@ namespace storage
     void
     Device::Impl::remove_descendants(View view)
     {
+	about_to_modify();
+
 	Devicegraph::Impl& devicegraph_impl = devicegraph->get_impl();
 
 	for (Devicegraph::Impl::vertex_descriptor descendant : devicegraph_impl.descendants(vertex, false, view))
@@ -244,6 +297,30 @@ namespace storage
     }
 
 
+    const string&
+    Device::Impl::get_userdata(const string& key) const
+    {
+	map<string, string>::const_iterator it = userdata->find(key);
+	if (it == userdata->end())
+	    ST_THROW(Exception(sformat("userdata key '%s' not found, sid:%d", key, sid)));
+
+	return it->second;
+    }
+
+
+    void
+    Device::Impl::set_userdata(const string& key, const string& value)
+    {
+	about_to_modify();
+
+	map<string, string>::const_iterator it = userdata->find(key);
+	if (it != userdata->end() && it->second == value)
+	    return;
+
+	userdata.get_for_write()[key] = value;
+    }
+
+
     void
     Device::Impl::parent_has_new_region(const Device* parent)
     {
@@ -319,12 +396,25 @@ namespace storage
     }
 
 
+    size_t
+    Device::Impl::calculate_content_hash() const
+    {
+	size_t seed = 0;
+
+	boost::hash_combine(seed, string(get_classname()));
+	boost::hash_combine(seed, sid);
+	boost::hash_combine(seed, userdata);
+
+	return seed;
+    }
+
+
     void
     Device::Impl::log_diff(std::ostream& log, const Impl& rhs) const
     {
 	storage::log_diff(log, "sid", sid, rhs.sid);
 
-	storage::log_diff(log, "userdata", userdata, rhs.userdata);
+	storage::log_diff(log, "userdata", *userdata, *rhs.userdata);
     }
 
 
@@ -334,8 +424,8 @@ namespace storage
 	out << get_classname() << " sid:" << get_sid()
 	    << " displayname:" << get_displayname();
 
-	if (!userdata.empty())
-	    out << " userdata:" << userdata;
+	if (!userdata->empty())
+	    out << " userdata:" << *userdata;
     }
 
 
@@ -30,6 +30,7 @@
 
 #include "storage/Utils/AppUtil.h"
 #include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/CopyOnWrite.h"
 #include "storage/Devices/Device.h"
 #include "storage/Holders/HolderImpl.h"
 #include "storage/Devicegraph.h"
@@ -55,7 +56,22 @@ namespace storage
 
     template <typename Type> struct DeviceTraits {};
 
-    template <> struct DeviceTraits<Device> { static const char* classname; };
+    template <> struct DeviceTraits<Device>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::DEVICE;
+    };
+
+
+    /**
+     * Bit of the device type of Type in device_types_t.
+     */
+    template <typename Type>
+    device_types_t
+    device_type_bit()
+    {
+	return device_types_t(1) << (unsigned int)(DeviceTraits<Type>::device_type);
+    }
 
 
     template <typename Type> bool is_device_of_type(const Device* device);
@@ -95,6 +111,13 @@ namespace storage
 
 	virtual const char* get_classname() const = 0;
 
+	/**
+	 * The device types of the device, so the type of the class and of all
+	 * its base classes. Used for the type buckets of the devicegraph. Each
+	 * class must override this.
+	 */
+	virtual device_types_t get_device_types() const { return device_type_bit<Device>(); }
+
 	virtual string get_pretty_classname() const = 0;
 
 	virtual string get_displayname() const = 0;
@@ -103,8 +126,23 @@ namespace storage
 
 	virtual bool is_in_view(View view) const { return true; }
 
+	/**
+	 * The UUID under which the device is found in the uuid index of the
+	 * devicegraph. Empty for devices without UUID. Classes overriding
+	 * this must call remove_from_uuid_index() and add_to_uuid_index()
+	 * when changing the UUID.
+	 */
+	virtual string get_indexed_uuid() const { return ""; }
+
 	virtual void save(xmlNode* node) const = 0;
 
+	/**
+	 * Hash of everything compared by equal(). Devices with different
+	 * content hashes are not equal. Calculated when needed and cached
+	 * until the next about_to_modify().
+	 */
+	size_t get_content_hash() const;
+
 	virtual void check(const CheckCallbacks* check_callbacks) const;
 
 	bool operator==(const Impl& rhs) const;
@@ -121,11 +159,13 @@ namespace storage
 	const Storage* get_storage() const;
 
 	sid_t get_sid() const { return sid; }
-	void set_sid(sid_t sid) { Impl::sid = sid; }
+	void set_sid(sid_t sid) { about_to_modify(); Impl::sid = sid; }
 
 	void set_devicegraph_and_vertex(Devicegraph* devicegraph,
 					Devicegraph::Impl::vertex_descriptor vertex);
 
+	bool has_devicegraph() const { return devicegraph; }
+
 	Devicegraph* get_devicegraph();
 	const Devicegraph* get_devicegraph() const;
 
@@ -136,8 +176,12 @@ namespace storage
 
 	void remove_descendants(View view = View::CLASSIC);
 
-	const map<string, string>& get_userdata() const { return userdata; }
-	void set_userdata(const map<string, string>& userdata) { Impl::userdata = userdata; }
+	const map<string, string>& get_userdata() const { return *userdata; }
+	void set_userdata(const map<string, string>& userdata) { about_to_modify(); Impl::userdata = userdata; }
+
+	bool has_userdata(const string& key) const { return userdata->count(key) > 0; }
+	const string& get_userdata(const string& key) const;
+	void set_userdata(const string& key, const string& value);
 
 	virtual void probe_pass_1a(Prober& prober);
 	virtual void probe_pass_1b(Prober& prober);
@@ -175,6 +219,13 @@ namespace storage
 	virtual void add_dependencies(Actiongraph::Impl& actiongraph) const {}
 
 	virtual bool equal(const Impl& rhs) const = 0;
+
+	/**
+	 * Calculates the content hash from the same attributes equal()
+	 * compares. Classes extending equal() must also extend this.
+	 */
+	virtual size_t calculate_content_hash() const;
+
 	virtual void log_diff(std::ostream& log, const Impl& rhs) const = 0;
 	virtual void print(std::ostream& out) const = 0;
 
@@ -256,7 +307,15 @@ namespace storage
 
 	    const Devicegraph::Impl& devicegraph_impl = get_devicegraph()->get_impl();
 
-	    return devicegraph_impl.filter_devices_of_type<Type>(devicegraph_impl.children(get_vertex(), view)).size();
+	    size_t ret = 0;
+
+	    for (Devicegraph::Impl::vertex_descriptor child : devicegraph_impl.children(get_vertex(), view))
+	    {
+		if (is_device_of_type<Type>(devicegraph_impl[child]))
+		    ++ret;
+	    }
+
+	    return ret;
 	}
 
 	template<typename Type>
@@ -410,6 +469,27 @@ namespace storage
 
 	Impl(const xmlNode* node);
 
+	/**
+	 * Remove the device from or add it to the uuid index of the
+	 * devicegraph. Must be called before and after changing the UUID.
+	 */
+	void remove_from_uuid_index();
+	void add_to_uuid_index();
+
+	/**
+	 * Locks the indices of the devicegraph, see
+	 * Devicegraph::Impl::lock_indices(). Must be held while changing the
+	 * name, sysfs path, udev links or UUID.
+	 */
+	Devicegraph::Impl::indices_lock_t lock_indices() const;
+
+	/**
+	 * Must be called by all functions modifying the device before the
+	 * modification, see Devicegraph::Impl::record_change(). Also
+	 * invalidates the content hash.
+	 */
+	void about_to_modify();
+
     private:
 
 	/**
@@ -425,7 +505,12 @@ namespace storage
 	Devicegraph* devicegraph = nullptr;
 	Devicegraph::Impl::vertex_descriptor vertex;
 
-	map<string, string> userdata;
+	CopyOnWrite<map<string, string>> userdata;
+
+	// Cache for get_content_hash(). Copies of the device share the
+	// content so they also keep the hash.
+	mutable size_t content_hash = 0;
+	mutable bool content_hash_valid = false;
 
     };
 
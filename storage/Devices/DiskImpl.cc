@@ -22,6 +22,7 @@
 
 
 #include <ctype.h>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Devices/DiskImpl.h"
 #include "storage/Devicegraph.h"
@@ -163,6 +164,8 @@ namespace storage
     void
     Disk::Impl::probe_pass_1a(Prober& prober)
     {
+	about_to_modify();
+
 	Partitionable::Impl::probe_pass_1a(prober);
 
 	SystemInfo& system_info = prober.get_system_info();
@@ -263,6 +266,20 @@ namespace storage
     }
 
 
+    size_t
+    Disk::Impl::calculate_content_hash() const
+    {
+	size_t seed = Partitionable::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, rotational);
+	boost::hash_combine(seed, dax);
+	boost::hash_combine(seed, transport);
+	boost::hash_combine(seed, zone_model);
+
+	return seed;
+    }
+
+
     void
     Disk::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -36,7 +36,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Disk> { static const char* classname; };
+    template <> struct DeviceTraits<Disk>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::DISK;
+    };
 
     template <> struct EnumTraits<Transport> { static const vector<string> names; };
 
@@ -57,6 +61,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Disk>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Partitionable::Impl::get_device_types() | device_type_bit<Disk>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_name_sort_key() const override;
@@ -71,16 +78,16 @@ namespace storage
 	virtual ResizeInfo detect_resize_info(const BlkDevice* blk_device = nullptr) const override;
 
 	bool is_rotational() const { return rotational; }
-	void set_rotational(bool rotational) { Impl::rotational = rotational; }
+	void set_rotational(bool rotational) { about_to_modify(); Impl::rotational = rotational; }
 
 	bool is_dax() const { return dax; }
-	void set_dax(bool dax) { Impl::dax = dax; }
+	void set_dax(bool dax) { about_to_modify(); Impl::dax = dax; }
 
 	Transport get_transport() const { return transport; }
-	void set_transport(Transport transport) { Impl::transport = transport; }
+	void set_transport(Transport transport) { about_to_modify(); Impl::transport = transport; }
 
 	ZoneModel get_zone_model() const { return zone_model; }
-	void set_zone_model(ZoneModel zone_model) { Impl::zone_model = zone_model; }
+	void set_zone_model(ZoneModel zone_model) { about_to_modify(); Impl::zone_model = zone_model; }
 
 	bool is_pmem() const;
 	bool is_nvme() const;
@@ -94,6 +101,7 @@ namespace storage
 	virtual void add_delete_actions(Actiongraph::Impl& actiongraph) const override;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
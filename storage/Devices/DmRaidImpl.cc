@@ -20,6 +20,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Devices/DmRaidImpl.h"
 #include "storage/Devicegraph.h"
 #include "storage/Storage.h"
@@ -155,6 +157,8 @@ namespace storage
     void
     DmRaid::Impl::probe_pass_1a(Prober& prober)
     {
+	about_to_modify();
+
 	Partitionable::Impl::probe_pass_1a(prober);
 
 	SystemInfo& system_info = prober.get_system_info();
@@ -167,6 +171,8 @@ namespace storage
     void
     DmRaid::Impl::probe_pass_1b(Prober& prober)
     {
+	about_to_modify();
+
 	const CmdDmraid& cmd_dmraid = prober.get_system_info().getCmdDmraid();
 
 	const CmdDmraid::Entry& entry = cmd_dmraid.get_entry(get_dm_table_name());
@@ -229,6 +235,17 @@ namespace storage
     }
 
 
+    size_t
+    DmRaid::Impl::calculate_content_hash() const
+    {
+	size_t seed = Partitionable::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, rotational);
+
+	return seed;
+    }
+
+
     void
     DmRaid::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
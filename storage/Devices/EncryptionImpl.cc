@@ -20,6 +20,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/HumanString.h"
@@ -100,6 +102,8 @@ namespace storage
     void
     Encryption::Impl::probe_pass_1a(Prober& prober)
     {
+	about_to_modify();
+
 	BlkDevice::Impl::probe_pass_1a(prober);
 
 	if (is_active())
@@ -131,6 +135,8 @@ namespace storage
     void
     Encryption::Impl::set_default_mount_by()
     {
+	about_to_modify();
+
 	set_mount_by(get_storage()->get_default_mount_by());
     }
 
@@ -138,6 +144,8 @@ namespace storage
     void
     Encryption::Impl::set_dm_table_name(const string& dm_table_name)
     {
+	about_to_modify();
+
 	BlkDevice::Impl::set_dm_table_name(dm_table_name);
 	BlkDevice::Impl::set_name(DEV_MAPPER_DIR "/" + dm_table_name);
     }
@@ -146,6 +154,8 @@ namespace storage
     void
     Encryption::Impl::set_crypt_options(const CryptOpts& crypt_options)
     {
+	about_to_modify();
+
 	Impl::crypt_options = crypt_options;
     }
 
@@ -153,6 +163,8 @@ namespace storage
     void
     Encryption::Impl::set_crypt_options(const vector<string>& crypt_options)
     {
+	about_to_modify();
+
 	Impl::crypt_options.set_opts(crypt_options);
     }
 
@@ -328,6 +340,25 @@ namespace storage
     }
 
 
+    size_t
+    Encryption::Impl::calculate_content_hash() const
+    {
+	size_t seed = BlkDevice::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, type);
+	boost::hash_combine(seed, password);
+	boost::hash_combine(seed, key_file);
+	boost::hash_combine(seed, cipher);
+	boost::hash_combine(seed, key_size);
+	boost::hash_combine(seed, mount_by);
+	boost::hash_range(seed, crypt_options.begin(), crypt_options.end());
+	boost::hash_combine(seed, in_etc_crypttab);
+	boost::hash_combine(seed, open_options);
+
+	return seed;
+    }
+
+
     void
     Encryption::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -552,7 +583,7 @@ namespace storage
     void
     Encryption::Impl::do_add_to_etc_crypttab(CommitData& commit_data) const
     {
-	EtcCrypttab& etc_crypttab = commit_data.get_etc_crypttab();
+	CommitData::Locked<EtcCrypttab> etc_crypttab = commit_data.get_etc_crypttab();
 
 	CrypttabEntry* entry = new CrypttabEntry();
 	entry->set_crypt_device(get_dm_table_name());
@@ -561,9 +592,9 @@ namespace storage
 	    entry->set_password(get_key_file());
 	entry->set_crypt_opts(get_crypt_options());
 
-	etc_crypttab.add(entry);
-	etc_crypttab.log();
-	etc_crypttab.write();
+	etc_crypttab->add(entry);
+	etc_crypttab->log();
+	etc_crypttab->write();
     }
 
 
@@ -591,14 +622,14 @@ namespace storage
     void
     Encryption::Impl::do_rename_in_etc_crypttab(CommitData& commit_data) const
     {
-	EtcCrypttab& etc_crypttab = commit_data.get_etc_crypttab();
+	CommitData::Locked<EtcCrypttab> etc_crypttab = commit_data.get_etc_crypttab();
 
-	CrypttabEntry* entry = etc_crypttab.find_block_device(get_crypttab_blk_device_name());
+	CrypttabEntry* entry = etc_crypttab->find_block_device(get_crypttab_blk_device_name());
 	if (entry)
 	{
 	    entry->set_block_device(get_mount_by_name(get_mount_by()));
-	    etc_crypttab.log();
-	    etc_crypttab.write();
+	    etc_crypttab->log();
+	    etc_crypttab->write();
 	}
     }
 
@@ -621,14 +652,14 @@ namespace storage
     void
     Encryption::Impl::do_remove_from_etc_crypttab(CommitData& commit_data) const
     {
-	EtcCrypttab& etc_crypttab = commit_data.get_etc_crypttab();
+	CommitData::Locked<EtcCrypttab> etc_crypttab = commit_data.get_etc_crypttab();
 
-	CrypttabEntry* entry = etc_crypttab.find_block_device(get_crypttab_blk_device_name());
+	CrypttabEntry* entry = etc_crypttab->find_block_device(get_crypttab_blk_device_name());
 	if (entry)
 	{
-	    etc_crypttab.remove(entry);
-	    etc_crypttab.log();
-	    etc_crypttab.write();
+	    etc_crypttab->remove(entry);
+	    etc_crypttab->log();
+	    etc_crypttab->write();
 	}
     }
 
@@ -38,7 +38,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Encryption> { static const char* classname; };
+    template <> struct DeviceTraits<Encryption>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::ENCRYPTION;
+    };
 
     template <> struct EnumTraits<EncryptionType> { static const vector<string> names; };
 
@@ -52,6 +56,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return "Encryption"; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkDevice::Impl::get_device_types() | device_type_bit<Encryption>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return get_dm_table_name(); }
@@ -66,25 +73,25 @@ namespace storage
 	virtual void set_dm_table_name(const string& dm_table_name) override;
 
 	EncryptionType get_type() const { return type; }
-	virtual void set_type(EncryptionType type) { Impl::type = type; }
+	virtual void set_type(EncryptionType type) { about_to_modify(); Impl::type = type; }
 
 	const string& get_password() const { return password; }
-	void set_password(const string& password) { Impl::password = password; }
+	void set_password(const string& password) { about_to_modify(); Impl::password = password; }
 
 	const string& get_key_file() const { return key_file; }
-	void set_key_file(const string& key_file) { Impl::key_file = key_file; }
+	void set_key_file(const string& key_file) { about_to_modify(); Impl::key_file = key_file; }
 
 	const string& get_open_options() const { return open_options; }
-	void set_open_options(const string& open_options) { Impl::open_options = open_options; }
+	void set_open_options(const string& open_options) { about_to_modify(); Impl::open_options = open_options; }
 
 	const string& get_cipher() const { return cipher; }
-	void set_cipher(const string& cipher) { Impl::cipher = cipher; }
+	void set_cipher(const string& cipher) { about_to_modify(); Impl::cipher = cipher; }
 
 	unsigned int get_key_size() const { return key_size; }
-	void set_key_size(unsigned int key_size) { Impl::key_size = key_size; }
+	void set_key_size(unsigned int key_size) { about_to_modify(); Impl::key_size = key_size; }
 
 	MountByType get_mount_by() const { return mount_by; }
-	void set_mount_by(MountByType mount_by) { Impl::mount_by = mount_by; }
+	void set_mount_by(MountByType mount_by) { about_to_modify(); Impl::mount_by = mount_by; }
 
 	void set_default_mount_by();
 
@@ -95,14 +102,14 @@ namespace storage
 	void set_crypt_options(const vector<string>& crypt_options);
 
 	bool is_in_etc_crypttab() const { return in_etc_crypttab; }
-	void set_in_etc_crypttab(bool in_etc_crypttab) { Impl::in_etc_crypttab = in_etc_crypttab; }
+	void set_in_etc_crypttab(bool in_etc_crypttab) { about_to_modify(); Impl::in_etc_crypttab = in_etc_crypttab; }
 
 	/**
 	 * Get the block device name that was used in /etc/crypttab. This is
 	 * empty if this encryption was not in /etc/crypttab during probing.
 	 */
         const string& get_crypttab_blk_device_name() const { return crypttab_blk_device_name; }
-        void set_crypttab_blk_device_name(const string& name) { Impl::crypttab_blk_device_name = name; }
+        void set_crypttab_blk_device_name(const string& name) { about_to_modify(); Impl::crypttab_blk_device_name = name; }
 
 	const BlkDevice* get_blk_device() const;
 
@@ -122,6 +129,7 @@ namespace storage
 	virtual void add_delete_actions(Actiongraph::Impl& actiongraph) const override;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
@@ -21,6 +21,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Utils/HumanString.h"
 #include "storage/Devices/GptImpl.h"
 #include "storage/Devices/Partitionable.h"
@@ -70,6 +72,8 @@ namespace storage
     void
     Gpt::Impl::probe_pass_1c(Prober& prober)
     {
+	about_to_modify();
+
 	PartitionTable::Impl::probe_pass_1c(prober);
 
 	const Partitionable* partitionable = get_partitionable();
@@ -165,6 +169,20 @@ namespace storage
     }
 
 
+    size_t
+    Gpt::Impl::calculate_content_hash() const
+    {
+	size_t seed = PartitionTable::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, partition_slots);
+	boost::hash_combine(seed, undersized);
+	boost::hash_combine(seed, backup_broken);
+	boost::hash_combine(seed, pmbr_boot);
+
+	return seed;
+    }
+
+
     void
     Gpt::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
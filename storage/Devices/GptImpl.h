@@ -35,7 +35,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Gpt> { static const char* classname; };
+    template <> struct DeviceTraits<Gpt>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::GPT;
+    };
 
 
     class Gpt::Impl : public PartitionTable::Impl
@@ -50,6 +54,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Gpt>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return PartitionTable::Impl::get_device_types() | device_type_bit<Gpt>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "gpt"; }
@@ -66,6 +73,7 @@ namespace storage
 	virtual void add_modify_actions(Actiongraph::Impl& actiongraph, const Device* lhs_base) const override;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
@@ -76,12 +84,12 @@ namespace storage
 	virtual unsigned int max_primary() const override;
 
 	bool is_undersized() const { return undersized; }
-	void set_undersized(bool undersized) { Impl::undersized = undersized; }
+	void set_undersized(bool undersized) { about_to_modify(); Impl::undersized = undersized; }
 
 	bool is_backup_broken() const { return backup_broken; }
 
 	bool is_pmbr_boot() const { return pmbr_boot; }
-	void set_pmbr_boot(bool pmbr_boot) { Impl::pmbr_boot = pmbr_boot; }
+	void set_pmbr_boot(bool pmbr_boot) { about_to_modify(); Impl::pmbr_boot = pmbr_boot; }
 
 	virtual pair<unsigned long long, unsigned long long> unusable_sectors() const override;
 
@@ -68,6 +68,8 @@ namespace storage
     void
     ImplicitPt::Impl::probe_pass_1c(Prober& prober)
     {
+	about_to_modify();
+
 	// TODO Maybe check that the implicit partition already created really
 	// matches the one reported by parted.
     }
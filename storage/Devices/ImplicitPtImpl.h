@@ -35,7 +35,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<ImplicitPt> { static const char* classname; };
+    template <> struct DeviceTraits<ImplicitPt>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::IMPLICIT_PT;
+    };
 
 
     class ImplicitPt::Impl : public PartitionTable::Impl
@@ -49,6 +53,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<ImplicitPt>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return PartitionTable::Impl::get_device_types() | device_type_bit<ImplicitPt>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "ImplicitPt"; }
@@ -21,6 +21,7 @@
 
 
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/SystemCmd.h"
@@ -63,6 +64,19 @@ namespace storage
     }
 
 
+    void
+    Luks::Impl::set_uuid(const string& uuid)
+    {
+	about_to_modify();
+
+	Devicegraph::Impl::indices_lock_t lock = lock_indices();
+
+	remove_from_uuid_index();
+	Impl::uuid = uuid;
+	add_to_uuid_index();
+    }
+
+
     void
     Luks::Impl::save(xmlNode* node) const
     {
@@ -88,6 +102,8 @@ namespace storage
     void
     Luks::Impl::set_type(EncryptionType type)
     {
+	about_to_modify();
+
 	Encryption::Impl::set_type(type);
 
 	// Since the metadata size depends on the type a recalculation
@@ -394,7 +410,7 @@ namespace storage
 		dm_table_name = next_free_cr_auto_name(system_info);
 
 	    Luks* luks = Luks::create(prober.get_system(), dm_table_name);
-	    luks->get_impl().uuid = uuid;
+	    luks->get_impl().set_uuid(uuid);
 	    luks->get_impl().label = label;
 	    luks->get_impl().set_active(it2 != cmd_dmsetup_table.end());
 	    luks->set_in_etc_crypttab(crypttab_entry);
@@ -434,18 +450,22 @@ namespace storage
     void
     Luks::Impl::probe_uuid()
     {
+	about_to_modify();
+
 	const BlkDevice* blk_device = get_blk_device();
 
 	const Blkid& blkid(blk_device->get_name());
 	Blkid::const_iterator it = blkid.get_sole_entry();
 	if (it != blkid.end())
-	    uuid = it->second.luks_uuid;
+	    set_uuid(it->second.luks_uuid);
     }
 
 
     void
     Luks::Impl::parent_has_new_region(const Device* parent)
     {
+	about_to_modify();
+
 	calculate_region_and_topology();
     }
 
@@ -470,6 +490,8 @@ namespace storage
     void
     Luks::Impl::calculate_region_and_topology()
     {
+	about_to_modify();
+
 	const BlkDevice* blk_device = get_blk_device();
 
 	unsigned long long size = blk_device->get_size();
@@ -505,6 +527,19 @@ namespace storage
     }
 
 
+    size_t
+    Luks::Impl::calculate_content_hash() const
+    {
+	size_t seed = Encryption::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, uuid);
+	boost::hash_combine(seed, label);
+	boost::hash_combine(seed, format_options);
+
+	return seed;
+    }
+
+
     void
     Luks::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -39,7 +39,11 @@ namespace storage
     class ActivateCallbacks;
 
 
-    template <> struct DeviceTraits<Luks> { static const char* classname; };
+    template <> struct DeviceTraits<Luks>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::LUKS;
+    };
 
 
     class Luks::Impl : public Encryption::Impl
@@ -53,6 +57,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return "Luks"; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Encryption::Impl::get_device_types() | device_type_bit<Luks>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	static bool activate_luks(const ActivateCallbacks* activate_callbacks,
@@ -76,18 +83,22 @@ namespace storage
 	virtual string get_mount_by_name(MountByType mount_by_type) const override;
 
 	const string& get_uuid() const { return uuid; }
+	void set_uuid(const string& uuid);
+
+	virtual string get_indexed_uuid() const override { return uuid; }
 
 	const string& get_label() const { return label; }
-	void set_label(const string& label) { Impl::label = label; }
+	void set_label(const string& label) { about_to_modify(); Impl::label = label; }
 
 	const string& get_format_options() const { return format_options; }
-	void set_format_options(const string& format_options) { Impl::format_options = format_options; }
+	void set_format_options(const string& format_options) { about_to_modify(); Impl::format_options = format_options; }
 
 	virtual void parent_has_new_region(const Device* parent) override;
 
 	virtual bool do_resize_needs_password() const override;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
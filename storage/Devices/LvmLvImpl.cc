@@ -21,6 +21,7 @@
 
 
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/StorageTmpl.h"
@@ -104,6 +105,19 @@ namespace storage
     }
 
 
+    void
+    LvmLv::Impl::set_uuid(const string& uuid)
+    {
+	about_to_modify();
+
+	Devicegraph::Impl::indices_lock_t lock = lock_indices();
+
+	remove_from_uuid_index();
+	Impl::uuid = uuid;
+	add_to_uuid_index();
+    }
+
+
     void
     LvmLv::Impl::save(xmlNode* node) const
     {
@@ -357,8 +371,17 @@ namespace storage
 
 	    if (lv.lv_type == LvType::SNAPSHOT || lv.lv_type == LvType::THIN)
 	    {
-		LvmLv* a = LvmLv::Impl::find_by_uuid(system, lv.origin_uuid);
-		LvmLv* b = LvmLv::Impl::find_by_uuid(system, lv.lv_uuid);
+		// The origin or the snapshot may have been ignored above,
+		// e.g. since it is private or of an unsupported type.
+
+		LvmLv* a = try_find_by_uuid<LvmLv>(system, lv.origin_uuid);
+		LvmLv* b = try_find_by_uuid<LvmLv>(system, lv.lv_uuid);
+
+		if (!a || !b)
+		{
+		    y2war("ignoring snapshot relation of lvm_lv " << lv.vg_name << " " << lv.lv_name);
+		    continue;
+		}
 
 		Snapshot::create(system, a, b);
 	    }
@@ -384,6 +407,8 @@ namespace storage
     void
     LvmLv::Impl::probe_pass_1a(Prober& prober)
     {
+	about_to_modify();
+
 	BlkDevice::Impl::probe_pass_1a(prober);
 
 	const LvmVg* lvm_vg = get_lvm_vg();
@@ -420,6 +445,8 @@ namespace storage
     void
     LvmLv::Impl::set_region(const Region& region)
     {
+	about_to_modify();
+
 	BlkDevice::Impl::set_region(region);
 
 	if (lv_type != LvType::THIN)
@@ -443,6 +470,8 @@ namespace storage
     void
     LvmLv::Impl::set_stripes(unsigned int stripes)
     {
+	about_to_modify();
+
 	if (stripes > 128)
 	    ST_THROW(Exception("stripes above 128"));
 
@@ -453,6 +482,8 @@ namespace storage
     void
     LvmLv::Impl::set_stripe_size(unsigned long long stripe_size)
     {
+	about_to_modify();
+
 	if (stripe_size > 0)
 	{
 	    if (stripe_size < 4 * KiB)
@@ -477,6 +508,8 @@ namespace storage
     void
     LvmLv::Impl::set_chunk_size(unsigned long long chunk_size)
     {
+	about_to_modify();
+
 	if (chunk_size > 0)
 	{
 	    if (chunk_size < 64 * KiB)
@@ -535,6 +568,8 @@ namespace storage
     void
     LvmLv::Impl::set_lv_name(const string& lv_name)
     {
+	about_to_modify();
+
 	Impl::lv_name = lv_name;
 
 	const LvmVg* lvm_vg = get_lvm_vg();
@@ -726,6 +761,23 @@ namespace storage
     }
 
 
+    size_t
+    LvmLv::Impl::calculate_content_hash() const
+    {
+	size_t seed = BlkDevice::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, lv_name);
+	boost::hash_combine(seed, lv_type);
+	boost::hash_combine(seed, uuid);
+	boost::hash_combine(seed, stripes);
+	boost::hash_combine(seed, stripe_size);
+	boost::hash_combine(seed, chunk_size);
+	boost::hash_combine(seed, used_extents);
+
+	return seed;
+    }
+
+
     void
     LvmLv::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
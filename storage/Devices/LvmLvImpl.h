@@ -38,7 +38,11 @@ namespace storage
     class ActivateCallbacks;
 
 
-    template <> struct DeviceTraits<LvmLv> { static const char* classname; };
+    template <> struct DeviceTraits<LvmLv>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::LVM_LV;
+    };
 
     template <> struct EnumTraits<LvType> { static const vector<string> names; };
 
@@ -52,6 +56,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<LvmLv>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkDevice::Impl::get_device_types() | device_type_bit<LvmLv>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return get_lv_name(); }
@@ -95,12 +102,14 @@ namespace storage
 	LvType get_lv_type() const { return lv_type; }
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
+
+	virtual string get_indexed_uuid() const override { return uuid; }
 
 	virtual void set_region(const Region& region) override;
 
 	unsigned long long get_used_extents() const { return used_extents; }
-	void set_used_extents(unsigned long long used_extents) { Impl::used_extents = used_extents; }
+	void set_used_extents(unsigned long long used_extents) { about_to_modify(); Impl::used_extents = used_extents; }
 
 	bool supports_stripes() const;
 
@@ -136,6 +145,7 @@ namespace storage
 	static const LvmLv* find_by_uuid(const Devicegraph* devicegraph, const string& uuid);
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
@@ -20,6 +20,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Utils/XmlFile.h"
 #include "storage/Prober.h"
 #include "storage/Utils/StorageTmpl.h"
@@ -66,6 +68,19 @@ namespace storage
     }
 
 
+    void
+    LvmPv::Impl::set_uuid(const string& uuid)
+    {
+	about_to_modify();
+
+	Devicegraph::Impl::indices_lock_t lock = lock_indices();
+
+	remove_from_uuid_index();
+	Impl::uuid = uuid;
+	add_to_uuid_index();
+    }
+
+
     void
     LvmPv::Impl::save(xmlNode* node) const
     {
@@ -114,6 +129,8 @@ namespace storage
     void
     LvmPv::Impl::calculate_pe_start()
     {
+	about_to_modify();
+
 	const BlkDevice* blk_device = get_blk_device();
 	const Topology& topology = blk_device->get_topology();
 
@@ -186,6 +203,8 @@ namespace storage
     void
     LvmPv::Impl::probe_pass_1b(Prober& prober)
     {
+	about_to_modify();
+
 	const CmdPvs& cmd_pvs = prober.get_system_info().getCmdPvs();
 
 	for (const CmdPvs::Pv& pv : cmd_pvs.get_pvs())
@@ -243,6 +262,8 @@ namespace storage
     void
     LvmPv::Impl::parent_has_new_region(const Device* parent)
     {
+	about_to_modify();
+
 	if (has_lvm_vg())
 	{
 	    LvmVg* lvm_vg = get_lvm_vg();
@@ -277,6 +298,18 @@ namespace storage
     }
 
 
+    size_t
+    LvmPv::Impl::calculate_content_hash() const
+    {
+	size_t seed = Device::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, uuid);
+	boost::hash_combine(seed, pe_start);
+
+	return seed;
+    }
+
+
     void
     LvmPv::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -35,7 +35,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<LvmPv> { static const char* classname; };
+    template <> struct DeviceTraits<LvmPv>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::LVM_PV;
+    };
 
 
     class LvmPv::Impl : public Device::Impl
@@ -51,6 +55,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<LvmPv>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Device::Impl::get_device_types() | device_type_bit<LvmPv>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "lvm pv"; }
@@ -62,7 +69,9 @@ namespace storage
 	virtual void check(const CheckCallbacks* check_callbacks) const override;
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
+
+	virtual string get_indexed_uuid() const override { return uuid; }
 
 	bool has_blk_device() const;
 
@@ -70,7 +79,7 @@ namespace storage
 	const BlkDevice* get_blk_device() const;
 
 	unsigned long long get_pe_start() const { return pe_start; }
-	void set_pe_start(unsigned long long pe_start) { Impl::pe_start = pe_start; }
+	void set_pe_start(unsigned long long pe_start) { about_to_modify(); Impl::pe_start = pe_start; }
 
 	void calculate_pe_start();
 
@@ -94,6 +103,7 @@ namespace storage
 	static const LvmPv* find_by_uuid(const Devicegraph* devicegraph, const string& uuid);
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
@@ -21,12 +21,14 @@
 
 
 #include <algorithm>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/Math.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/HumanString.h"
+#include "storage/Utils/RegionImpl.h"
 #include "storage/Utils/SystemCmd.h"
 #include "storage/SystemInfo/SystemInfo.h"
 #include "storage/Devices/LvmVgImpl.h"
@@ -70,6 +72,19 @@ namespace storage
     }
 
 
+    void
+    LvmVg::Impl::set_uuid(const string& uuid)
+    {
+	about_to_modify();
+
+	Devicegraph::Impl::indices_lock_t lock = lock_indices();
+
+	remove_from_uuid_index();
+	Impl::uuid = uuid;
+	add_to_uuid_index();
+    }
+
+
     void
     LvmVg::Impl::save(xmlNode* node) const
     {
@@ -115,6 +130,8 @@ namespace storage
     void
     LvmVg::Impl::probe_pass_1a(Prober& prober)
     {
+	about_to_modify();
+
 	Device::Impl::probe_pass_1a(prober);
 
 	const CmdVgs& cmd_vgs = prober.get_system_info().getCmdVgs();
@@ -127,6 +144,8 @@ namespace storage
     void
     LvmVg::Impl::calculate_reserved_extents(Prober& prober)
     {
+	about_to_modify();
+
 	const CmdVgs& cmd_vgs = prober.get_system_info().getCmdVgs();
 	const CmdVgs::Vg& vg = cmd_vgs.find_by_vg_uuid(uuid);
 
@@ -154,6 +173,8 @@ namespace storage
     void
     LvmVg::Impl::set_extent_size(unsigned long long extent_size)
     {
+	about_to_modify();
+
 	// see vgcreate(8) for valid values
 
 	unsigned long long old_extent_size = region.get_block_size();
@@ -275,6 +296,8 @@ namespace storage
     void
     LvmVg::Impl::parent_has_new_region(const Device* parent)
     {
+	about_to_modify();
+
 	calculate_region();
     }
 
@@ -282,6 +305,8 @@ namespace storage
     void
     LvmVg::Impl::set_vg_name(const string& vg_name)
     {
+	about_to_modify();
+
 	Impl::vg_name = vg_name;
 
 	// TODO call set_name() for all lvm_lvs
@@ -298,6 +323,8 @@ namespace storage
     void
     LvmVg::Impl::calculate_region()
     {
+	about_to_modify();
+
 	unsigned long long extent_size = region.get_block_size();
 
 	unsigned long long extent_count = 0;
@@ -317,6 +344,8 @@ namespace storage
     LvmPv*
     LvmVg::Impl::add_lvm_pv(BlkDevice* blk_device)
     {
+	about_to_modify();
+
 	ST_CHECK_PTR(blk_device);
 
 	Devicegraph* devicegraph = get_devicegraph();
@@ -351,6 +380,8 @@ namespace storage
     void
     LvmVg::Impl::remove_lvm_pv(BlkDevice* blk_device)
     {
+	about_to_modify();
+
 	ST_CHECK_PTR(blk_device);
 
 	LvmPv* lvm_pv = blk_device->get_impl().get_single_child_of_type<LvmPv>();
@@ -476,6 +507,20 @@ namespace storage
     }
 
 
+    size_t
+    LvmVg::Impl::calculate_content_hash() const
+    {
+	size_t seed = Device::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, vg_name);
+	boost::hash_combine(seed, uuid);
+	boost::hash_combine(seed, region.get_impl());
+	boost::hash_combine(seed, reserved_extents);
+
+	return seed;
+    }
+
+
     void
     LvmVg::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
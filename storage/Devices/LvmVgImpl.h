@@ -37,7 +37,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<LvmVg> { static const char* classname; };
+    template <> struct DeviceTraits<LvmVg>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::LVM_VG;
+    };
 
 
     class LvmVg::Impl : public Device::Impl
@@ -56,6 +60,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<LvmVg>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Device::Impl::get_device_types() | device_type_bit<LvmVg>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return get_vg_name(); }
@@ -68,7 +75,7 @@ namespace storage
 	void calculate_reserved_extents(Prober& prober);
 
 	unsigned long long get_reserved_extents() const { return reserved_extents; }
-	void set_reserved_extents(unsigned long long reserved_extents) { Impl::reserved_extents = reserved_extents; }
+	void set_reserved_extents(unsigned long long reserved_extents) { about_to_modify(); Impl::reserved_extents = reserved_extents; }
 
 	virtual Impl* clone() const override { return new Impl(*this); }
 
@@ -99,7 +106,9 @@ namespace storage
 	void set_vg_name(const string& vg_name);
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
+
+	virtual string get_indexed_uuid() const override { return uuid; }
 
 	LvmPv* add_lvm_pv(BlkDevice* blk_device);
 	void remove_lvm_pv(BlkDevice* blk_device);
@@ -121,6 +130,7 @@ namespace storage
 	static const LvmVg* find_by_uuid(const Devicegraph* devicegraph, const string& uuid);
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
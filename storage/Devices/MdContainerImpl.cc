@@ -83,6 +83,8 @@ namespace storage
     void
     MdContainer::Impl::calculate_region_and_topology()
     {
+	about_to_modify();
+
 	// Not implemented since MdContainer can only be probed. Also the size
 	// is zero in /sys.
     }
@@ -105,16 +107,16 @@ namespace storage
     void
     MdContainer::Impl::do_add_to_etc_mdadm(CommitData& commit_data) const
     {
-	EtcMdadm& etc_mdadm = commit_data.get_etc_mdadm();
+	CommitData::Locked<EtcMdadm> etc_mdadm = commit_data.get_etc_mdadm();
 
-	etc_mdadm.init(get_storage());
+	etc_mdadm->init(get_storage());
 
 	EtcMdadm::Entry entry;
 
 	entry.uuid = get_uuid();
 	entry.metadata = get_metadata();
 
-	etc_mdadm.update_entry(entry);
+	etc_mdadm->update_entry(entry);
     }
 
 
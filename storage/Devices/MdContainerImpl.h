@@ -34,7 +34,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<MdContainer> { static const char* classname; };
+    template <> struct DeviceTraits<MdContainer>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::MD_CONTAINER;
+    };
 
 
     class MdContainer::Impl : public Md::Impl
@@ -46,6 +50,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<MdContainer>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Md::Impl::get_device_types() | device_type_bit<MdContainer>(); }
+
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void check(const CheckCallbacks* check_callbacks) const override;
@@ -23,6 +23,7 @@
 
 #include <ctype.h>
 #include <boost/integer/common_factor_rt.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Devices/MdImpl.h"
 #include "storage/Devices/MdContainerImpl.h"
@@ -238,6 +239,8 @@ namespace storage
     void
     Md::Impl::set_md_level(MdLevel md_level)
     {
+	about_to_modify();
+
 	if (Impl::md_level == md_level)
 	    return;
 
@@ -289,6 +292,8 @@ namespace storage
     void
     Md::Impl::set_chunk_size(unsigned long chunk_size)
     {
+	about_to_modify();
+
 	if (Impl::chunk_size == chunk_size)
 	    return;
 
@@ -429,6 +434,8 @@ namespace storage
     void
     Md::Impl::probe_pass_1a(Prober& prober)
     {
+	about_to_modify();
+
 	Partitionable::Impl::probe_pass_1a(prober);
 
 	const ProcMdstat::Entry& entry = prober.get_system_info().getProcMdstat().get_entry(get_sysfs_name());
@@ -436,7 +443,7 @@ namespace storage
 	chunk_size = entry.chunk_size;
 
 	const MdadmDetail& mdadm_detail = prober.get_system_info().getMdadmDetail(get_name());
-	uuid = mdadm_detail.uuid;
+	set_uuid(mdadm_detail.uuid);
 	metadata = mdadm_detail.metadata;
 	md_level = mdadm_detail.level;
 
@@ -448,6 +455,8 @@ namespace storage
     void
     Md::Impl::probe_pass_1b(Prober& prober)
     {
+	about_to_modify();
+
 	const ProcMdstat::Entry& entry = prober.get_system_info().getProcMdstat().get_entry(get_sysfs_name());
 
 	for (const ProcMdstat::Device& device : entry.devices)
@@ -465,6 +474,8 @@ namespace storage
     void
     Md::Impl::probe_pass_1f(Prober& prober)
     {
+	about_to_modify();
+
 	Devicegraph* system = prober.get_system();
 	SystemInfo& system_info = prober.get_system_info();
 
@@ -516,14 +527,18 @@ namespace storage
     void
     Md::Impl::probe_uuid()
     {
+	about_to_modify();
+
 	MdadmDetail mdadm_detail(get_name());
-	uuid = mdadm_detail.uuid;
+	set_uuid(mdadm_detail.uuid);
     }
 
 
     void
     Md::Impl::parent_has_new_region(const Device* parent)
     {
+	about_to_modify();
+
 	calculate_region_and_topology();
     }
 
@@ -602,6 +617,19 @@ namespace storage
     }
 
 
+    void
+    Md::Impl::set_uuid(const string& uuid)
+    {
+	about_to_modify();
+
+	Devicegraph::Impl::indices_lock_t lock = lock_indices();
+
+	remove_from_uuid_index();
+	Impl::uuid = uuid;
+	add_to_uuid_index();
+    }
+
+
     void
     Md::Impl::save(xmlNode* node) const
     {
@@ -623,6 +651,8 @@ namespace storage
     MdUser*
     Md::Impl::add_device(BlkDevice* blk_device)
     {
+	about_to_modify();
+
 	ST_CHECK_PTR(blk_device);
 
 	if (blk_device->num_children() != 0)
@@ -639,6 +669,8 @@ namespace storage
     void
     Md::Impl::remove_device(BlkDevice* blk_device)
     {
+	about_to_modify();
+
 	ST_CHECK_PTR(blk_device);
 
 	MdUser* md_user = to_md_user(get_devicegraph()->find_holder(blk_device->get_sid(), get_sid()));
@@ -709,6 +741,22 @@ namespace storage
     }
 
 
+    size_t
+    Md::Impl::calculate_content_hash() const
+    {
+	size_t seed = Partitionable::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, md_level);
+	boost::hash_combine(seed, md_parity);
+	boost::hash_combine(seed, chunk_size);
+	boost::hash_combine(seed, metadata);
+	boost::hash_combine(seed, uuid);
+	boost::hash_combine(seed, in_etc_mdadm);
+
+	return seed;
+    }
+
+
     void
     Md::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -844,6 +892,8 @@ namespace storage
     void
     Md::Impl::calculate_region_and_topology()
     {
+	about_to_modify();
+
 	// Calculating the exact size of a MD is difficult. Since a size too
 	// big can lead to severe problems later on, e.g. a partition not
 	// fitting anymore, we make a conservative calculation.
@@ -1128,16 +1178,16 @@ namespace storage
     void
     Md::Impl::do_add_to_etc_mdadm(CommitData& commit_data) const
     {
-	EtcMdadm& etc_mdadm = commit_data.get_etc_mdadm();
+	CommitData::Locked<EtcMdadm> etc_mdadm = commit_data.get_etc_mdadm();
 
-	etc_mdadm.init(get_storage());
+	etc_mdadm->init(get_storage());
 
 	EtcMdadm::Entry entry;
 
 	entry.device = get_name();
 	entry.uuid = uuid;
 
-	etc_mdadm.update_entry(entry);
+	etc_mdadm->update_entry(entry);
     }
 
 
@@ -1159,11 +1209,11 @@ namespace storage
     void
     Md::Impl::do_remove_from_etc_mdadm(CommitData& commit_data) const
     {
-	EtcMdadm& etc_mdadm = commit_data.get_etc_mdadm();
+	CommitData::Locked<EtcMdadm> etc_mdadm = commit_data.get_etc_mdadm();
 
 	// TODO containers?
 
-	etc_mdadm.remove_entry(uuid);
+	etc_mdadm->remove_entry(uuid);
     }
 
 
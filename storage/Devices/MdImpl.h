@@ -43,7 +43,11 @@ namespace storage
     class TmpDir;
 
 
-    template <> struct DeviceTraits<Md> { static const char* classname; };
+    template <> struct DeviceTraits<Md>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::MD;
+    };
 
     template <> struct EnumTraits<MdLevel> { static const vector<string> names; };
     template <> struct EnumTraits<MdParity> { static const vector<string> names; };
@@ -58,6 +62,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Md>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Partitionable::Impl::get_device_types() | device_type_bit<Md>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_name_sort_key() const override;
@@ -86,7 +93,7 @@ namespace storage
 	void set_md_level(MdLevel md_level);
 
 	MdParity get_md_parity() const { return md_parity; }
-	void set_md_parity(MdParity md_parity) { Impl::md_parity = md_parity; }
+	void set_md_parity(MdParity md_parity) { about_to_modify(); Impl::md_parity = md_parity; }
 
 	vector<MdParity> get_allowed_md_parities() const;
 
@@ -96,10 +103,12 @@ namespace storage
 	unsigned long get_default_chunk_size() const;
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
+
+	virtual string get_indexed_uuid() const override { return uuid; }
 
 	const string& get_metadata() const { return metadata; }
-	void set_metadata(const string& metadata) { Impl::metadata = metadata; }
+	void set_metadata(const string& metadata) { about_to_modify(); Impl::metadata = metadata; }
 
 	unsigned int minimal_number_of_devices() const;
 	bool supports_spare_devices() const;
@@ -108,7 +117,7 @@ namespace storage
 	unsigned int number_of_devices() const;
 
 	bool is_in_etc_mdadm() const { return in_etc_mdadm; }
-	void set_in_etc_mdadm(bool in_etc_mdadm) { Impl::in_etc_mdadm = in_etc_mdadm; }
+	void set_in_etc_mdadm(bool in_etc_mdadm) { about_to_modify(); Impl::in_etc_mdadm = in_etc_mdadm; }
 
 	static bool is_valid_name(const string& name);
 
@@ -132,6 +141,7 @@ namespace storage
 	virtual void add_delete_actions(Actiongraph::Impl& actiongraph) const override;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
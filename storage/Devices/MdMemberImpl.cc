@@ -111,6 +111,8 @@ namespace storage
     void
     MdMember::Impl::probe_pass_1b(Prober& prober)
     {
+	about_to_modify();
+
 	Md::Impl::probe_pass_1b(prober);
 
 	const ProcMdstat::Entry& entry = prober.get_system_info().getProcMdstat().get_entry(get_sysfs_name());
@@ -126,6 +128,8 @@ namespace storage
     void
     MdMember::Impl::calculate_region_and_topology()
     {
+	about_to_modify();
+
 	// Not implemented since MdMember can only be probed.
     }
 
@@ -150,9 +154,9 @@ namespace storage
 	const MdSubdevice* md_subdevice = get_single_in_holder_of_type<const MdSubdevice>();
 	const MdContainer* md_container = to_md_container(md_subdevice->get_source());
 
-	EtcMdadm& etc_mdadm = commit_data.get_etc_mdadm();
+	CommitData::Locked<EtcMdadm> etc_mdadm = commit_data.get_etc_mdadm();
 
-	etc_mdadm.init(get_storage());
+	etc_mdadm->init(get_storage());
 
 	EtcMdadm::Entry entry;
 
@@ -162,7 +166,7 @@ namespace storage
 	entry.container_uuid = md_container->get_uuid();
 	entry.container_member = md_subdevice->get_member();
 
-	etc_mdadm.update_entry(entry);
+	etc_mdadm->update_entry(entry);
     }
 
 
@@ -34,7 +34,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<MdMember> { static const char* classname; };
+    template <> struct DeviceTraits<MdMember>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::MD_MEMBER;
+    };
 
 
     class MdMember::Impl : public Md::Impl
@@ -46,6 +50,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<MdMember>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Md::Impl::get_device_types() | device_type_bit<MdMember>(); }
+
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void check(const CheckCallbacks* check_callbacks) const override;
@@ -21,6 +21,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Devices/MsdosImpl.h"
 #include "storage/Devices/PartitionableImpl.h"
 #include "storage/Devices/PartitionImpl.h"
@@ -95,6 +97,8 @@ namespace storage
     void
     Msdos::Impl::set_minimal_mbr_gap(unsigned long minimal_mbr_gap)
     {
+	about_to_modify();
+
 	Impl::minimal_mbr_gap = minimal_mbr_gap;
     }
 
@@ -136,6 +140,17 @@ namespace storage
     }
 
 
+    size_t
+    Msdos::Impl::calculate_content_hash() const
+    {
+	size_t seed = PartitionTable::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, minimal_mbr_gap);
+
+	return seed;
+    }
+
+
     void
     Msdos::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
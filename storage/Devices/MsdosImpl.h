@@ -36,7 +36,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Msdos> { static const char* classname; };
+    template <> struct DeviceTraits<Msdos>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::MSDOS;
+    };
 
 
     class Msdos::Impl : public PartitionTable::Impl
@@ -60,6 +64,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Msdos>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return PartitionTable::Impl::get_device_types() | device_type_bit<Msdos>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "msdos"; }
@@ -73,6 +80,7 @@ namespace storage
 	virtual void save(xmlNode* node) const override;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
@@ -20,6 +20,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Devices/MultipathImpl.h"
 #include "storage/Devicegraph.h"
 #include "storage/Storage.h"
@@ -195,6 +197,8 @@ namespace storage
     void
     Multipath::Impl::probe_pass_1a(Prober& prober)
     {
+	about_to_modify();
+
 	Partitionable::Impl::probe_pass_1a(prober);
 
 	SystemInfo& system_info = prober.get_system_info();
@@ -214,6 +218,8 @@ namespace storage
     void
     Multipath::Impl::probe_pass_1b(Prober& prober)
     {
+	about_to_modify();
+
 	const CmdMultipath& cmd_multipath = prober.get_system_info().getCmdMultipath();
 
 	const CmdMultipath::Entry& entry = cmd_multipath.get_entry(get_dm_table_name());
@@ -272,6 +278,19 @@ namespace storage
     }
 
 
+    size_t
+    Multipath::Impl::calculate_content_hash() const
+    {
+	size_t seed = Partitionable::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, vendor);
+	boost::hash_combine(seed, model);
+	boost::hash_combine(seed, rotational);
+
+	return seed;
+    }
+
+
     void
     Multipath::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
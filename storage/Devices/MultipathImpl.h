@@ -38,7 +38,11 @@ namespace storage
     class ActivateCallbacks;
 
 
-    template <> struct DeviceTraits<Multipath> { static const char* classname; };
+    template <> struct DeviceTraits<Multipath>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::MULTIPATH;
+    };
 
 
     class Multipath::Impl : public Partitionable::Impl
@@ -51,6 +55,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Multipath>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Partitionable::Impl::get_device_types() | device_type_bit<Multipath>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	static bool activate_multipaths(const ActivateCallbacks* activate_callbacks);
@@ -72,7 +79,7 @@ namespace storage
 	const string& get_model() const { return model; }
 
 	bool is_rotational() const { return rotational; }
-	void set_rotational(bool rotational) { Impl::rotational = rotational; }
+	void set_rotational(bool rotational) { about_to_modify(); Impl::rotational = rotational; }
 
 	static void probe_multipaths(Prober& prober);
 	virtual void probe_pass_1a(Prober& prober) override;
@@ -84,6 +91,7 @@ namespace storage
 	virtual void add_delete_actions(Actiongraph::Impl& actiongraph) const override;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
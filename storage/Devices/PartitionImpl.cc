@@ -22,6 +22,7 @@
 
 
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Utils/AppUtil.h"
 #include "storage/Utils/SystemCmd.h"
@@ -107,6 +108,8 @@ namespace storage
     void
     Partition::Impl::probe_pass_1a(Prober& prober)
     {
+	about_to_modify();
+
 	BlkDevice::Impl::probe_pass_1a(prober);
 
 	SystemInfo& system_info = prober.get_system_info();
@@ -137,7 +140,7 @@ namespace storage
 	// gets renumbered. For UUIDs a rather odd behaviour.
 
 	if (!cmd_udevadm_info.get_by_part_uuid_links().empty() && is_gpt(partition_table))
-	    uuid = cmd_udevadm_info.get_by_part_uuid_links().front();
+	    set_uuid(cmd_udevadm_info.get_by_part_uuid_links().front());
 
 	probe_topology(prober);
     }
@@ -146,6 +149,8 @@ namespace storage
     void
     Partition::Impl::probe_topology(Prober& prober)
     {
+	about_to_modify();
+
 	SystemInfo& system_info = prober.get_system_info();
 
 	const Partitionable* partitionable = get_partitionable();
@@ -161,6 +166,19 @@ namespace storage
     }
 
 
+    void
+    Partition::Impl::set_uuid(const string& uuid)
+    {
+	about_to_modify();
+
+	Devicegraph::Impl::indices_lock_t lock = lock_indices();
+
+	remove_from_uuid_index();
+	Impl::uuid = uuid;
+	add_to_uuid_index();
+    }
+
+
     void
     Partition::Impl::save(xmlNode* node) const
     {
@@ -230,6 +248,8 @@ namespace storage
     void
     Partition::Impl::set_number(unsigned int number)
     {
+	about_to_modify();
+
 	std::pair<string, unsigned int> pair = device_to_name_and_number(get_name());
 
 	set_name(name_and_number_to_device(pair.first, number));
@@ -242,6 +262,8 @@ namespace storage
     void
     Partition::Impl::set_region(const Region& region)
     {
+	about_to_modify();
+
 	const Region& partitionable_region = get_partitionable()->get_region();
 	if (region.get_block_size() != partitionable_region.get_block_size())
 	    ST_THROW(DifferentBlockSizes(region.get_block_size(), partitionable_region.get_block_size()));
@@ -255,6 +277,8 @@ namespace storage
     void
     Partition::Impl::calculate_topology()
     {
+	about_to_modify();
+
 	// TODO The alignment_offset should also be calculated. But
 	// since all new partition are normally aligned anyway this is
 	// not so urgent. Would require to probe and save the
@@ -397,6 +421,22 @@ namespace storage
     }
 
 
+    size_t
+    Partition::Impl::calculate_content_hash() const
+    {
+	size_t seed = BlkDevice::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, type);
+	boost::hash_combine(seed, id);
+	boost::hash_combine(seed, boot);
+	boost::hash_combine(seed, legacy_boot);
+	boost::hash_combine(seed, label);
+	boost::hash_combine(seed, uuid);
+
+	return seed;
+    }
+
+
     void
     Partition::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -457,6 +497,8 @@ namespace storage
     void
     Partition::Impl::set_type(PartitionType type)
     {
+	about_to_modify();
+
 	const PartitionTable* partition_table = get_partition_table();
 
 	if (!partition_table->get_impl().is_partition_type_supported(type))
@@ -470,6 +512,8 @@ namespace storage
     void
     Partition::Impl::set_id(unsigned int id)
     {
+	about_to_modify();
+
 	const PartitionTable* partition_table = get_partition_table();
 
 	if (!partition_table->get_impl().is_partition_id_supported(id))
@@ -483,6 +527,8 @@ namespace storage
     void
     Partition::Impl::set_boot(bool boot)
     {
+	about_to_modify();
+
 	const PartitionTable* partition_table = get_partition_table();
 
 	if (!partition_table->get_impl().is_partition_boot_flag_supported())
@@ -504,6 +550,8 @@ namespace storage
     void
     Partition::Impl::set_legacy_boot(bool legacy_boot)
     {
+	about_to_modify();
+
 	const PartitionTable* partition_table = get_partition_table();
 
 	if (!partition_table->get_impl().is_partition_legacy_boot_flag_supported())
@@ -517,6 +565,8 @@ namespace storage
     void
     Partition::Impl::update_sysfs_name_and_path()
     {
+	about_to_modify();
+
 	const Partitionable* partitionable = get_partitionable();
 
 	// TODO different for device-mapper partitions
@@ -537,6 +587,8 @@ namespace storage
     void
     Partition::Impl::update_udev_paths_and_ids()
     {
+	about_to_modify();
+
 	const Partitionable* partitionable = get_partitionable();
 
 	string addition = "-part" + to_string(get_number());
@@ -41,7 +41,11 @@ namespace storage
     class Partitionable;
 
 
-    template <> struct DeviceTraits<Partition> { static const char* classname; };
+    template <> struct DeviceTraits<Partition>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::PARTITION;
+    };
 
     template <> struct EnumTraits<PartitionType> { static const vector<string> names; };
 
@@ -56,6 +60,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Partition>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkDevice::Impl::get_device_types() | device_type_bit<Partition>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_name_sort_key() const override;
@@ -96,10 +103,12 @@ namespace storage
 	void set_legacy_boot(bool legacy_boot);
 
 	const string& get_label() const { return label; }
-	void set_label(const string& label) { Impl::label = label; }
+	void set_label(const string& label) { about_to_modify(); Impl::label = label; }
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
+
+	virtual string get_indexed_uuid() const override { return uuid; }
 
 	void update_sysfs_name_and_path();
 	void update_udev_paths_and_ids();
@@ -118,6 +127,7 @@ namespace storage
 	virtual void add_delete_actions(Actiongraph::Impl& actiongraph) const override;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
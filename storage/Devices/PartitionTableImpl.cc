@@ -22,6 +22,7 @@
 
 
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Devices/PartitionableImpl.h"
 #include "storage/Devices/PartitionTableImpl.h"
@@ -64,6 +65,8 @@ namespace storage
     void
     PartitionTable::Impl::probe_pass_1c(Prober& prober)
     {
+	about_to_modify();
+
 	Device::Impl::probe_pass_1c(prober);
 
 	const Partitionable* partitionable = get_partitionable();
@@ -246,6 +249,17 @@ namespace storage
     }
 
 
+    size_t
+    PartitionTable::Impl::calculate_content_hash() const
+    {
+	size_t seed = Device::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, read_only);
+
+	return seed;
+    }
+
+
     void
     PartitionTable::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
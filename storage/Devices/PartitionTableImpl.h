@@ -39,7 +39,11 @@ namespace storage
 
     template <> struct EnumTraits<PtType> { static const vector<string> names; };
 
-    template <> struct DeviceTraits<PartitionTable> { static const char* classname; };
+    template <> struct DeviceTraits<PartitionTable>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::PARTITION_TABLE;
+    };
 
 
     // abstract class
@@ -48,6 +52,9 @@ namespace storage
     {
     public:
 
+	virtual device_types_t get_device_types() const override
+	    { return Device::Impl::get_device_types() | device_type_bit<PartitionTable>(); }
+
 	virtual void probe_pass_1c(Prober& prober) override;
 
 	virtual void check(const CheckCallbacks* check_callbacks) const override;
@@ -69,6 +76,7 @@ namespace storage
 	const Partitionable* get_partitionable() const;
 
 	virtual bool equal(const Device::Impl& rhs) const override = 0;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override = 0;
 	virtual void print(std::ostream& out) const override = 0;
 
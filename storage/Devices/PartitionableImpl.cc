@@ -22,6 +22,7 @@
 
 
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Devices/PartitionableImpl.h"
 #include "storage/Devices/PartitionTableImpl.h"
@@ -84,6 +85,8 @@ namespace storage
     void
     Partitionable::Impl::probe_pass_1a(Prober& prober)
     {
+	about_to_modify();
+
 	BlkDevice::Impl::probe_pass_1a(prober);
 
 	BlkDevice::Impl::probe_size(prober);
@@ -149,6 +152,8 @@ namespace storage
     void
     Partitionable::Impl::probe_pass_1c(Prober& prober)
     {
+	about_to_modify();
+
 	if (has_children() || !is_active() || get_size() == 0)
 	    return;
 
@@ -322,6 +327,17 @@ namespace storage
     }
 
 
+    size_t
+    Partitionable::Impl::calculate_content_hash() const
+    {
+	size_t seed = BlkDevice::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, range);
+
+	return seed;
+    }
+
+
     void
     Partitionable::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -35,7 +35,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Partitionable> { static const char* classname; };
+    template <> struct DeviceTraits<Partitionable>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::PARTITIONABLE;
+    };
 
 
     // abstract class
@@ -44,10 +48,13 @@ namespace storage
     {
     public:
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkDevice::Impl::get_device_types() | device_type_bit<Partitionable>(); }
+
 	virtual void check(const CheckCallbacks* check_callbacks) const override;
 
 	unsigned int get_range() const { return range; }
-	void set_range(unsigned int range) { Impl::range = range; }
+	void set_range(unsigned int range) { about_to_modify(); Impl::range = range; }
 
 	virtual bool is_usable_as_partitionable() const { return true; }
 
@@ -75,6 +82,7 @@ namespace storage
 	virtual string partition_name(int number) const;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
@@ -141,6 +141,8 @@ namespace storage
     void
     PlainEncryption::Impl::parent_has_new_region(const Device* parent)
     {
+	about_to_modify();
+
 	calculate_region_and_topology();
     }
 
@@ -148,6 +150,8 @@ namespace storage
     void
     PlainEncryption::Impl::calculate_region_and_topology()
     {
+	about_to_modify();
+
 	const BlkDevice* blk_device = get_blk_device();
 
 	set_size(blk_device->get_size());
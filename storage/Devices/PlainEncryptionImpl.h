@@ -37,7 +37,11 @@ namespace storage
     class ActivateCallbacks;
 
 
-    template <> struct DeviceTraits<PlainEncryption> { static const char* classname; };
+    template <> struct DeviceTraits<PlainEncryption>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::PLAIN_ENCRYPTION;
+    };
 
 
     class PlainEncryption::Impl : public Encryption::Impl
@@ -51,6 +55,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return "PlainEncryption"; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Encryption::Impl::get_device_types() | device_type_bit<PlainEncryption>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	static void probe_plain_encryptions(Prober& prober);
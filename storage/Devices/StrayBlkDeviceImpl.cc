@@ -91,6 +91,8 @@ namespace storage
     void
     StrayBlkDevice::Impl::probe_pass_1a(Prober& prober)
     {
+	about_to_modify();
+
 	BlkDevice::Impl::probe_pass_1a(prober);
 
 	BlkDevice::Impl::probe_size(prober);
@@ -34,7 +34,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<StrayBlkDevice> { static const char* classname; };
+    template <> struct DeviceTraits<StrayBlkDevice>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::STRAY_BLK_DEVICE;
+    };
 
 
     class StrayBlkDevice::Impl : public BlkDevice::Impl
@@ -51,6 +55,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<StrayBlkDevice>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkDevice::Impl::get_device_types() | device_type_bit<StrayBlkDevice>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_name_sort_key() const override;
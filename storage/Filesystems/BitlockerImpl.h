@@ -35,7 +35,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Bitlocker> { static const char* classname; };
+    template <> struct DeviceTraits<Bitlocker>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::BITLOCKER;
+    };
 
 
     class Bitlocker::Impl : public BlkFilesystem::Impl
@@ -73,6 +77,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Bitlocker>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkFilesystem::Impl::get_device_types() | device_type_bit<Bitlocker>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "BitLocker"; }
@@ -222,11 +222,9 @@ namespace storage
     vector<const BlkFilesystem*>
     BlkFilesystem::find_by_uuid(const Devicegraph* devicegraph, const string& uuid)
     {
-	auto pred = [&uuid](const BlkFilesystem* blk_filesystem) {
-	    return blk_filesystem->get_uuid() == uuid;
-	};
+	const Devicegraph::Impl& devicegraph_impl = devicegraph->get_impl();
 
-	return devicegraph->get_impl().get_devices_of_type_if<const BlkFilesystem>(pred);
+	return devicegraph_impl.filter_devices_of_type<const BlkFilesystem>(devicegraph_impl.find_vertices_by_uuid(uuid));
     }
 
 
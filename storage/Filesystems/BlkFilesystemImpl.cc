@@ -24,6 +24,7 @@
 #include <glob.h>
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/Enum.h"
@@ -135,6 +136,19 @@ namespace storage
     }
 
 
+    void
+    BlkFilesystem::Impl::set_uuid(const string& uuid)
+    {
+	about_to_modify();
+
+	Devicegraph::Impl::indices_lock_t lock = lock_indices();
+
+	remove_from_uuid_index();
+	Impl::uuid = uuid;
+	add_to_uuid_index();
+    }
+
+
     void
     BlkFilesystem::Impl::save(xmlNode* node) const
     {
@@ -216,6 +230,8 @@ namespace storage
     void
     BlkFilesystem::Impl::probe_pass_2a(Prober& prober)
     {
+	about_to_modify();
+
 	SystemInfo& system_info = prober.get_system_info();
 
 	const BlkDevice* blk_device = get_blk_device();
@@ -225,7 +241,7 @@ namespace storage
 	if (it != blkid.end())
 	{
 	    label = it->second.fs_label;
-	    uuid = it->second.fs_uuid;
+	    set_uuid(it->second.fs_uuid);
 	}
     }
 
@@ -233,12 +249,14 @@ namespace storage
     void
     BlkFilesystem::Impl::probe_uuid()
     {
+	about_to_modify();
+
 	const BlkDevice* blk_device = get_blk_device();
 
 	const Blkid& blkid(blk_device->get_name());
 	Blkid::const_iterator it = blkid.get_sole_entry();
 	if (it != blkid.end())
-	    uuid = it->second.fs_uuid;
+	    set_uuid(it->second.fs_uuid);
     }
 
 
@@ -387,6 +405,8 @@ namespace storage
     void
     BlkFilesystem::Impl::set_resize_info(const ResizeInfo& tmp)
     {
+	about_to_modify();
+
 	resize_info.set_value(tmp);
     }
 
@@ -422,6 +442,8 @@ namespace storage
     void
     BlkFilesystem::Impl::set_content_info(const ContentInfo& tmp)
     {
+	about_to_modify();
+
 	content_info.set_value(tmp);
     }
 
@@ -584,6 +606,20 @@ namespace storage
     }
 
 
+    size_t
+    BlkFilesystem::Impl::calculate_content_hash() const
+    {
+	size_t seed = Filesystem::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, label);
+	boost::hash_combine(seed, uuid);
+	boost::hash_combine(seed, mkfs_options);
+	boost::hash_combine(seed, tune_options);
+
+	return seed;
+    }
+
+
     void
     BlkFilesystem::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
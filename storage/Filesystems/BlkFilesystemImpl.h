@@ -40,7 +40,11 @@ namespace storage
     class EtcFstab;
 
 
-    template <> struct DeviceTraits<BlkFilesystem> { static const char* classname; };
+    template <> struct DeviceTraits<BlkFilesystem>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::BLK_FILESYSTEM;
+    };
 
 
     // abstract class
@@ -49,6 +53,9 @@ namespace storage
     {
     public:
 
+	virtual device_types_t get_device_types() const override
+	    { return Filesystem::Impl::get_device_types() | device_type_bit<BlkFilesystem>(); }
+
 	virtual unsigned long long min_size() const = 0;
 	virtual unsigned long long max_size() const = 0;
 
@@ -69,21 +76,23 @@ namespace storage
 	virtual unsigned int max_labelsize() const = 0;
 
 	const string& get_label() const { return label; }
-	void set_label(const string& label) { Impl::label = label; }
+	void set_label(const string& label) { about_to_modify(); Impl::label = label; }
 
 	virtual bool supports_uuid() const = 0;
 	virtual bool supports_modify_uuid() const { return false; }
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
+
+	virtual string get_indexed_uuid() const override { return uuid; }
 
 	virtual bool supports_external_journal() const { return false; }
 
 	const string& get_mkfs_options() const { return mkfs_options; }
-	void set_mkfs_options(const string& mkfs_options) { Impl::mkfs_options = mkfs_options; }
+	void set_mkfs_options(const string& mkfs_options) { about_to_modify(); Impl::mkfs_options = mkfs_options; }
 
 	const string& get_tune_options() const { return tune_options; }
-	void set_tune_options(const string& tune_options) { Impl::tune_options = tune_options; }
+	void set_tune_options(const string& tune_options) { about_to_modify(); Impl::tune_options = tune_options; }
 
 	virtual MountByType get_default_mount_by() const override;
 
@@ -101,6 +110,7 @@ namespace storage
 	virtual void wait_for_devices() const override;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
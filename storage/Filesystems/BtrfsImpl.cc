@@ -21,6 +21,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Devices/BlkDeviceImpl.h"
 #include "storage/Filesystems/BtrfsImpl.h"
 #include "storage/Filesystems/BtrfsSubvolumeImpl.h"
@@ -167,6 +169,8 @@ namespace storage
     void
     Btrfs::Impl::set_quota(bool quota)
     {
+	about_to_modify();
+
 	if (Impl::quota == quota)
 	    return;
 
@@ -241,6 +245,8 @@ namespace storage
     FilesystemUser*
     Btrfs::Impl::add_device(BlkDevice* blk_device)
     {
+	about_to_modify();
+
 	ST_CHECK_PTR(blk_device);
 
 	if (blk_device->num_children() != 0)
@@ -255,6 +261,8 @@ namespace storage
     void
     Btrfs::Impl::remove_device(BlkDevice* blk_device)
     {
+	about_to_modify();
+
 	ST_CHECK_PTR(blk_device);
 
 	FilesystemUser* filesystem_user = to_filesystem_user(get_devicegraph()->find_holder(blk_device->get_sid(),
@@ -491,6 +499,19 @@ namespace storage
     }
 
 
+    size_t
+    Btrfs::Impl::calculate_content_hash() const
+    {
+	size_t seed = BlkFilesystem::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, metadata_raid_level);
+	boost::hash_combine(seed, data_raid_level);
+	boost::hash_combine(seed, quota);
+
+	return seed;
+    }
+
+
     void
     Btrfs::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -612,6 +633,8 @@ namespace storage
     void
     Btrfs::Impl::probe_pass_2a(Prober& prober)
     {
+	about_to_modify();
+
 	BlkFilesystem::Impl::probe_pass_2a(prober);
 
 	SystemInfo& system_info = prober.get_system_info();
@@ -770,6 +793,8 @@ namespace storage
     void
     Btrfs::Impl::probe_pass_2b(Prober& prober)
     {
+	about_to_modify();
+
 	BlkFilesystem::Impl::probe_pass_2b(prober);
 
 	BtrfsSubvolume* top_level = get_top_level_btrfs_subvolume();
@@ -964,6 +989,8 @@ namespace storage
     void
     Btrfs::Impl::parse_mkfs_output(const vector<string>& stdout)
     {
+	about_to_modify();
+
 	static const regex uuid_regex("UUID:[ \t]+(" UUID_REGEX ")", regex::extended);
 
 	smatch match;
@@ -1060,7 +1087,7 @@ namespace storage
         BlkFilesystem::Impl::do_add_to_etc_fstab(commit_data, mount_point);
 
         if (snapper_config)
-            snapper_config->post_add_to_etc_fstab(commit_data.get_etc_fstab());
+            snapper_config->post_add_to_etc_fstab(*commit_data.get_etc_fstab());
     }
 
 
@@ -45,7 +45,11 @@ namespace storage
     }
 
 
-    template <> struct DeviceTraits<Btrfs> { static const char* classname; };
+    template <> struct DeviceTraits<Btrfs>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::BTRFS;
+    };
 
     template <> struct EnumTraits<BtrfsRaidLevel> { static const vector<string> names; };
 
@@ -71,10 +75,10 @@ namespace storage
 	virtual bool supports_uuid() const override { return true; }
 
 	BtrfsRaidLevel get_metadata_raid_level() const { return metadata_raid_level; }
-	void set_metadata_raid_level(BtrfsRaidLevel metadata_raid_level) { Impl::metadata_raid_level = metadata_raid_level; }
+	void set_metadata_raid_level(BtrfsRaidLevel metadata_raid_level) { about_to_modify(); Impl::metadata_raid_level = metadata_raid_level; }
 
 	BtrfsRaidLevel get_data_raid_level() const { return data_raid_level; }
-	void set_data_raid_level(BtrfsRaidLevel data_raid_level) { Impl::data_raid_level = data_raid_level; }
+	void set_data_raid_level(BtrfsRaidLevel data_raid_level) { about_to_modify(); Impl::data_raid_level = data_raid_level; }
 
 	vector<BtrfsRaidLevel> get_allowed_metadata_raid_levels() const;
 	vector<BtrfsRaidLevel> get_allowed_data_raid_levels() const;
@@ -114,9 +118,10 @@ namespace storage
 	const BtrfsQgroup* find_btrfs_qgroup_by_id(const BtrfsQgroup::id_t& id) const;
 
         bool get_configure_snapper() const { return configure_snapper; }
-        void set_configure_snapper(bool configure) { Impl::configure_snapper = configure; }
+        void set_configure_snapper(bool configure) { about_to_modify(); Impl::configure_snapper = configure; }
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
@@ -136,6 +141,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Btrfs>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkFilesystem::Impl::get_device_types() | device_type_bit<Btrfs>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "btrfs"; }
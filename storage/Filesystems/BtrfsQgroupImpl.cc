@@ -20,6 +20,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Filesystems/BtrfsImpl.h"
 #include "storage/Filesystems/BtrfsQgroupImpl.h"
 #include "storage/DevicegraphImpl.h"
@@ -144,6 +146,27 @@ namespace storage
     }
 
 
+    size_t
+    BtrfsQgroup::Impl::calculate_content_hash() const
+    {
+	size_t seed = Device::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, id);
+	boost::hash_combine(seed, referenced);
+	boost::hash_combine(seed, exclusive);
+
+	boost::hash_combine(seed, referenced_limit.is_initialized());
+	if (referenced_limit)
+	    boost::hash_combine(seed, referenced_limit.get());
+
+	boost::hash_combine(seed, exclusive_limit.is_initialized());
+	if (exclusive_limit)
+	    boost::hash_combine(seed, exclusive_limit.get());
+
+	return seed;
+    }
+
+
     void
     BtrfsQgroup::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -233,6 +256,8 @@ namespace storage
     void
     BtrfsQgroup::Impl::assign(BtrfsQgroup* btrfs_qgroup)
     {
+	about_to_modify();
+
 	ST_CHECK_PTR(btrfs_qgroup);
 
 	if (id.first <= btrfs_qgroup->get_id().first)
@@ -245,6 +270,8 @@ namespace storage
     void
     BtrfsQgroup::Impl::unassign(BtrfsQgroup* btrfs_qgroup)
     {
+	about_to_modify();
+
 	Holder* holder = get_devicegraph()->find_holder(btrfs_qgroup->get_sid(), get_sid());
 
 	get_devicegraph()->remove_holder(holder);
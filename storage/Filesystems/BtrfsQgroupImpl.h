@@ -42,7 +42,11 @@ namespace storage
     }
 
 
-    template <> struct DeviceTraits<BtrfsQgroup> { static const char* classname; };
+    template <> struct DeviceTraits<BtrfsQgroup>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::BTRFS_QGROUP;
+    };
 
 
     class BtrfsQgroup::Impl : public Device::Impl
@@ -53,6 +57,7 @@ namespace storage
 	static const id_t unknown_id;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
@@ -78,6 +83,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<BtrfsQgroup>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Device::Impl::get_device_types() | device_type_bit<BtrfsQgroup>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override;
@@ -91,21 +99,21 @@ namespace storage
 	const BtrfsSubvolume* get_btrfs_subvolume() const;
 
 	id_t get_id() const { return id; }
-	void set_id(const id_t& id) { Impl::id = id; }
+	void set_id(const id_t& id) { about_to_modify(); Impl::id = id; }
 
 	unsigned long long get_referenced() const { return referenced; }
-	void set_referenced(unsigned long long referenced) { Impl::referenced = referenced; }
+	void set_referenced(unsigned long long referenced) { about_to_modify(); Impl::referenced = referenced; }
 
 	unsigned long long get_exclusive() const { return exclusive; }
-	void set_exclusive(unsigned long long exclusive) { Impl::exclusive = exclusive; }
+	void set_exclusive(unsigned long long exclusive) { about_to_modify(); Impl::exclusive = exclusive; }
 
 	boost::optional<unsigned long long> get_referenced_limit() const { return referenced_limit; }
 	void set_referenced_limit(const boost::optional<unsigned long long>& referenced_limit)
-	    { Impl::referenced_limit = referenced_limit; }
+	    { about_to_modify(); Impl::referenced_limit = referenced_limit; }
 
 	boost::optional<unsigned long long> get_exclusive_limit() const { return exclusive_limit; }
 	void set_exclusive_limit(const boost::optional<unsigned long long>& exclusive_limit)
-	    { Impl::exclusive_limit = exclusive_limit; }
+	    { about_to_modify(); Impl::exclusive_limit = exclusive_limit; }
 
 	bool is_assigned(const BtrfsQgroup* btrfs_qgroup) const;
 
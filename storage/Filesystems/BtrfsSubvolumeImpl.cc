@@ -20,6 +20,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Utils/XmlFile.h"
 #include "storage/Filesystems/BtrfsSubvolumeImpl.h"
 #include "storage/Filesystems/BtrfsImpl.h"
@@ -97,6 +99,8 @@ namespace storage
     void
     BtrfsSubvolume::Impl::set_default_btrfs_subvolume()
     {
+	about_to_modify();
+
 	if (!default_btrfs_subvolume)
 	{
 	    Btrfs* btrfs = get_btrfs();
@@ -393,6 +397,8 @@ namespace storage
     void
     BtrfsSubvolume::Impl::probe_pass_2a(Prober& prober, const string& mount_point)
     {
+	about_to_modify();
+
 	SystemInfo& system_info = prober.get_system_info();
 
 	const Btrfs* btrfs = get_btrfs();
@@ -406,6 +412,8 @@ namespace storage
     void
     BtrfsSubvolume::Impl::probe_pass_2b(Prober& prober, const string& mount_point)
     {
+	about_to_modify();
+
 	Mountable::Impl::probe_pass_2b(prober);
     }
 
@@ -413,6 +421,8 @@ namespace storage
     void
     BtrfsSubvolume::Impl::probe_id(const string& mount_point)
     {
+	about_to_modify();
+
 	const Btrfs* btrfs = get_btrfs();
 	const BlkDevice* blk_device = btrfs->get_impl().get_blk_device();
 
@@ -438,6 +448,20 @@ namespace storage
     }
 
 
+    size_t
+    BtrfsSubvolume::Impl::calculate_content_hash() const
+    {
+	size_t seed = Mountable::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, id);
+	boost::hash_combine(seed, path);
+	boost::hash_combine(seed, default_btrfs_subvolume);
+	boost::hash_combine(seed, nocow);
+
+	return seed;
+    }
+
+
     void
     BtrfsSubvolume::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
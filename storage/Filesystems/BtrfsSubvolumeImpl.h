@@ -38,7 +38,11 @@ namespace storage
     class EtcFstab;
 
 
-    template <> struct DeviceTraits<BtrfsSubvolume> { static const char* classname; };
+    template <> struct DeviceTraits<BtrfsSubvolume>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::BTRFS_SUBVOLUME;
+    };
 
 
     class BtrfsSubvolume::Impl : public Mountable::Impl
@@ -55,6 +59,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<BtrfsSubvolume>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Mountable::Impl::get_device_types() | device_type_bit<BtrfsSubvolume>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override;
@@ -67,18 +74,18 @@ namespace storage
 	virtual void probe_pass_2b(Prober& prober, const string& mount_point);
 
 	long get_id() const { return id; }
-	void set_id(long id) { Impl::id = id; }
+	void set_id(long id) { about_to_modify(); Impl::id = id; }
 
 	bool is_top_level() const { return id == top_level_id; }
 
 	const string& get_path() const { return path; }
-	void set_path(const string& path) { Impl::path = path; }
+	void set_path(const string& path) { about_to_modify(); Impl::path = path; }
 
 	bool is_default_btrfs_subvolume() const { return default_btrfs_subvolume; }
 	void set_default_btrfs_subvolume();
 
 	bool is_nocow() const { return nocow; }
-	void set_nocow(bool nocow) { Impl::nocow = nocow; }
+	void set_nocow(bool nocow) { about_to_modify(); Impl::nocow = nocow; }
 
 	Btrfs* get_btrfs();
 	const Btrfs* get_btrfs() const;
@@ -141,6 +148,7 @@ namespace storage
 	virtual const BtrfsSubvolume* get_non_impl() const override { return to_btrfs_subvolume(Device::Impl::get_non_impl()); }
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
@@ -36,7 +36,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Ext2> { static const char* classname; };
+    template <> struct DeviceTraits<Ext2>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::EXT2;
+    };
 
 
     class Ext2::Impl : public Ext::Impl
@@ -52,6 +56,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Ext2>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Ext::Impl::get_device_types() | device_type_bit<Ext2>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "ext2"; }
@@ -51,6 +51,8 @@ namespace storage
     void
     Ext::Impl::probe_pass_2b(Prober& prober)
     {
+	about_to_modify();
+
 	BlkFilesystem::Impl::probe_pass_2b(prober);
 
 	if (supports_external_journal())
@@ -35,7 +35,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Ext> { static const char* classname; };
+    template <> struct DeviceTraits<Ext>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::EXT;
+    };
 
 
     class Ext::Impl : public BlkFilesystem::Impl
@@ -68,6 +72,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Ext>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkFilesystem::Impl::get_device_types() | device_type_bit<Ext>(); }
+
 	virtual ResizeInfo detect_resize_info_on_disk(const BlkDevice* blk_device = nullptr) const override;
 
 	virtual void do_create() override;
@@ -35,7 +35,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<F2fs> { static const char* classname; };
+    template <> struct DeviceTraits<F2fs>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::F2FS;
+    };
 
 
     class F2fs::Impl : public BlkFilesystem::Impl
@@ -68,6 +72,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<F2fs>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkFilesystem::Impl::get_device_types() | device_type_bit<F2fs>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "f2fs"; }
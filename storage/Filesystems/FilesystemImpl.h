@@ -39,7 +39,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Filesystem> { static const char* classname; };
+    template <> struct DeviceTraits<Filesystem>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::FILESYSTEM;
+    };
 
 
     // abstract class
@@ -48,6 +52,9 @@ namespace storage
     {
     public:
 
+	virtual device_types_t get_device_types() const override
+	    { return Mountable::Impl::get_device_types() | device_type_bit<Filesystem>(); }
+
 	virtual FsType get_type() const = 0;
 
 	virtual bool equal(const Device::Impl& rhs) const override;
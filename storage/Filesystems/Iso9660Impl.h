@@ -35,7 +35,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Iso9660> { static const char* classname; };
+    template <> struct DeviceTraits<Iso9660>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::ISO9660;
+    };
 
 
     class Iso9660::Impl : public BlkFilesystem::Impl
@@ -68,6 +72,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Iso9660>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkFilesystem::Impl::get_device_types() | device_type_bit<Iso9660>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "iso9660"; }
@@ -35,7 +35,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Jfs> { static const char* classname; };
+    template <> struct DeviceTraits<Jfs>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::JFS;
+    };
 
 
     class Jfs::Impl : public BlkFilesystem::Impl
@@ -69,6 +73,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Jfs>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkFilesystem::Impl::get_device_types() | device_type_bit<Jfs>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "jfs"; }
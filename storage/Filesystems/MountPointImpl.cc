@@ -21,6 +21,7 @@
 
 
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Utils/XmlFile.h"
 #include "storage/Devices/BlkDeviceImpl.h"
@@ -137,6 +138,8 @@ namespace storage
     void
     MountPoint::Impl::set_path(const string& path)
     {
+	about_to_modify();
+
 #if 0
 	if (!valid_path(path))
 	    ST_THROW(InvalidMountPointPath(path));
@@ -174,6 +177,24 @@ namespace storage
     }
 
 
+    size_t
+    MountPoint::Impl::calculate_content_hash() const
+    {
+	size_t seed = Device::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, path);
+	boost::hash_combine(seed, mount_by);
+	boost::hash_combine(seed, mount_type);
+	boost::hash_range(seed, mount_options.begin(), mount_options.end());
+	boost::hash_combine(seed, freq);
+	boost::hash_combine(seed, passno);
+	boost::hash_combine(seed, active);
+	boost::hash_combine(seed, in_etc_fstab);
+
+	return seed;
+    }
+
+
     void
     MountPoint::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -279,6 +300,8 @@ namespace storage
     void
     MountPoint::Impl::set_mount_type(FsType mount_type)
     {
+	about_to_modify();
+
 	if (mount_type == FsType::UNKNOWN)
 	    ST_THROW(Exception("illegal mount type"));
 
@@ -289,6 +312,8 @@ namespace storage
     void
     MountPoint::Impl::set_default_mount_type()
     {
+	about_to_modify();
+
 	set_mount_type(get_mountable()->get_impl().get_default_mount_type());
     }
 
@@ -334,6 +359,8 @@ namespace storage
     void
     MountPoint::Impl::set_default_mount_by()
     {
+	about_to_modify();
+
 	set_mount_by(get_mountable()->get_impl().get_default_mount_by());
     }
 
@@ -341,6 +368,8 @@ namespace storage
     void
     MountPoint::Impl::set_mount_options(const MountOpts& mount_options)
     {
+	about_to_modify();
+
 	Impl::mount_options = mount_options;
     }
 
@@ -348,6 +377,8 @@ namespace storage
     void
     MountPoint::Impl::set_mount_options(const vector<string>& mount_options)
     {
+	about_to_modify();
+
 	Impl::mount_options.set_opts(mount_options);
     }
 
@@ -362,6 +393,8 @@ namespace storage
     void
     MountPoint::Impl::set_default_mount_options()
     {
+	about_to_modify();
+
 	set_mount_options(default_mount_options());
     }
 
@@ -581,15 +614,15 @@ namespace storage
     {
 	const Mountable* mountable = get_mountable();
 
-	EtcFstab& etc_fstab = commit_data.get_etc_fstab();
+	CommitData::Locked<EtcFstab> etc_fstab = commit_data.get_etc_fstab();
 
 	const FstabAnchor& fstab_anchor = get_fstab_anchor();
 
-	for (FstabEntry* entry : mountable->get_impl().find_etc_fstab_entries(etc_fstab, fstab_anchor))
+	for (FstabEntry* entry : mountable->get_impl().find_etc_fstab_entries(*etc_fstab, fstab_anchor))
 	{
 	    entry->set_spec(get_mount_by_name());
-	    etc_fstab.log_diff();
-	    etc_fstab.write();
+	    etc_fstab->log_diff();
+	    etc_fstab->write();
 	}
     }
 
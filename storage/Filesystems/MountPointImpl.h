@@ -41,7 +41,11 @@ namespace storage
     }
 
 
-    template <> struct DeviceTraits<MountPoint> { static const char* classname; };
+    template <> struct DeviceTraits<MountPoint>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::MOUNT_POINT;
+    };
 
 
     /**
@@ -86,6 +90,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<MountPoint>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Device::Impl::get_device_types() | device_type_bit<MountPoint>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override;
@@ -100,7 +107,7 @@ namespace storage
 	void set_path(const string& path);
 
 	MountByType get_mount_by() const { return mount_by; }
-	void set_mount_by(MountByType mount_by) { Impl::mount_by = mount_by; }
+	void set_mount_by(MountByType mount_by) { about_to_modify(); Impl::mount_by = mount_by; }
 
 	vector<MountByType> possible_mount_bys() const;
 
@@ -114,16 +121,16 @@ namespace storage
 	void set_default_mount_options();
 
 	int get_freq() const { return freq; }
-	void set_freq(int freq) { Impl::freq = freq; }
+	void set_freq(int freq) { about_to_modify(); Impl::freq = freq; }
 
 	int get_passno() const { return passno; }
-	void set_passno(int passno) { Impl::passno = passno; }
+	void set_passno(int passno) { about_to_modify(); Impl::passno = passno; }
 
 	bool is_in_etc_fstab() const { return in_etc_fstab; }
-	void set_in_etc_fstab(bool in_etc_fstab) { Impl::in_etc_fstab = in_etc_fstab; }
+	void set_in_etc_fstab(bool in_etc_fstab) { about_to_modify(); Impl::in_etc_fstab = in_etc_fstab; }
 
 	bool is_active() const { return active; }
-	void set_active(bool active) { Impl::active = active; }
+	void set_active(bool active) { about_to_modify(); Impl::active = active; }
 
 	bool has_mountable() const;
 
@@ -154,9 +161,10 @@ namespace storage
 	 */
 	const FstabAnchor& get_fstab_anchor() const { return fstab_anchor; }
 
-	void set_fstab_anchor(const FstabAnchor& fstab_anchor) { Impl::fstab_anchor = fstab_anchor; }
+	void set_fstab_anchor(const FstabAnchor& fstab_anchor) { about_to_modify(); Impl::fstab_anchor = fstab_anchor; }
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
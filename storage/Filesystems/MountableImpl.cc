@@ -145,6 +145,8 @@ namespace storage
     void
     Mountable::Impl::remove_mount_point()
     {
+	about_to_modify();
+
 	get_devicegraph()->remove_device(get_mount_point());
     }
 
@@ -204,6 +206,8 @@ namespace storage
     void
     Mountable::Impl::probe_pass_2b(Prober& prober)
     {
+	about_to_modify();
+
 	SystemInfo& system_info = prober.get_system_info();
 
 	vector<ExtendedFstabEntry> fstab_entries = find_etc_fstab_entries(system_info);
@@ -428,7 +432,7 @@ namespace storage
     void
     Mountable::Impl::do_add_to_etc_fstab(CommitData& commit_data, const MountPoint* mount_point) const
     {
-	EtcFstab& etc_fstab = commit_data.get_etc_fstab();
+	CommitData::Locked<EtcFstab> etc_fstab = commit_data.get_etc_fstab();
 
 	FstabEntry* entry = new FstabEntry();
 	entry->set_spec(get_mount_by_name(mount_point));
@@ -438,9 +442,9 @@ namespace storage
 	entry->set_fsck_pass(mount_point->get_passno());
 	entry->set_dump_pass(mount_point->get_freq());
 
-	etc_fstab.add(entry);
-	etc_fstab.log_diff();
-	etc_fstab.write();
+	etc_fstab->add(entry);
+	etc_fstab->log_diff();
+	etc_fstab->write();
     }
 
 
@@ -466,11 +470,11 @@ namespace storage
     void
     Mountable::Impl::do_update_in_etc_fstab(CommitData& commit_data, const Device* lhs, const MountPoint* mount_point) const
     {
-	EtcFstab& etc_fstab = commit_data.get_etc_fstab();
+	CommitData::Locked<EtcFstab> etc_fstab = commit_data.get_etc_fstab();
 
 	const FstabAnchor& fstab_anchor = mount_point->get_impl().get_fstab_anchor();
 
-	for (FstabEntry* entry : find_etc_fstab_entries(etc_fstab, fstab_anchor))
+	for (FstabEntry* entry : find_etc_fstab_entries(*etc_fstab, fstab_anchor))
 	{
 	    entry->set_spec(get_mount_by_name(mount_point));
 	    entry->set_mount_point(mount_point->get_path());
@@ -479,8 +483,8 @@ namespace storage
 	    entry->set_fsck_pass(mount_point->get_passno());
 	    entry->set_dump_pass(mount_point->get_freq());
 
-	    etc_fstab.log_diff();
-	    etc_fstab.write();
+	    etc_fstab->log_diff();
+	    etc_fstab->write();
 	}
     }
 
@@ -507,15 +511,15 @@ namespace storage
     void
     Mountable::Impl::do_remove_from_etc_fstab(CommitData& commit_data, const MountPoint* mount_point) const
     {
-	EtcFstab& etc_fstab = commit_data.get_etc_fstab();
+	CommitData::Locked<EtcFstab> etc_fstab = commit_data.get_etc_fstab();
 
 	const FstabAnchor& fstab_anchor = mount_point->get_impl().get_fstab_anchor();
 
-	for (FstabEntry* entry : find_etc_fstab_entries(etc_fstab, fstab_anchor))
+	for (FstabEntry* entry : find_etc_fstab_entries(*etc_fstab, fstab_anchor))
 	{
-	    etc_fstab.remove(entry);
-	    etc_fstab.log_diff();
-	    etc_fstab.write();
+	    etc_fstab->remove(entry);
+	    etc_fstab->log_diff();
+	    etc_fstab->write();
 	}
     }
 
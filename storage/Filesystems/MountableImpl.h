@@ -43,7 +43,11 @@ namespace storage
     class FstabAnchor;
 
 
-    template <> struct DeviceTraits<Mountable> { static const char* classname; };
+    template <> struct DeviceTraits<Mountable>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::MOUNTABLE;
+    };
 
     template <> struct EnumTraits<FsType> { static const vector<string> names; };
 
@@ -68,6 +72,9 @@ namespace storage
     {
     public:
 
+	virtual device_types_t get_device_types() const override
+	    { return Device::Impl::get_device_types() | device_type_bit<Mountable>(); }
+
 	virtual bool supports_mount() const { return true; }
 
 	MountPoint* create_mount_point(const string& path);
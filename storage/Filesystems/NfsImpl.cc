@@ -21,6 +21,7 @@
 
 
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Utils/XmlFile.h"
 #include "storage/Filesystems/NfsImpl.h"
@@ -211,6 +212,18 @@ namespace storage
     }
 
 
+    size_t
+    Nfs::Impl::calculate_content_hash() const
+    {
+	size_t seed = Filesystem::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, server);
+	boost::hash_combine(seed, path);
+
+	return seed;
+    }
+
+
     void
     Nfs::Impl::log_diff(std::ostream& log, const Device::Impl& rhs_base) const
     {
@@ -34,7 +34,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Nfs> { static const char* classname; };
+    template <> struct DeviceTraits<Nfs>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::NFS;
+    };
 
 
     class Nfs::Impl : public Filesystem::Impl
@@ -50,6 +54,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Nfs>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Filesystem::Impl::get_device_types() | device_type_bit<Nfs>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return server + ":" + path; }
@@ -80,6 +87,7 @@ namespace storage
 	virtual uf_t used_features_pure() const override { return UF_NFS; }
 
 	virtual bool equal(const Device::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
@@ -35,7 +35,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Reiserfs> { static const char* classname; };
+    template <> struct DeviceTraits<Reiserfs>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::REISERFS;
+    };
 
 
     class Reiserfs::Impl : public BlkFilesystem::Impl
@@ -69,6 +73,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Reiserfs>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkFilesystem::Impl::get_device_types() | device_type_bit<Reiserfs>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "reiserfs"; }
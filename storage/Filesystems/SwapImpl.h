@@ -36,7 +36,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Swap> { static const char* classname; };
+    template <> struct DeviceTraits<Swap>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::SWAP;
+    };
 
 
     class Swap::Impl : public BlkFilesystem::Impl
@@ -71,6 +75,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Swap>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkFilesystem::Impl::get_device_types() | device_type_bit<Swap>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "swap"; }
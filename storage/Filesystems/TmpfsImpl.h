@@ -34,7 +34,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Tmpfs> { static const char* classname; };
+    template <> struct DeviceTraits<Tmpfs>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::TMPFS;
+    };
 
 
     class Tmpfs::Impl : public Filesystem::Impl
@@ -50,6 +54,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Tmpfs>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return Filesystem::Impl::get_device_types() | device_type_bit<Tmpfs>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "tmpfs"; }
@@ -36,7 +36,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Vfat> { static const char* classname; };
+    template <> struct DeviceTraits<Vfat>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::VFAT;
+    };
 
 
     class Vfat::Impl : public BlkFilesystem::Impl
@@ -70,6 +74,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Vfat>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkFilesystem::Impl::get_device_types() | device_type_bit<Vfat>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "vfat"; }
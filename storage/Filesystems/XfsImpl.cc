@@ -58,6 +58,8 @@ namespace storage
     void
     Xfs::Impl::probe_pass_2b(Prober& prober)
     {
+	about_to_modify();
+
 	BlkFilesystem::Impl::probe_pass_2b(prober);
 
 	if (!get_uuid().empty())
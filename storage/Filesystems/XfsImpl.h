@@ -36,7 +36,11 @@ namespace storage
     using namespace std;
 
 
-    template <> struct DeviceTraits<Xfs> { static const char* classname; };
+    template <> struct DeviceTraits<Xfs>
+    {
+	static const char* classname;
+	static const DeviceType device_type = DeviceType::XFS;
+    };
 
 
     class Xfs::Impl : public BlkFilesystem::Impl
@@ -74,6 +78,9 @@ namespace storage
 
 	virtual const char* get_classname() const override { return DeviceTraits<Xfs>::classname; }
 
+	virtual device_types_t get_device_types() const override
+	    { return BlkFilesystem::Impl::get_device_types() | device_type_bit<Xfs>(); }
+
 	virtual string get_pretty_classname() const override;
 
 	virtual string get_displayname() const override { return "xfs"; }
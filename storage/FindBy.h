@@ -25,6 +25,7 @@
 
 
 #include <string>
+#include <type_traits>
 
 #include "storage/DevicegraphImpl.h"
 #include "storage/Utils/ExceptionImpl.h"
@@ -35,14 +36,24 @@ namespace storage
     using std::string;
 
 
+    class BlkDevice;
+
+
+    /**
+     * Find a device by name using the name index of the devicegraph. Since
+     * only block devices are in the name index Type must be BlkDevice or a
+     * derived class.
+     */
     template<typename Type>
     Type*
     find_by_name(Devicegraph* devicegraph, const string& name)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	static_assert(std::is_base_of<BlkDevice, Type>::value, "only block devices are in the name index");
+
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_name(name))
 	{
 	    Type* device = dynamic_cast<Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_name() == name)
+	    if (device)
 		return device;
 	}
 
@@ -54,10 +65,12 @@ namespace storage
     const Type*
     find_by_name(const Devicegraph* devicegraph, const string& name)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	static_assert(std::is_base_of<BlkDevice, Type>::value, "only block devices are in the name index");
+
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_name(name))
 	{
 	    const Type* device = dynamic_cast<const Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_name() == name)
+	    if (device)
 		return device;
 	}
 
@@ -65,33 +78,67 @@ namespace storage
     }
 
 
+    /**
+     * Find a device by UUID using the uuid index of the devicegraph. Type
+     * must be a class included in the uuid index, see
+     * Device::Impl::get_indexed_uuid(). Returns nullptr if no device is
+     * found. Use this instead of find_by_uuid() if a miss is expected.
+     */
     template<typename Type>
     Type*
-    find_by_uuid(Devicegraph* devicegraph, const string& uuid)
+    try_find_by_uuid(Devicegraph* devicegraph, const string& uuid)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_uuid(uuid))
 	{
 	    Type* device = dynamic_cast<Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_uuid() == uuid)
+	    if (device)
 		return device;
 	}
 
-	ST_THROW(DeviceNotFoundByUuid(uuid));
+	return nullptr;
     }
 
 
     template<typename Type>
     const Type*
-    find_by_uuid(const Devicegraph* devicegraph, const string& uuid)
+    try_find_by_uuid(const Devicegraph* devicegraph, const string& uuid)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_uuid(uuid))
 	{
 	    const Type* device = dynamic_cast<const Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_uuid() == uuid)
+	    if (device)
 		return device;
 	}
 
-	ST_THROW(DeviceNotFoundByUuid(uuid));
+	return nullptr;
+    }
+
+
+    /**
+     * Like try_find_by_uuid() but throws DeviceNotFoundByUuid if no device
+     * is found.
+     */
+    template<typename Type>
+    Type*
+    find_by_uuid(Devicegraph* devicegraph, const string& uuid)
+    {
+	Type* device = try_find_by_uuid<Type>(devicegraph, uuid);
+	if (!device)
+	    ST_THROW(DeviceNotFoundByUuid(uuid));
+
+	return device;
+    }
+
+
+    template<typename Type>
+    const Type*
+    find_by_uuid(const Devicegraph* devicegraph, const string& uuid)
+    {
+	const Type* device = try_find_by_uuid<Type>(devicegraph, uuid);
+	if (!device)
+	    ST_THROW(DeviceNotFoundByUuid(uuid));
+
+	return device;
     }
 
 }
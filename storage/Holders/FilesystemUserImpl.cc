@@ -20,6 +20,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Holders/FilesystemUserImpl.h"
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/StorageTmpl.h"
@@ -63,6 +65,18 @@ namespace storage
     }
 
 
+    size_t
+    FilesystemUser::Impl::calculate_content_hash() const
+    {
+	size_t seed = User::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, journal);
+	boost::hash_combine(seed, id);
+
+	return seed;
+    }
+
+
     void
     FilesystemUser::Impl::log_diff(std::ostream& log, const Holder::Impl& rhs_base) const
     {
@@ -49,14 +49,15 @@ namespace storage
 	virtual const char* get_classname() const override { return HolderTraits<FilesystemUser>::classname; }
 
 	virtual bool equal(const Holder::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Holder::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
 	bool is_journal() const { return journal; }
-	void set_journal(bool journal) { Impl::journal = journal; }
+	void set_journal(bool journal) { about_to_modify(); Impl::journal = journal; }
 
 	unsigned int get_id() const { return id; }
-	void set_id(unsigned int id) { Impl::id = id; }
+	void set_id(unsigned int id) { about_to_modify(); Impl::id = id; }
 
     private:
 
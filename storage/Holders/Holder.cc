@@ -50,6 +50,16 @@ namespace storage
     }
 
 
+    void
+    Holder::swap_impl(Holder& holder)
+    {
+	if (typeid(*impl) != typeid(*holder.impl))
+	    ST_THROW(LogicException("swapping impl of different classes"));
+
+	impl.swap(holder.impl);
+    }
+
+
     bool
     Holder::operator==(const Holder& rhs) const
     {
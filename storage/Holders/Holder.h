@@ -150,6 +150,12 @@ namespace storage
 	Impl& get_impl() { return *impl; }
 	const Impl& get_impl() const { return *impl; }
 
+	/**
+	 * Swaps the Impl with the Impl of another holder of the same
+	 * class. Used to restore the holder when rolling back a checkpoint.
+	 */
+	void swap_impl(Holder& holder);
+
 	virtual Holder* clone() const = 0;
 
 	void save(xmlNode* node) const ST_DEPRECATED;
@@ -175,7 +181,7 @@ namespace storage
 	void add_to_devicegraph(Devicegraph* devicegraph, const Device* source,
 				const Device* target);
 
-	const std::unique_ptr<Impl> impl;
+	std::unique_ptr<Impl> impl;
 
     };
 
@@ -21,6 +21,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Holders/HolderImpl.h"
 #include "storage/Devicegraph.h"
 #include "storage/Storage.h"
@@ -141,6 +143,29 @@ namespace storage
     }
 
 
+    void
+    Holder::Impl::about_to_modify()
+    {
+	if (devicegraph)
+	    devicegraph->get_impl().record_change(get_non_impl());
+
+	content_hash_valid = false;
+    }
+
+
+    size_t
+    Holder::Impl::get_content_hash() const
+    {
+	if (!content_hash_valid)
+	{
+	    content_hash = calculate_content_hash();
+	    content_hash_valid = true;
+	}
+
+	return content_hash;
+    }
+
+
     void
     Holder::Impl::set_edge(Devicegraph::Impl::edge_descriptor edge)
     {
@@ -233,12 +258,24 @@ namespace storage
     }
 
 
+    size_t
+    Holder::Impl::calculate_content_hash() const
+    {
+	size_t seed = 0;
+
+	boost::hash_combine(seed, string(get_classname()));
+	boost::hash_combine(seed, userdata);
+
+	return seed;
+    }
+
+
     void
     Holder::Impl::log_diff(std::ostream& log, const Impl& rhs) const
     {
 	// TODO handle source and target sid here?
 
-	storage::log_diff(log, "userdata", userdata, rhs.userdata);
+	storage::log_diff(log, "userdata", *userdata, *rhs.userdata);
     }
 
 
@@ -248,8 +285,8 @@ namespace storage
 	out << get_classname() << " source-sid:" << get_source_sid()
 	    << " target-sid:" << get_target_sid();
 
-	if (!userdata.empty())
-	    out << " userdata:" << userdata;
+	if (!userdata->empty())
+	    out << " userdata:" << *userdata;
     }
 
 
@@ -29,6 +29,7 @@
 #include <type_traits>
 
 #include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/CopyOnWrite.h"
 #include "storage/Holders/Holder.h"
 #include "storage/DevicegraphImpl.h"
 #include "storage/ActiongraphImpl.h"
@@ -72,6 +73,13 @@ namespace storage
 
 	virtual void save(xmlNode* node) const = 0;
 
+	/**
+	 * Hash of everything compared by equal(). Holders with different
+	 * content hashes are not equal. Calculated when needed and cached
+	 * until the next about_to_modify().
+	 */
+	size_t get_content_hash() const;
+
 	void set_devicegraph_and_edge(Devicegraph* devicegraph,
 				      Devicegraph::Impl::edge_descriptor edge);
 
@@ -95,8 +103,8 @@ namespace storage
 
 	sid_t get_target_sid() const;
 
-	const map<string, string>& get_userdata() const { return userdata; }
-	void set_userdata(const map<string, string>& userdata) { Impl::userdata = userdata; }
+	const map<string, string>& get_userdata() const { return *userdata; }
+	void set_userdata(const map<string, string>& userdata) { about_to_modify(); Impl::userdata = userdata; }
 
 	/**
 	 * Add create actions for the Holder.
@@ -122,6 +130,13 @@ namespace storage
 				      Actiongraph::Impl& actiongraph) const {}
 
 	virtual bool equal(const Impl& rhs) const = 0;
+
+	/**
+	 * Calculates the content hash from the same attributes equal()
+	 * compares. Classes extending equal() must also extend this.
+	 */
+	virtual size_t calculate_content_hash() const;
+
 	virtual void log_diff(std::ostream& log, const Impl& rhs) const = 0;
 	virtual void print(std::ostream& out) const = 0;
 
@@ -139,12 +154,23 @@ namespace storage
 
 	Impl(const xmlNode* node);
 
+	/**
+	 * Must be called by all functions modifying the holder before the
+	 * modification, see Devicegraph::Impl::record_change(). Also
+	 * invalidates the content hash.
+	 */
+	void about_to_modify();
+
     private:
 
 	Devicegraph* devicegraph = nullptr;
 	Devicegraph::Impl::edge_descriptor edge;
 
-	map<string, string> userdata;
+	CopyOnWrite<map<string, string>> userdata;
+
+	// Cache for get_content_hash().
+	mutable size_t content_hash = 0;
+	mutable bool content_hash_valid = false;
 
     };
 
@@ -20,6 +20,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Holders/MdSubdeviceImpl.h"
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/StorageTmpl.h"
@@ -60,6 +62,17 @@ namespace storage
     }
 
 
+    size_t
+    MdSubdevice::Impl::calculate_content_hash() const
+    {
+	size_t seed = Subdevice::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, member);
+
+	return seed;
+    }
+
+
     void
     MdSubdevice::Impl::log_diff(std::ostream& log, const Holder::Impl& rhs_base) const
     {
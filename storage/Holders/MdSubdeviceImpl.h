@@ -49,11 +49,12 @@ namespace storage
 	virtual const char* get_classname() const override { return HolderTraits<MdSubdevice>::classname; }
 
 	virtual bool equal(const Holder::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Holder::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
 	const string& get_member() const { return member; }
-	void set_member(const string& member) { Impl::member = member; }
+	void set_member(const string& member) { about_to_modify(); Impl::member = member; }
 
     private:
 
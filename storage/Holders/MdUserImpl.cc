@@ -20,6 +20,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Holders/MdUserImpl.h"
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/StorageTmpl.h"
@@ -68,6 +70,20 @@ namespace storage
     }
 
 
+    size_t
+    MdUser::Impl::calculate_content_hash() const
+    {
+	size_t seed = User::Impl::calculate_content_hash();
+
+	boost::hash_combine(seed, spare);
+	boost::hash_combine(seed, faulty);
+	boost::hash_combine(seed, journal);
+	boost::hash_combine(seed, sort_key);
+
+	return seed;
+    }
+
+
     void
     MdUser::Impl::log_diff(std::ostream& log, const Holder::Impl& rhs_base) const
     {
@@ -105,6 +121,8 @@ namespace storage
     void
     MdUser::Impl::set_spare(bool spare)
     {
+	about_to_modify();
+
         if (Impl::spare == spare)
 	    return;
 
@@ -117,6 +135,8 @@ namespace storage
     void
     MdUser::Impl::set_faulty(bool faulty)
     {
+	about_to_modify();
+
 	if (Impl::faulty == faulty)
 	    return;
 
@@ -129,6 +149,8 @@ namespace storage
     void
     MdUser::Impl::set_journal(bool journal)
     {
+	about_to_modify();
+
 	if (Impl::journal == journal)
 	    return;
 
@@ -141,6 +163,8 @@ namespace storage
     void
     MdUser::Impl::recalculate()
     {
+	about_to_modify();
+
 	Md* md = to_md(get_target());
 	md->get_impl().calculate_region_and_topology();
     }
@@ -49,6 +49,7 @@ namespace storage
 	virtual const char* get_classname() const override { return HolderTraits<MdUser>::classname; }
 
 	virtual bool equal(const Holder::Impl& rhs) const override;
+	virtual size_t calculate_content_hash() const override;
 	virtual void log_diff(std::ostream& log, const Holder::Impl& rhs_base) const override;
 	virtual void print(std::ostream& out) const override;
 
@@ -62,7 +63,7 @@ namespace storage
 	void set_journal(bool journal);
 
 	unsigned int get_sort_key() const { return sort_key; }
-	void set_sort_key(unsigned int sort_key) { Impl::sort_key = sort_key; }
+	void set_sort_key(unsigned int sort_key) { about_to_modify(); Impl::sort_key = sort_key; }
 
     private:
 
@@ -21,6 +21,9 @@
  */
 
 
+#include <future>
+#include <unordered_map>
+
 #include "config.h"
 #include "storage/Utils/AppUtil.h"
 #include "storage/Utils/Mockup.h"
@@ -34,11 +37,12 @@
 #include "storage/Devices/LuksImpl.h"
 #include "storage/Pool.h"
 #include "storage/SystemInfo/SystemInfo.h"
-#include "storage/Actiongraph.h"
+#include "storage/ActiongraphImpl.h"
 #include "storage/Prober.h"
 #include "storage/EnvironmentImpl.h"
 #include "storage/Utils/Format.h"
 #include "storage/Utils/CallbacksImpl.h"
+#include "storage/Utils/LoggerImpl.h"
 
 
 namespace storage
@@ -391,38 +395,129 @@ namespace storage
     }
 
 
+    namespace
+    {
+
+	/**
+	 * Minimal number of devices in all devicegraphs for checking the
+	 * devicegraphs in parallel.
+	 */
+	const size_t parallel_check_threshold = 1000;
+
+
+	/**
+	 * Result of the check of one devicegraph in a worker thread. The log
+	 * messages, the errors reported to the check callbacks and the
+	 * exception are passed on by the main thread.
+	 */
+	class CheckResult : public CheckCallbacks
+	{
+	public:
+
+	    CheckResult() : exception(nullptr) {}
+
+	    virtual void error(const string& message) const override { errors.push_back(message); }
+
+	    LogBuffer log_buffer;
+	    mutable vector<string> errors;
+	    std::exception_ptr exception;
+
+	};
+
+
+	void
+	check_devicegraph(const Devicegraph* devicegraph, bool with_callbacks, CheckResult* check_result)
+	{
+	    LogRedirect log_redirect(check_result->log_buffer);
+
+	    try
+	    {
+		devicegraph->check(with_callbacks ? check_result : nullptr);
+	    }
+	    catch (...)
+	    {
+		check_result->exception = std::current_exception();
+	    }
+	}
+
+    }
+
+
     void
     Storage::Impl::check(const CheckCallbacks* check_callbacks) const
     {
 	// check all devicegraphs
 
+	// Small devicegraphs are checked sequentially since starting threads
+	// costs more than the checks. Otherwise the devicegraphs are checked in
+	// parallel, one thread per devicegraph. Loggers and callbacks might be
+	// implemented by the bindings and are only called by the main thread in
+	// the order of the devicegraphs.
+
+	size_t num_devices = 0;
+	for (const devicegraphs_t::value_type& key_value : devicegraphs)
+	    num_devices += key_value.second.get_impl().num_devices();
+
+	if (devicegraphs.size() < 2 || num_devices < parallel_check_threshold)
+	{
+	    for (const devicegraphs_t::value_type& key_value : devicegraphs)
+		key_value.second.check(check_callbacks);
+	}
+	else
+	{
+	    vector<CheckResult> check_results(devicegraphs.size());
+	    vector<std::future<void>> futures;
+
+	    size_t i = 0;
+	    for (const devicegraphs_t::value_type& key_value : devicegraphs)
+	    {
+		futures.push_back(std::async(std::launch::async, check_devicegraph, &key_value.second,
+					     check_callbacks != nullptr, &check_results[i++]));
+	    }
+
+	    for (std::future<void>& future : futures)
+		future.wait();
+
+	    for (CheckResult& check_result : check_results)
+	    {
+		check_result.log_buffer.flush();
+
+		for (const string& error : check_result.errors)
+		    check_callbacks->error(error);
+
+		if (check_result.exception)
+		    std::rethrow_exception(check_result.exception);
+	    }
+	}
+
 	// check that all objects with the same sid have the same type in all
 	// devicegraphs
 
-	map<sid_t, set<string>> all_sids_with_types;
+	std::unordered_map<sid_t, string> all_sids_with_types;
 
 	for (const devicegraphs_t::value_type& key_value : devicegraphs)
 	{
 	    const Devicegraph& devicegraph = key_value.second;
 
-	    devicegraph.check(check_callbacks);
-
 	    for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph.get_impl().vertices())
 	    {
 		const Device* device = devicegraph.get_impl()[vertex];
-		all_sids_with_types[device->get_sid()].insert(device->get_impl().get_classname());
-	    }
-	}
 
-	for (const map<sid_t, set<string>>::value_type& key_value : all_sids_with_types)
-	{
-	    if (key_value.second.size() != 1)
-	    {
-		stringstream tmp;
-		tmp << key_value.second;
+		const string classname = device->get_impl().get_classname();
+
+		pair<std::unordered_map<sid_t, string>::iterator, bool> tmp =
+		    all_sids_with_types.emplace(device->get_sid(), classname);
+
+		if (!tmp.second && tmp.first->second != classname)
+		{
+		    set<string> classnames = { tmp.first->second, classname };
 
-		ST_THROW(Exception(sformat("objects with sid %d have different types %s",
-					   key_value.first, tmp.str())));
+		    stringstream tmp2;
+		    tmp2 << classnames;
+
+		    ST_THROW(Exception(sformat("objects with sid %d have different types %s",
+					       device->get_sid(), tmp2.str())));
+		}
 	    }
 	}
     }
@@ -444,13 +539,43 @@ namespace storage
     const Actiongraph*
     Storage::Impl::calculate_actiongraph()
     {
-	actiongraph.reset();	// free old actiongraph before generating new to avoid memory peak
+	// Frontends often calculate the actiongraph again without changing the
+	// devicegraphs in between. The actiongraph keeps pointers to the
+	// devicegraphs, so these must also still be the same objects. The
+	// checks are run again since they also cover the other devicegraphs.
+	// Any change calculates the whole actiongraph again.
+
+	if (actiongraph && actiongraph->get_impl().get_devicegraph(LHS) == get_system() &&
+	    actiongraph->get_impl().get_devicegraph(RHS) == get_staging() &&
+	    *actiongraph_system == *get_system() && *actiongraph_staging == *get_staging())
+	{
+	    y2mil("devicegraphs unchanged, reusing actiongraph");
+
+	    Actiongraph::Impl::check(storage);
+
+	    return actiongraph.get();
+	}
+
+	// free old actiongraph before generating new to avoid memory peak
+
+	actiongraph.reset();
+	actiongraph_system.reset();
+	actiongraph_staging.reset();
 
 	Actiongraph* tmp = new Actiongraph(storage, get_system(), get_staging());
 	tmp->generate_compound_actions();
 
 	actiongraph.reset(tmp);
 
+	// Generating the actiongraph can modify the staging devicegraph, so
+	// the copies are made afterwards.
+
+	actiongraph_system.reset(new Devicegraph(&storage));
+	get_system()->copy(*actiongraph_system);
+
+	actiongraph_staging.reset(new Devicegraph(&storage));
+	get_staging()->copy(*actiongraph_staging);
+
 	return tmp;
     }
 
@@ -173,6 +173,16 @@ namespace storage
 
 	std::unique_ptr<const Actiongraph> actiongraph;
 
+	/**
+	 * Copies of the system and staging devicegraphs when the
+	 * actiongraph was calculated. Used to reuse the actiongraph if
+	 * neither devicegraph changed since. Comparing first compares the
+	 * content hashes, see Devicegraph::Impl::operator==(), so usually
+	 * only unchanged devicegraphs are compared device by device.
+	 */
+	std::unique_ptr<Devicegraph> actiongraph_system;
+	std::unique_ptr<Devicegraph> actiongraph_staging;
+
 	TmpDir tmp_dir;
 
     };
@@ -68,7 +68,7 @@ namespace storage
     {
 	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK)
 	{
-	    const Mockup::File& mockup_file = Mockup::get_file(path);
+	    const Mockup::File mockup_file = Mockup::get_file(path);
 	    content = mockup_file.content;
 
 	    y2mil(*this);
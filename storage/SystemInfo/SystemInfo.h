@@ -25,6 +25,7 @@
 #define STORAGE_SYSTEM_INFO_H
 
 
+#include <mutex>
 #include <boost/noncopyable.hpp>
 
 #include "storage/EtcFstab.h"
@@ -56,7 +57,9 @@ namespace storage
     using std::map;
 
     /**
-     * Encapsulates system access, also for testsuite mocking
+     * Encapsulates system access, also for testsuite mocking. Thread-safe
+     * since actions are committed in parallel, see
+     * CommitOptions::max_parallel_actions.
      */
     class SystemInfo : private boost::noncopyable
     {
@@ -137,15 +140,19 @@ namespace storage
 
 	/* LazyObject, LazyObjects and LazyObjectsWithKey cache the object and
 	   a potential exception during object construction. HelperBase does
-	   the common part. */
+	   the common part. Each object is constructed only once even if
+	   requested by several threads, different objects can be
+	   constructed concurrently. */
 
 	template <class Object, typename... Args>
-	class HelperBase
+	class HelperBase : private boost::noncopyable
 	{
 	public:
 
 	    const Object& get(Args... args)
 	    {
+		std::lock_guard<std::mutex> lock(mutex);
+
 		if (ep)
 		    std::rethrow_exception(ep);
 
@@ -170,11 +177,13 @@ namespace storage
 	    std::shared_ptr<Object> object;
 	    std::exception_ptr ep;
 
+	    std::mutex mutex;
+
 	};
 
 
 	template <class Object>
-	class LazyObject : public HelperBase<Object>, private boost::noncopyable
+	class LazyObject : public HelperBase<Object>
 	{
 	};
 
@@ -188,9 +197,18 @@ namespace storage
 
 	    const Object& get(const Arg& arg)
 	    {
+		// The map is only locked while looking up the helper. Its
+		// elements are never erased, so the helper stays valid.
+
+		std::unique_lock<std::mutex> lock(mutex);
+
 		typename map<Arg, Helper>::iterator pos = data.lower_bound(arg);
 		if (pos == data.end() || typename map<Arg, Helper>::key_compare()(arg, pos->first))
-		    pos = data.insert(pos, typename map<Arg, Helper>::value_type(arg, Helper()));
+		    pos = data.emplace_hint(pos, std::piecewise_construct, std::forward_as_tuple(arg),
+					    std::forward_as_tuple());
+
+		lock.unlock();
+
 		return pos->second.get(arg);
 	    }
 
@@ -198,6 +216,8 @@ namespace storage
 
 	    map<Arg, Helper> data;
 
+	    std::mutex mutex;
+
 	};
 
 
@@ -212,15 +232,25 @@ namespace storage
 
 	    bool includes(const Key& key) const
 	    {
+		std::lock_guard<std::mutex> lock(mutex);
+
 		typename map<Key, Helper>::const_iterator pos = data.lower_bound(key);
 		return pos != data.end() && !typename map<Key, Helper>::key_compare()(key, pos->first);
 	    }
 
 	    const Object& get(const Key& key, Args... args)
 	    {
+		// See LazyObjects::get().
+
+		std::unique_lock<std::mutex> lock(mutex);
+
 		typename map<Key, Helper>::iterator pos = data.lower_bound(key);
 		if (pos == data.end() || typename map<Key, Helper>::key_compare()(key, pos->first))
-		    pos = data.insert(pos, typename map<Key, Helper>::value_type(key, Helper()));
+		    pos = data.emplace_hint(pos, std::piecewise_construct, std::forward_as_tuple(key),
+					    std::forward_as_tuple());
+
+		lock.unlock();
+
 		return pos->second.get(key, args...);
 	    }
 
@@ -228,6 +258,8 @@ namespace storage
 
 	    map<Key, Helper> data;
 
+	    mutable std::mutex mutex;
+
 	};
 
 	LazyObject<EtcFstab> etc_fstab;
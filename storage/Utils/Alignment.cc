@@ -20,6 +20,8 @@
  */
 
 
+#include <new>
+
 #include "storage/Utils/AlignmentImpl.h"
 
 
@@ -36,26 +38,27 @@ namespace storage
 
 
     Alignment::Alignment(const Topology& topology, AlignType align_type)
-	: impl(make_unique<Impl>(topology, align_type))
     {
+	new (&impl) Impl(topology, align_type);
     }
 
 
     Alignment::Alignment(const Alignment& alignment)
-	: impl(make_unique<Impl>(alignment.get_impl()))
     {
+	new (&impl) Impl(alignment.get_impl());
     }
 
 
     Alignment::~Alignment()
     {
+	get_impl().~Impl();
     }
 
 
     Alignment&
     Alignment::operator=(const Alignment& alignment)
     {
-	*impl = alignment.get_impl();
+	get_impl() = alignment.get_impl();
 	return *this;
     }
 
@@ -63,14 +66,17 @@ namespace storage
     Alignment::Impl&
     Alignment::get_impl()
     {
-        return *impl;
+	static_assert(sizeof(Impl) <= sizeof(impl) && alignof(Impl) <= alignof(decltype(impl)),
+		      "inline storage too small for Alignment::Impl");
+
+	return *reinterpret_cast<Impl*>(&impl);
     }
 
 
     const Alignment::Impl&
     Alignment::get_impl() const
     {
-        return *impl;
+	return *reinterpret_cast<const Impl*>(&impl);
     }
 
 
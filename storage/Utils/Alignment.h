@@ -24,6 +24,8 @@
 #define STORAGE_ALIGNMENT_H
 
 
+#include <type_traits>
+
 #include "storage/Utils/Topology.h"
 #include "storage/Utils/Region.h"
 #include "storage/Utils/Exception.h"
@@ -95,11 +97,9 @@ namespace storage
 
 	Alignment(const Topology& topology, AlignType align_type = AlignType::OPTIMAL);
 	Alignment(const Alignment& alignment);
-	Alignment(Alignment&& alignment) = default;
 	~Alignment();
 
 	Alignment& operator=(const Alignment& alignment);
-	Alignment& operator=(Alignment&& alignment) = default;
 
 	/**
 	 * Checks whether a region can be aligned. Alignment may fail if the
@@ -127,7 +127,11 @@ namespace storage
 
     private:
 
-	const std::unique_ptr<Impl> impl;
+	/**
+	 * The Impl is constructed in place with one spare word, see Region.
+	 */
+	std::aligned_storage<sizeof(long) + sizeof(Topology) + 2 * sizeof(unsigned long),
+			     alignof(Topology)>::type impl;
 
     };
 
@@ -54,7 +54,7 @@ namespace storage
     {
 	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK)
 	{
-	    const Mockup::File& mockup_file = Mockup::get_file(name);
+	    const Mockup::File mockup_file = Mockup::get_file(name);
 	    lines = mockup_file.content;
 	    return true;
 	}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2026 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_COPY_ON_WRITE_H
+#define STORAGE_COPY_ON_WRITE_H
+
+
+#include <memory>
+#include <atomic>
+#include <boost/functional/hash.hpp>
+
+
+namespace storage
+{
+
+    /**
+     * Holds a value that is shared between copies until one of the copies
+     * is modified. Used for payloads of devices and holders that are
+     * copied with every devicegraph but are seldom changed.
+     *
+     * A default constructed object holds a default constructed value without
+     * allocating memory.
+     *
+     * Objects sharing a value can be used by different threads, e.g. when
+     * devicegraphs are checked in parallel. A single object must not be
+     * modified while other threads use it, like any other object.
+     */
+    template <typename Type>
+    class CopyOnWrite
+    {
+    public:
+
+	CopyOnWrite() = default;
+
+	CopyOnWrite(const Type& value)
+	    : ptr(std::make_shared<Type>(value)) {}
+
+	CopyOnWrite(Type&& value)
+	    : ptr(std::make_shared<Type>(std::move(value))) {}
+
+	CopyOnWrite& operator=(const Type& value)
+	{
+	    ptr = std::make_shared<Type>(value);
+	    return *this;
+	}
+
+	CopyOnWrite& operator=(Type&& value)
+	{
+	    ptr = std::make_shared<Type>(std::move(value));
+	    return *this;
+	}
+
+	const Type& operator*() const { return ptr ? *ptr : empty_value(); }
+	const Type* operator->() const { return &operator*(); }
+
+	/**
+	 * Return a modifiable reference to the value. If the value is shared
+	 * it is cloned first.
+	 */
+	Type& get_for_write()
+	{
+	    if (!ptr)
+	    {
+		ptr = std::make_shared<Type>();
+	    }
+	    else if (ptr.use_count() > 1)
+	    {
+		ptr = std::make_shared<Type>(*ptr);
+	    }
+	    else
+	    {
+		// use_count() is only a relaxed load. If another object
+		// stopped sharing the value just now, e.g. since it cloned it
+		// in another thread, its reads of the value must happen before
+		// the modification. The fence pairs with the release when the
+		// other object dropped its reference.
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+	    }
+
+	    return *ptr;
+	}
+
+	/**
+	 * Checks whether the value is shared with other objects. Only a
+	 * snapshot if objects sharing the value are used by other threads.
+	 */
+	bool is_shared() const { return ptr && ptr.use_count() > 1; }
+
+	bool operator==(const CopyOnWrite& rhs) const
+	{
+	    return ptr == rhs.ptr || operator*() == *rhs;
+	}
+
+	bool operator!=(const CopyOnWrite& rhs) const { return !(*this == rhs); }
+
+	friend size_t hash_value(const CopyOnWrite& copy_on_write)
+	{
+	    return boost::hash<Type>()(*copy_on_write);
+	}
+
+    private:
+
+	static const Type& empty_value()
+	{
+	    static const Type empty;
+	    return empty;
+	}
+
+	std::shared_ptr<Type> ptr;
+
+    };
+
+}
+
+
+#endif
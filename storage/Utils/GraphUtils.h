@@ -25,13 +25,11 @@
 
 
 #include <vector>
-#include <map>
 
 
 namespace storage
 {
     using std::vector;
-    using std::map;
 
 
     class CycleDetector : public boost::default_dfs_visitor
@@ -73,47 +71,6 @@ namespace storage
 
     };
 
-
-    /*
-     * Generates a vertex index (0 <= index < number of vertices) map.
-     *
-     * With VertexList=listS the adjacency_list does not automatically have a
-     * vertex_index property.  Since some algorithm we use need that property
-     * we have to create it ourself.  See:
-     * http://www.boost.org/doc/libs/1_56_0/libs/graph/doc/faq.html
-     */
-    template <typename Graph>
-    class VertexIndexMapGenerator
-    {
-    public:
-
-	typedef map<typename Graph::vertex_descriptor, typename Graph::vertices_size_type> vertex_index_map_t;
-
-	VertexIndexMapGenerator(const Graph& graph)
-	    : graph(graph), vertex_index_property_map(vertex_index_map)
-	{
-	    typename Graph::vertices_size_type cnt = 0;
-
-	    typename Graph::vertex_iterator vi, vi_end;
-	    for (boost::tie(vi, vi_end) = boost::vertices(graph); vi != vi_end; ++vi)
-		boost::put(vertex_index_property_map, *vi, cnt++);
-	}
-
-	const boost::associative_property_map<vertex_index_map_t>& get() const
-	{
-	    return vertex_index_property_map;
-	}
-
-    private:
-
-	const Graph& graph;
-
-	vertex_index_map_t vertex_index_map;
-
-	boost::associative_property_map<vertex_index_map_t> vertex_index_property_map;
-
-    };
-
 }
 
 #endif
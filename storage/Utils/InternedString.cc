@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+
+#include <mutex>
+#include <unordered_map>
+#include <tuple>
+
+#include "storage/Utils/InternedString.h"
+
+
+namespace storage
+{
+
+    namespace
+    {
+
+	// The elements of an unordered_map are never moved, so pointers to
+	// them stay valid. The table and its mutex are intentionally never
+	// destroyed since interned strings can be used by static objects.
+
+	std::unordered_map<string, std::atomic<unsigned int>>&
+	get_table()
+	{
+	    static std::unordered_map<string, std::atomic<unsigned int>>* table =
+		new std::unordered_map<string, std::atomic<unsigned int>>();
+
+	    return *table;
+	}
+
+
+	std::mutex&
+	get_mutex()
+	{
+	    static std::mutex* mutex = new std::mutex();
+
+	    return *mutex;
+	}
+
+    }
+
+
+    InternedString::Entry*
+    InternedString::intern(const string& s)
+    {
+	std::lock_guard<std::mutex> lock(get_mutex());
+
+	Entry* entry = &*get_table().emplace(std::piecewise_construct, std::forward_as_tuple(s),
+					     std::forward_as_tuple(0)).first;
+	acquire(entry);
+
+	return entry;
+    }
+
+
+    void
+    InternedString::release(Entry* entry)
+    {
+	// As long as other references exist the count is decreased without
+	// locking. Only the last reference takes the lock, so that intern()
+	// cannot hand out the entry while it is removed.
+
+	unsigned int count = entry->second.load(std::memory_order_relaxed);
+	while (count > 1)
+	{
+	    if (entry->second.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel))
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(get_mutex());
+
+	if (--entry->second == 0)
+	{
+	    std::unordered_map<string, std::atomic<unsigned int>>& table = get_table();
+	    table.erase(table.find(entry->first));
+	}
+    }
+
+
+    InternedString::Entry*
+    InternedString::empty_entry()
+    {
+	// The reference held here keeps the empty string in the table.
+
+	static Entry* empty = intern(string());
+
+	return empty;
+    }
+
+
+    size_t
+    InternedString::num_interned()
+    {
+	std::lock_guard<std::mutex> lock(get_mutex());
+
+	return get_table().size();
+    }
+
+}
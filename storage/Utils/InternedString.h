@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+
+#ifndef STORAGE_INTERNED_STRING_H
+#define STORAGE_INTERNED_STRING_H
+
+
+#include <string>
+#include <ostream>
+#include <atomic>
+#include <utility>
+
+
+namespace storage
+{
+    using std::string;
+
+
+    /**
+     * A string stored only once in a process-wide table. Copying and
+     * comparing interned strings only copies and compares a pointer and
+     * never allocates memory. Used for strings like device names that are
+     * copied with every devicegraph.
+     *
+     * The strings in the table are reference counted and removed when the
+     * last interned string referring to them is destroyed. Creating,
+     * copying and destroying interned strings is thread safe, reading them
+     * needs no locking.
+     */
+    class InternedString
+    {
+    public:
+
+	InternedString() : entry(empty_entry()) { acquire(entry); }
+
+	InternedString(const string& s) : entry(intern(s)) {}
+
+	InternedString(const InternedString& interned_string)
+	    : entry(interned_string.entry)
+	{
+	    acquire(entry);
+	}
+
+	~InternedString() { release(entry); }
+
+	InternedString& operator=(const InternedString& interned_string)
+	{
+	    if (entry != interned_string.entry)
+	    {
+		acquire(interned_string.entry);
+		release(entry);
+		entry = interned_string.entry;
+	    }
+
+	    return *this;
+	}
+
+	InternedString& operator=(const string& s)
+	{
+	    Entry* tmp = intern(s);
+	    release(entry);
+	    entry = tmp;
+	    return *this;
+	}
+
+	const string& get() const { return entry->first; }
+
+	bool empty() const { return entry->first.empty(); }
+
+	bool operator==(const InternedString& rhs) const { return entry == rhs.entry; }
+	bool operator!=(const InternedString& rhs) const { return entry != rhs.entry; }
+
+	friend size_t hash_value(const InternedString& interned_string)
+	{
+	    return std::hash<string>()(interned_string.get());
+	}
+
+	friend std::ostream& operator<<(std::ostream& s, const InternedString& interned_string)
+	{
+	    return s << interned_string.get();
+	}
+
+	/**
+	 * Number of strings in the table.
+	 */
+	static size_t num_interned();
+
+    private:
+
+	typedef std::pair<const string, std::atomic<unsigned int>> Entry;
+
+	/**
+	 * Finds or inserts the string in the table and increases its
+	 * reference count.
+	 */
+	static Entry* intern(const string& s);
+
+	static Entry* empty_entry();
+
+	static void acquire(Entry* entry) { entry->second.fetch_add(1, std::memory_order_relaxed); }
+
+	/**
+	 * Decreases the reference count of the entry and removes it from
+	 * the table if it drops to zero.
+	 */
+	static void release(Entry* entry);
+
+	Entry* entry;
+
+    };
+
+}
+
+
+#endif
@@ -31,10 +31,17 @@ namespace storage
 
     static const string& component = "libstorage";
 
+    static thread_local LogBuffer* log_buffer = nullptr;
+
 
     bool
     query_log_level(LogLevel log_level)
     {
+	// The log level is tested when the buffer is flushed.
+
+	if (log_buffer)
+	    return true;
+
 	Logger* logger = get_logger();
 	if (logger)
 	{
@@ -67,6 +74,13 @@ namespace storage
     close_log_stream(LogLevel log_level, const char* file, unsigned line, const char* func,
 		     ostringstream* stream)
     {
+	if (log_buffer)
+	{
+	    log_buffer->entries.push_back({ log_level, file, line, func, stream->str() });
+	    delete stream;
+	    return;
+	}
+
 	Logger* logger = get_logger();
 	if (logger)
 	{
@@ -87,4 +101,34 @@ namespace storage
 	delete stream;
     }
 
+
+
+    void
+    LogBuffer::flush()
+    {
+	for (const Entry& entry : entries)
+	{
+	    if (query_log_level(entry.log_level))
+	    {
+		ostringstream* stream = open_log_stream();
+		*stream << entry.content;
+		close_log_stream(entry.log_level, entry.file, entry.line, entry.func, stream);
+	    }
+	}
+
+	entries.clear();
+    }
+
+
+    LogRedirect::LogRedirect(LogBuffer& log_buffer)
+    {
+	storage::log_buffer = &log_buffer;
+    }
+
+
+    LogRedirect::~LogRedirect()
+    {
+	storage::log_buffer = nullptr;
+    }
+
 }
@@ -26,6 +26,8 @@
 
 
 #include <sstream>
+#include <vector>
+#include <boost/noncopyable.hpp>
 
 #include "storage/Utils/Logger.h"
 
@@ -40,6 +42,54 @@ namespace storage
     void close_log_stream(LogLevel log_level, const char* file, unsigned line,
 			  const char* func, std::ostringstream*);
 
+
+    /**
+     * Collects the log messages of a thread while a LogRedirect for it
+     * exists. The logger, which might be implemented by the bindings, is
+     * only called by flush() so worker threads never call it.
+     */
+    class LogBuffer : private boost::noncopyable
+    {
+    public:
+
+	/**
+	 * Writes the collected messages to the logger. Must be called by
+	 * the main thread.
+	 */
+	void flush();
+
+    private:
+
+	friend void close_log_stream(LogLevel log_level, const char* file, unsigned line,
+				     const char* func, std::ostringstream*);
+
+	struct Entry
+	{
+	    LogLevel log_level;
+	    const char* file;
+	    unsigned line;
+	    const char* func;
+	    std::string content;
+	};
+
+	std::vector<Entry> entries;
+
+    };
+
+
+    /**
+     * Redirects the log messages of the current thread into the log buffer
+     * during the lifetime of the object.
+     */
+    class LogRedirect : private boost::noncopyable
+    {
+    public:
+
+	LogRedirect(LogBuffer& log_buffer);
+	~LogRedirect();
+
+    };
+
 #define y2deb(op) y2log_op(storage::LogLevel::DEBUG, __FILE__, __LINE__, __FUNCTION__, op)
 #define y2mil(op) y2log_op(storage::LogLevel::MILESTONE, __FILE__, __LINE__, __FUNCTION__, op)
 #define y2war(op) y2log_op(storage::LogLevel::WARNING, __FILE__, __LINE__, __FUNCTION__, op)
@@ -21,6 +21,8 @@
  */
 
 
+#include <mutex>
+
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/ExceptionImpl.h"
@@ -31,96 +33,106 @@
 namespace storage
 {
 
+    namespace
+    {
+	// Commands and files can be queried and set by several threads
+	// during a parallel commit.
+
+	std::mutex mockup_mutex;
+    }
+
+
     void
     Mockup::load(const string& filename)
     {
-	XmlFile xml(filename);
+	XmlStreamReader xml(filename);
 
-	const xmlNode* root_node = xml.getRootElement();
-	if (!root_node)
-	    ST_THROW(Exception("root node not found"));
+	xml.read("Mockup", [](const string& section, const xmlNode* entry_node) {
 
-	const xmlNode* mockup_node = getChildNode(root_node, "Mockup");
-	if (!mockup_node)
-	    ST_THROW(Exception("Mockup node not found"));
+	    const xmlNode* node = entry_node->children;
+	    if (!node)
+		return;
 
-	const xmlNode* commands_node = getChildNode(mockup_node, "Commands");
-	if (commands_node)
-	{
-	    for (const xmlNode* command_node : getChildNodes(commands_node))
-	    {
-		vector<string> names;
-		getChildValue(command_node, "name", names);
+	    if (section == "Commands")
+		load_command(node);
+	    else if (section == "Files")
+		load_file(node);
 
-		if (names.empty())
-		    ST_THROW(Exception("no name for command found"));
+	});
+    }
 
-		Command command;
-		getChildValue(command_node, "stdout", command.stdout);
-		getChildValue(command_node, "stderr", command.stderr);
-		getChildValue(command_node, "exit-code", command.exit_code);
 
-#ifdef OCCAMS_RAZOR
-		// Unfortunately the check is not so effective as one
-		// might expected since the output of udevadm info is
-		// often sorted differently depending on the
-		// parameter.
+    void
+    Mockup::load_command(const xmlNode* command_node)
+    {
+	vector<string> names;
+	getChildValue(command_node, "name", names);
 
-		if (command.stdout.size() > threshold)
-		{
-		    for (const map<string, Command>::value_type& tmp : commands)
-		    {
-			if (tmp.second == command)
-			{
-			    y2err("identical commands in mockup '" << tmp.first << "' and '" << names[0]);
-			    ST_THROW(Exception("Occam's Razor"));
-			}
-		    }
-		}
-#endif
+	if (names.empty())
+	    ST_THROW(Exception("no name for command found"));
+
+	Command command;
+	getChildValue(command_node, "stdout", command.stdout);
+	getChildValue(command_node, "stderr", command.stderr);
+	getChildValue(command_node, "exit-code", command.exit_code);
 
-		for (const string& name : names)
+#ifdef OCCAMS_RAZOR
+	// Unfortunately the check is not so effective as one
+	// might expected since the output of udevadm info is
+	// often sorted differently depending on the
+	// parameter.
+
+	if (command.stdout.size() > threshold)
+	{
+	    for (const map<string, Command>::value_type& tmp : commands)
+	    {
+		if (tmp.second == command)
 		{
-		    if (!commands.emplace(name, command).second)
-			ST_THROW(Exception(sformat("command \"%s\" already loaded for mockup", name)));
+		    y2err("identical commands in mockup '" << tmp.first << "' and '" << names[0]);
+		    ST_THROW(Exception("Occam's Razor"));
 		}
 	    }
 	}
+#endif
 
-	const xmlNode* files_node = getChildNode(mockup_node, "Files");
-	if (files_node)
+	for (const string& name : names)
 	{
-	    for (const xmlNode* file_node : getChildNodes(files_node))
-	    {
-		vector<string> names;
-		getChildValue(file_node, "name", names);
+	    if (!commands.emplace(name, command).second)
+		ST_THROW(Exception(sformat("command \"%s\" already loaded for mockup", name)));
+	}
+    }
+
+
+    void
+    Mockup::load_file(const xmlNode* file_node)
+    {
+	vector<string> names;
+	getChildValue(file_node, "name", names);
 
-		if (names.empty())
-		    ST_THROW(Exception("no name for file found"));
+	if (names.empty())
+	    ST_THROW(Exception("no name for file found"));
 
-		File file;
-		getChildValue(file_node, "content", file.content);
+	File file;
+	getChildValue(file_node, "content", file.content);
 
 #ifdef OCCAMS_RAZOR
-		if (file.content.size() > threshold)
+	if (file.content.size() > threshold)
+	{
+	    for (const map<string, File>::value_type& tmp : files)
+	    {
+		if (tmp.second == file)
 		{
-		    for (const map<string, File>::value_type& tmp : files)
-		    {
-			if (tmp.second == file)
-			{
-			    y2err("identical files in mockup '" << tmp.first << "' and '" << names[0]);
-			    ST_THROW(Exception("Occam's Razor"));
-			}
-		    }
+		    y2err("identical files in mockup '" << tmp.first << "' and '" << names[0]);
+		    ST_THROW(Exception("Occam's Razor"));
 		}
+	    }
+	}
 #endif
 
-		for (const string& name : names)
-		{
-		    if (!files.emplace(name, file).second)
-			ST_THROW(Exception(sformat("file \"%s\" already loaded for mockup", name)));
-		}
-	    }
+	for (const string& name : names)
+	{
+	    if (!files.emplace(name, file).second)
+		ST_THROW(Exception(sformat("file \"%s\" already loaded for mockup", name)));
 	}
     }
 
@@ -171,13 +183,17 @@ namespace storage
     bool
     Mockup::has_command(const string& name)
     {
+	std::lock_guard<std::mutex> lock(mockup_mutex);
+
 	return commands.find(name) != commands.end();
     }
 
 
-    const Mockup::Command&
+    Mockup::Command
     Mockup::get_command(const string& name)
     {
+	std::lock_guard<std::mutex> lock(mockup_mutex);
+
 	map<string, Command>::const_iterator it = commands.find(name);
 	if (it == commands.end())
 	    ST_THROW(Exception("no mockup found for command '" + name + "'"));
@@ -193,6 +209,8 @@ namespace storage
     void
     Mockup::set_command(const string& name, const Command& command)
     {
+	std::lock_guard<std::mutex> lock(mockup_mutex);
+
 	commands[name] = command;
     }
 
@@ -200,6 +218,8 @@ namespace storage
     void
     Mockup::erase_command(const string& name)
     {
+	std::lock_guard<std::mutex> lock(mockup_mutex);
+
 	commands.erase(name);
     }
 
@@ -207,13 +227,17 @@ namespace storage
     bool
     Mockup::has_file(const string& name)
     {
+	std::lock_guard<std::mutex> lock(mockup_mutex);
+
 	return files.find(name) != files.end();
     }
 
 
-    const Mockup::File&
+    Mockup::File
     Mockup::get_file(const string& name)
     {
+	std::lock_guard<std::mutex> lock(mockup_mutex);
+
 	map<string, File>::const_iterator it = files.find(name);
 	if (it == files.end())
 	    ST_THROW(Exception("no mockup found for file '" + name + "'"));
@@ -229,6 +253,8 @@ namespace storage
     void
     Mockup::set_file(const string& name, const File& file)
     {
+	std::lock_guard<std::mutex> lock(mockup_mutex);
+
 	files[name] = file;
     }
 
@@ -236,6 +262,8 @@ namespace storage
     void
     Mockup::erase_file(const string& name)
     {
+	std::lock_guard<std::mutex> lock(mockup_mutex);
+
 	files.erase(name);
     }
 
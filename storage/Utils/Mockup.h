@@ -28,6 +28,7 @@
 #include <string>
 #include <map>
 #include <set>
+#include <libxml/tree.h>
 
 #include "storage/Utils/Remote.h"
 
@@ -69,13 +70,16 @@ namespace storage
 	static void load(const string& filename);
 	static void save(const string& filename);
 
+	// The getters return copies since the commands and files can be
+	// modified concurrently, e.g. during a parallel commit.
+
 	static bool has_command(const string& name);
-	static const Command& get_command(const string& name);
+	static Command get_command(const string& name);
 	static void set_command(const string& name, const Command& command);
 	static void erase_command(const string& name);
 
 	static bool has_file(const string& name);
-	static const File& get_file(const string& name);
+	static File get_file(const string& name);
 	static void set_file(const string& name, const File& file);
 	static void erase_file(const string& name);
 
@@ -83,6 +87,9 @@ namespace storage
 
     private:
 
+	static void load_command(const xmlNode* command_node);
+	static void load_file(const xmlNode* file_node);
+
 	static Mode mode;
 
 	static map<string, Command> commands;
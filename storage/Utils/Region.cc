@@ -21,6 +21,8 @@
  */
 
 
+#include <new>
+
 #include "storage/Utils/RegionImpl.h"
 #include "storage/Utils/Format.h"
 
@@ -53,32 +55,33 @@ namespace storage
 
 
     Region::Region()
-	: impl(make_unique<Impl>())
     {
+	new (&impl) Impl();
     }
 
 
     Region::Region(unsigned long long start, unsigned long long len, unsigned int block_size)
-        : impl(make_unique<Impl>(start, len, block_size))
     {
+	new (&impl) Impl(start, len, block_size);
     }
 
 
     Region::Region(const Region& region)
-	: impl(make_unique<Impl>(region.get_impl()))
     {
+	new (&impl) Impl(region.get_impl());
     }
 
 
     Region::~Region()
     {
+	get_impl().~Impl();
     }
 
 
     Region&
     Region::operator=(const Region& region)
     {
-	*impl = region.get_impl();
+	get_impl() = region.get_impl();
 	return *this;
     }
 
@@ -86,14 +89,17 @@ namespace storage
     Region::Impl&
     Region::get_impl()
     {
-        return *impl;
+	static_assert(sizeof(Impl) <= sizeof(impl) && alignof(Impl) <= alignof(decltype(impl)),
+		      "inline storage too small for Region::Impl");
+
+	return *reinterpret_cast<Impl*>(&impl);
     }
 
 
     const Region::Impl&
     Region::get_impl() const
     {
-        return *impl;
+	return *reinterpret_cast<const Impl*>(&impl);
     }
 
 
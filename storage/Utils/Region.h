@@ -26,7 +26,7 @@
 
 
 #include <libxml/tree.h>
-#include <memory>
+#include <type_traits>
 #include <vector>
 
 #include "storage/Utils/Exception.h"
@@ -77,11 +77,9 @@ namespace storage
 	Region();
 	Region(unsigned long long start, unsigned long long length, unsigned int block_size);
 	Region(const Region& region);
-	Region(Region&& region) = default;
 	~Region();
 
 	Region& operator=(const Region& region);
-	Region& operator=(Region&& region) = default;
 
 	bool empty() const;
 
@@ -213,7 +211,13 @@ namespace storage
 
     private:
 
-	const std::unique_ptr<Impl> impl;
+	/**
+	 * The Impl is constructed in place to avoid a heap allocation for
+	 * every Region. Region.cc checks that the Impl fits. The size of the
+	 * storage is part of the ABI of libstorage-ng.so.2 and includes one
+	 * spare word, so the Impl can grow without a new soname.
+	 */
+	std::aligned_storage<4 * sizeof(unsigned long long), alignof(unsigned long long)>::type impl;
 
     };
 
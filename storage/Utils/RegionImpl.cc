@@ -22,6 +22,7 @@
 
 
 #include <functional>
+#include <boost/functional/hash.hpp>
 
 #include "storage/Utils/RegionImpl.h"
 #include "storage/Utils/ExceptionImpl.h"
@@ -134,6 +135,19 @@ namespace storage
     }
 
 
+    size_t
+    hash_value(const Region::Impl& impl)
+    {
+	size_t seed = 0;
+
+	boost::hash_combine(seed, impl.start);
+	boost::hash_combine(seed, impl.length);
+	boost::hash_combine(seed, impl.block_size);
+
+	return seed;
+    }
+
+
     bool
     Region::Impl::operator<(const Impl& rhs) const
     {
@@ -62,6 +62,8 @@ namespace storage
 	bool operator==(const Impl& rhs) const;
 	bool operator!=(const Impl& rhs) const { return !(*this == rhs); }
 
+	friend size_t hash_value(const Impl& impl);
+
 	bool operator<(const Impl& rhs) const;
 	bool operator>(const Impl& rhs) const { return rhs < *this; }
 	bool operator<=(const Impl& rhs) const { return !(*this > rhs); }
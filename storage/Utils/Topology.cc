@@ -20,6 +20,8 @@
  */
 
 
+#include <new>
+
 #include "storage/Utils/TopologyImpl.h"
 
 
@@ -28,32 +30,33 @@ namespace storage
 
 
     Topology::Topology()
-	: impl(make_unique<Impl>())
     {
+	new (&impl) Impl();
     }
 
 
     Topology::Topology(long alignment_offset, unsigned long optimal_io_size)
-	: impl(make_unique<Impl>(alignment_offset, optimal_io_size))
     {
+	new (&impl) Impl(alignment_offset, optimal_io_size);
     }
 
 
     Topology::Topology(const Topology& topology)
-	: impl(make_unique<Impl>(topology.get_impl()))
     {
+	new (&impl) Impl(topology.get_impl());
     }
 
 
     Topology::~Topology()
     {
+	get_impl().~Impl();
     }
 
 
     Topology&
     Topology::operator=(const Topology& topology)
     {
-	*impl = topology.get_impl();
+	get_impl() = topology.get_impl();
 	return *this;
     }
 
@@ -61,14 +64,17 @@ namespace storage
     Topology::Impl&
     Topology::get_impl()
     {
-        return *impl;
+	static_assert(sizeof(Impl) <= sizeof(impl) && alignof(Impl) <= alignof(decltype(impl)),
+		      "inline storage too small for Topology::Impl");
+
+	return *reinterpret_cast<Impl*>(&impl);
     }
 
 
     const Topology::Impl&
     Topology::get_impl() const
     {
-        return *impl;
+	return *reinterpret_cast<const Impl*>(&impl);
     }
 
 
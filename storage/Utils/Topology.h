@@ -25,7 +25,7 @@
 
 
 #include <libxml/tree.h>
-#include <memory>
+#include <type_traits>
 #include <ostream>
 
 
@@ -42,11 +42,9 @@ namespace storage
 	Topology();
 	Topology(long alignment_offset, unsigned long optimal_io_size);
 	Topology(const Topology& topology);
-	Topology(Topology&& topology) = default;
 	~Topology();
 
 	Topology& operator=(const Topology& topology);
-	Topology& operator=(Topology&& topology) = default;
 
 	long get_alignment_offset() const;
 	void set_alignment_offset(long alignment_offset);
@@ -74,7 +72,10 @@ namespace storage
 
     private:
 
-	const std::unique_ptr<Impl> impl;
+	/**
+	 * The Impl is constructed in place with one spare word, see Region.
+	 */
+	std::aligned_storage<4 * sizeof(long), alignof(long)>::type impl;
 
     };
 
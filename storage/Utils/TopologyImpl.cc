@@ -20,6 +20,8 @@
  */
 
 
+#include <boost/functional/hash.hpp>
+
 #include "storage/Utils/HumanString.h"
 #include "storage/Utils/TopologyImpl.h"
 
@@ -35,6 +37,19 @@ namespace storage
     }
 
 
+    size_t
+    hash_value(const Topology::Impl& impl)
+    {
+	size_t seed = 0;
+
+	boost::hash_combine(seed, impl.alignment_offset);
+	boost::hash_combine(seed, impl.optimal_io_size);
+	boost::hash_combine(seed, impl.minimal_grain);
+
+	return seed;
+    }
+
+
     std::ostream&
     operator<<(std::ostream& s, const Topology::Impl& impl)
     {
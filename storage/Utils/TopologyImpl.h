@@ -56,6 +56,8 @@ namespace storage
 	bool operator==(const Impl& rhs) const;
 	bool operator!=(const Impl& rhs) const { return !(*this == rhs); }
 
+	friend size_t hash_value(const Impl& impl);
+
 	friend std::ostream& operator<<(std::ostream& s, const Impl& impl);
 
 	friend bool getChildValue(const xmlNode* node, const char* name, Impl& value);
@@ -22,9 +22,17 @@
 
 
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <memory>
+#include <fstream>
+#include <unordered_map>
 
 #include "storage/Utils/XmlFile.h"
 #include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/Format.h"
 
 
 namespace storage
@@ -59,6 +67,133 @@ namespace storage
     }
 
 
+    namespace
+    {
+
+	const char binary_magic[] = { 'L', 'S', 'N', 'G', 'B', 'X', 'M', 'L' };
+
+	const size_t binary_header_size = sizeof(binary_magic) + 4 * sizeof(uint32_t);
+
+
+	void
+	put_uint32(string& buffer, uint32_t value)
+	{
+	    for (int i = 0; i < 4; ++i)
+		buffer += (char)((value >> (8 * i)) & 0xff);
+	}
+
+
+	uint32_t
+	get_uint32(const char* p)
+	{
+	    const unsigned char* q = (const unsigned char*) p;
+
+	    return (uint32_t)(q[0]) | (uint32_t)(q[1]) << 8 | (uint32_t)(q[2]) << 16 | (uint32_t)(q[3]) << 24;
+	}
+
+
+	class BinaryWriter
+	{
+	public:
+
+	    void add_element(const xmlNode* node);
+
+	    bool save_to_file(const string& filename) const;
+
+	private:
+
+	    uint32_t add_string(const char* s);
+
+	    std::unordered_map<string, uint32_t> string_index;
+	    vector<uint32_t> offsets;
+	    string strings;
+
+	    vector<std::pair<uint32_t, uint32_t>> records;
+
+	};
+
+
+	uint32_t
+	BinaryWriter::add_string(const char* s)
+	{
+	    std::unordered_map<string, uint32_t>::const_iterator it = string_index.find(s);
+	    if (it != string_index.end())
+		return it->second;
+
+	    uint32_t index = offsets.size();
+	    string_index.emplace(s, index);
+
+	    offsets.push_back(strings.size());
+	    strings += s;
+	    strings += '\0';
+
+	    return index;
+	}
+
+
+	void
+	BinaryWriter::add_element(const xmlNode* node)
+	{
+	    size_t position = records.size();
+	    records.emplace_back(add_string((const char*) node->name), 0);
+
+	    for (const xmlNode* child = node->children; child; child = child->next)
+	    {
+		if (child->type == XML_ELEMENT_NODE)
+		    add_element(child);
+		else if (child->type == XML_TEXT_NODE)
+		    records.emplace_back(XmlBinaryReader::text_record, add_string((const char*) child->content));
+	    }
+
+	    records[position].second = records.size() - position - 1;
+	}
+
+
+	bool
+	BinaryWriter::save_to_file(const string& filename) const
+	{
+	    string buffer(binary_magic, sizeof(binary_magic));
+
+	    put_uint32(buffer, XmlBinaryReader::version);
+	    put_uint32(buffer, offsets.size());
+	    put_uint32(buffer, strings.size());
+	    put_uint32(buffer, records.size());
+
+	    for (uint32_t offset : offsets)
+		put_uint32(buffer, offset);
+
+	    buffer += strings;
+
+	    for (const std::pair<uint32_t, uint32_t>& record : records)
+	    {
+		put_uint32(buffer, record.first);
+		put_uint32(buffer, record.second);
+	    }
+
+	    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+	    file.write(buffer.data(), buffer.size());
+	    file.close();
+
+	    return file.good();
+	}
+
+    }
+
+
+    bool
+    XmlFile::save_to_binary_file(const string& filename) const
+    {
+	const xmlNode* root_node = getRootElement();
+	if (!root_node)
+	    return false;
+
+	BinaryWriter binary_writer;
+	binary_writer.add_element(root_node);
+
+	return binary_writer.save_to_file(filename);
+    }
+
+
     string
     XmlFile::save_to_string() const
     {
@@ -73,6 +208,259 @@ namespace storage
     }
 
 
+    XmlStreamReader::XmlStreamReader(const string& filename)
+	: filename(filename), reader(xmlReaderForFile(filename.c_str(), NULL, XML_PARSE_NOBLANKS |
+						      XML_PARSE_NONET))
+    {
+	if (!reader)
+	    ST_THROW(Exception("failed to load xml document " + filename));
+    }
+
+
+    XmlStreamReader::~XmlStreamReader()
+    {
+	xmlFreeTextReader(reader);
+    }
+
+
+    void
+    XmlStreamReader::read(const char* root_name, const entry_fnc& entry_fnc)
+    {
+	string section;
+
+	int ret = xmlTextReaderRead(reader);
+
+	if (ret != 1)
+	    ST_THROW(Exception("failed to load xml document " + filename));
+
+	while (ret == 1)
+	{
+	    if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT)
+	    {
+		ret = xmlTextReaderRead(reader);
+		continue;
+	    }
+
+	    const char* name = (const char*) xmlTextReaderConstName(reader);
+
+	    switch (xmlTextReaderDepth(reader))
+	    {
+		case 0:
+		    if (strcmp(name, root_name) != 0)
+			ST_THROW(Exception(sformat("%s node not found", root_name)));
+		    ret = xmlTextReaderRead(reader);
+		    break;
+
+		case 1:
+		    section = name;
+		    ret = xmlTextReaderRead(reader);
+		    break;
+
+		case 2:
+		{
+		    // Expanding only builds the subtree of the entry. It is
+		    // freed when the reader moves on.
+
+		    const xmlNode* entry_node = xmlTextReaderExpand(reader);
+		    if (!entry_node)
+			ST_THROW(Exception("failed to load xml document " + filename));
+
+		    entry_fnc(section, entry_node);
+
+		    ret = xmlTextReaderNext(reader);
+		}
+		break;
+
+		default:
+		    ret = xmlTextReaderNext(reader);
+		    break;
+	    }
+	}
+
+	if (ret != 0)
+	    ST_THROW(Exception("failed to load xml document " + filename));
+    }
+
+
+    const uint32_t XmlBinaryReader::version;
+    const uint32_t XmlBinaryReader::text_record;
+
+
+    bool
+    XmlBinaryReader::is_binary_file(const string& filename)
+    {
+	char magic[sizeof(binary_magic)];
+
+	std::ifstream file(filename, std::ios::binary);
+	file.read(magic, sizeof(magic));
+
+	return file.gcount() == sizeof(magic) && memcmp(magic, binary_magic, sizeof(magic)) == 0;
+    }
+
+
+    XmlBinaryReader::XmlBinaryReader(const string& filename)
+	: filename(filename), data(nullptr), size(0)
+    {
+	int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+	    ST_THROW(Exception("failed to load binary document " + filename));
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)(st.st_size) < binary_header_size)
+	{
+	    close(fd);
+	    ST_THROW(Exception("failed to load binary document " + filename));
+	}
+
+	size = st.st_size;
+
+	void* tmp = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (tmp == MAP_FAILED)
+	    ST_THROW(Exception("failed to load binary document " + filename));
+
+	data = (const char*) tmp;
+
+	// Check the header and that all parts fit into the file. The
+	// strings and records are checked when they are used.
+
+	try
+	{
+	    if (memcmp(data, binary_magic, sizeof(binary_magic)) != 0)
+		ST_THROW(Exception("wrong magic in binary document " + filename));
+
+	    const char* header = data + sizeof(binary_magic);
+
+	    if (get_uint32(header) != version)
+		ST_THROW(Exception(sformat("unsupported version %d of binary document %s", get_uint32(header),
+					   filename)));
+
+	    num_strings = get_uint32(header + 4);
+	    strings_size = get_uint32(header + 8);
+	    num_records = get_uint32(header + 12);
+
+	    if ((size - binary_header_size) / 4 < num_strings ||
+		size - binary_header_size - 4 * num_strings < strings_size ||
+		(size - binary_header_size - 4 * num_strings - strings_size) / 8 != num_records ||
+		(strings_size > 0 && data[binary_header_size + 4 * num_strings + strings_size - 1] != '\0'))
+		ST_THROW(Exception("corrupt binary document " + filename));
+
+	    offsets = data + binary_header_size;
+	    strings = offsets + 4 * num_strings;
+	    records = strings + strings_size;
+	}
+	catch (...)
+	{
+	    munmap((void*) data, size);
+	    throw;
+	}
+    }
+
+
+    XmlBinaryReader::~XmlBinaryReader()
+    {
+	munmap((void*) data, size);
+    }
+
+
+    const char*
+    XmlBinaryReader::get_string(uint32_t index) const
+    {
+	if (index >= num_strings)
+	    ST_THROW(Exception("corrupt binary document " + filename));
+
+	uint32_t offset = get_uint32(offsets + 4 * index);
+	if (offset >= strings_size)
+	    ST_THROW(Exception("corrupt binary document " + filename));
+
+	return strings + offset;
+    }
+
+
+    uint32_t
+    XmlBinaryReader::add_children(xmlNode* node, uint32_t position) const
+    {
+	uint32_t end = position + 1 + get_uint32(records + 8 * position + 4);
+	if (end > num_records || end <= position)
+	    ST_THROW(Exception("corrupt binary document " + filename));
+
+	for (position = position + 1; position < end; )
+	{
+	    uint32_t name = get_uint32(records + 8 * position);
+	    uint32_t value = get_uint32(records + 8 * position + 4);
+
+	    if (name == text_record)
+	    {
+		xmlAddChild(node, xmlNewText((const xmlChar*) get_string(value)));
+		++position;
+	    }
+	    else
+	    {
+		xmlNode* child = xmlNewChild(node, get_string(name));
+		position = add_children(child, position);
+	    }
+	}
+
+	if (position != end)
+	    ST_THROW(Exception("corrupt binary document " + filename));
+
+	return end;
+    }
+
+
+    void
+    XmlBinaryReader::read(const char* root_name, const XmlStreamReader::entry_fnc& entry_fnc)
+    {
+	// The records are traversed like XmlStreamReader::read() traverses
+	// the elements. Only the subtree of the entry currently processed
+	// is built.
+
+	if (num_records == 0 || get_uint32(records) == text_record ||
+	    strcmp(get_string(get_uint32(records)), root_name) != 0)
+	    ST_THROW(Exception(sformat("%s node not found", root_name)));
+
+	uint32_t root_end = 1 + get_uint32(records + 4);
+	if (root_end != num_records)
+	    ST_THROW(Exception("corrupt binary document " + filename));
+
+	for (uint32_t position = 1; position < root_end; )
+	{
+	    if (get_uint32(records + 8 * position) == text_record)
+	    {
+		++position;
+		continue;
+	    }
+
+	    uint32_t section_end = position + 1 + get_uint32(records + 8 * position + 4);
+	    if (section_end > root_end || section_end <= position)
+		ST_THROW(Exception("corrupt binary document " + filename));
+
+	    const string section = get_string(get_uint32(records + 8 * position));
+
+	    for (position = position + 1; position < section_end; )
+	    {
+		uint32_t name = get_uint32(records + 8 * position);
+
+		if (name == text_record)
+		{
+		    ++position;
+		    continue;
+		}
+
+		std::unique_ptr<xmlNode, void(*)(xmlNode*)> entry_node(xmlNewNode(get_string(name)),
+									  xmlFreeNode);
+
+		position = add_children(entry_node.get(), position);
+		if (position > section_end)
+		    ST_THROW(Exception("corrupt binary document " + filename));
+
+		entry_fnc(section, entry_node.get());
+	    }
+	}
+    }
+
+
     xmlNode*
     xmlNewNode(const char* name)
     {
@@ -26,9 +26,12 @@
 
 
 #include <libxml/tree.h>
+#include <libxml/xmlreader.h>
+#include <stdint.h>
 #include <string>
 #include <vector>
 #include <sstream>
+#include <functional>
 #include <boost/noncopyable.hpp>
 #include <boost/optional.hpp>
 
@@ -52,6 +55,12 @@ namespace storage
 
 	bool save_to_file(const string& filename) const;
 
+	/**
+	 * Saves the document in the binary format read by XmlBinaryReader.
+	 * Only elements and their text content are saved.
+	 */
+	bool save_to_binary_file(const string& filename) const;
+
 	string save_to_string() const;
 
 	void setRootElement(xmlNode* node)
@@ -67,6 +76,116 @@ namespace storage
     };
 
 
+    /**
+     * Pull parser for XML files with the structure root/section/entry,
+     * e.g. Devicegraph/Devices/Disk or Mockup/Commands/Command. Only the
+     * entry currently processed is kept in memory, so the memory usage
+     * does not depend on the size of the file.
+     */
+    class XmlStreamReader : private boost::noncopyable
+    {
+
+    public:
+
+	typedef std::function<void(const string& section, const xmlNode* entry_node)> entry_fnc;
+
+	/**
+	 * @throw Exception
+	 */
+	XmlStreamReader(const string& filename);
+
+	~XmlStreamReader();
+
+	/**
+	 * Reads the file and calls entry_fnc for every entry in order of
+	 * the file. The entry node is the element of the entry. The root
+	 * element must be named root_name.
+	 *
+	 * @throw Exception
+	 */
+	void read(const char* root_name, const entry_fnc& entry_fnc);
+
+    private:
+
+	const string filename;
+
+	xmlTextReader* reader;
+
+    };
+
+
+    /**
+     * Reader for the binary format written by
+     * XmlFile::save_to_binary_file(). Offers the same interface as
+     * XmlStreamReader.
+     *
+     * The file is mapped into memory and consists of a header, a string
+     * table and fixed-size records for the elements and texts in
+     * document order. All numbers are 32 bit little endian.
+     *
+     *   header:	magic "LSNGBXML", version, number of strings, size
+     *			of string data, number of records
+     *   strings:	offsets into the string data, followed by the string
+     *			data with null-terminated strings
+     *   records:	pairs of (name, value). For elements name is the
+     *			index of the name in the string table and value the
+     *			number of records of the descendants. For texts
+     *			name is text_record and value the index of the text
+     *			in the string table.
+     */
+    class XmlBinaryReader : private boost::noncopyable
+    {
+
+    public:
+
+	static const uint32_t version = 1;
+
+	static const uint32_t text_record = 0xffffffff;
+
+	/**
+	 * Checks whether the file starts with the magic of the binary
+	 * format.
+	 */
+	static bool is_binary_file(const string& filename);
+
+	/**
+	 * @throw Exception
+	 */
+	XmlBinaryReader(const string& filename);
+
+	~XmlBinaryReader();
+
+	/**
+	 * @copydoc XmlStreamReader::read()
+	 */
+	void read(const char* root_name, const XmlStreamReader::entry_fnc& entry_fnc);
+
+    private:
+
+	const char* get_string(uint32_t index) const;
+
+	/**
+	 * Adds the children of the element record at position to node and
+	 * returns the position after the element.
+	 */
+	uint32_t add_children(xmlNode* node, uint32_t position) const;
+
+	const string filename;
+
+	const char* data;
+	size_t size;
+
+	uint32_t num_strings;
+	const char* offsets;
+	const char* strings;
+	uint32_t strings_size;
+
+	uint32_t num_records;
+	const char* records;
+
+    };
+
+
     xmlNode* xmlNewNode(const char* name);
     xmlNode* xmlNewComment(const char* content);
 
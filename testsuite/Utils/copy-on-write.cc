@@ -0,0 +1,54 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include "storage/Utils/CopyOnWrite.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(test_empty)
+{
+    CopyOnWrite<vector<string>> a;
+    CopyOnWrite<vector<string>> b = a;
+
+    BOOST_CHECK(a->empty());
+    BOOST_CHECK(!a.is_shared());
+    BOOST_CHECK(a == b);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_sharing)
+{
+    CopyOnWrite<vector<string>> a(vector<string>({ "sda" }));
+    CopyOnWrite<vector<string>> b = a;
+
+    // the copy shares the value until it is modified
+
+    BOOST_CHECK(a.is_shared());
+    BOOST_CHECK(b.is_shared());
+    BOOST_CHECK_EQUAL(&*a, &*b);
+
+    b.get_for_write().push_back("sdb");
+
+    BOOST_CHECK(!a.is_shared());
+    BOOST_CHECK(!b.is_shared());
+    BOOST_CHECK(&*a != &*b);
+
+    BOOST_CHECK_EQUAL(a->size(), 1);
+    BOOST_CHECK_EQUAL(b->size(), 2);
+    BOOST_CHECK(a != b);
+
+    // a value that is not shared is modified in place
+
+    const vector<string>* tmp = &*b;
+    b.get_for_write().push_back("sdc");
+    BOOST_CHECK_EQUAL(&*b, tmp);
+}
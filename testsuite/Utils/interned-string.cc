@@ -0,0 +1,62 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/InternedString.h"
+
+
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(test_empty)
+{
+    InternedString a;
+    InternedString b("");
+
+    BOOST_CHECK(a.empty());
+    BOOST_CHECK(a == b);
+    BOOST_CHECK_EQUAL(&a.get(), &b.get());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_equal)
+{
+    InternedString a(string("/dev/sda"));
+    InternedString b(string("/dev/") + "sda");
+    InternedString c("/dev/sdb");
+
+    BOOST_CHECK(a == b);
+    BOOST_CHECK(a != c);
+    BOOST_CHECK_EQUAL(&a.get(), &b.get());
+    BOOST_CHECK_EQUAL(a.get(), "/dev/sda");
+
+    c = "/dev/sda";
+    BOOST_CHECK(a == c);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_release)
+{
+    size_t num = InternedString::num_interned();
+
+    {
+	InternedString a("/dev/sdx");
+	InternedString b(a);
+
+	BOOST_CHECK_EQUAL(InternedString::num_interned(), num + 1);
+
+	a = "/dev/sdy";
+
+	BOOST_CHECK_EQUAL(InternedString::num_interned(), num + 2);
+
+	b = a;
+
+	// nothing refers to /dev/sdx anymore
+
+	BOOST_CHECK_EQUAL(InternedString::num_interned(), num + 1);
+    }
+
+    BOOST_CHECK_EQUAL(InternedString::num_interned(), num);
+}
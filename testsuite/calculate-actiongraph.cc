@@ -0,0 +1,57 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Partition.h"
+#include "storage/Devices/PartitionTable.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/Devicegraph.h"
+#include "storage/Actiongraph.h"
+
+
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(reuse)
+{
+    Environment environment(true, ProbeMode::READ_DEVICEGRAPH, TargetMode::DIRECT);
+    environment.set_devicegraph_filename("probe.xml");
+
+    Storage storage(environment);
+    storage.probe();
+
+    const Actiongraph* actiongraph1 = storage.calculate_actiongraph();
+    BOOST_CHECK(actiongraph1->empty());
+
+    // nothing changed, the actiongraph is reused
+
+    const Actiongraph* actiongraph2 = storage.calculate_actiongraph();
+    BOOST_CHECK_EQUAL(actiongraph1, actiongraph2);
+
+    // a read-only access via non-const functions and setting an attribute
+    // to its current value change no content, the actiongraph is reused
+
+    Partition* sda1 = Partition::find_by_name(storage.get_staging(), "/dev/sda1");
+    sda1->get_partition_table()->get_partitions();
+    sda1->set_size(sda1->get_size());
+
+    const Actiongraph* actiongraph2a = storage.calculate_actiongraph();
+    BOOST_CHECK_EQUAL(actiongraph1, actiongraph2a);
+
+    // an attribute changed, the actiongraph is calculated again
+
+    sda1->set_size(2 * sda1->get_size());
+
+    const Actiongraph* actiongraph3 = storage.calculate_actiongraph();
+    BOOST_CHECK_EQUAL(actiongraph3->num_actions(), 1);
+
+    // undoing the change again calculates the actiongraph again
+
+    sda1->set_size(sda1->get_size() / 2);
+
+    const Actiongraph* actiongraph4 = storage.calculate_actiongraph();
+    BOOST_CHECK(actiongraph4->empty());
+}
@@ -16,7 +16,7 @@
 #include "storage/Holders/Subdevice.h"
 #include "storage/Environment.h"
 #include "storage/Storage.h"
-#include "storage/Devicegraph.h"
+#include "storage/DevicegraphImpl.h"
 
 
 using namespace storage;
@@ -59,3 +59,127 @@ BOOST_AUTO_TEST_CASE(copy)
 
     devicegraph_copy->check();
 }
+
+
+BOOST_AUTO_TEST_CASE(copy_userdata)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+    sda->set_userdata({ { "key", "value" } });
+
+    Devicegraph* devicegraph_copy = storage.copy_devicegraph("staging", "copy");
+
+    Disk* sda_copy = Disk::find_by_name(devicegraph_copy, "/dev/sda");
+    BOOST_CHECK_EQUAL(sda_copy->get_userdata().at("key"), "value");
+
+    // the copy shares the userdata until it is modified
+
+    BOOST_CHECK_EQUAL(&sda->get_userdata(), &sda_copy->get_userdata());
+
+    sda_copy->set_userdata("key", "other value");
+
+    BOOST_CHECK(&sda->get_userdata() != &sda_copy->get_userdata());
+
+    BOOST_CHECK_EQUAL(sda->get_userdata().at("key"), "value");
+    BOOST_CHECK_EQUAL(sda_copy->get_userdata().at("key"), "other value");
+
+    // single entries
+
+    sda_copy->set_userdata("tag", "x");
+
+    BOOST_CHECK(sda_copy->has_userdata("tag"));
+    BOOST_CHECK(!sda->has_userdata("tag"));
+    BOOST_CHECK_EQUAL(sda_copy->get_userdata("key"), "other value");
+    BOOST_CHECK_EQUAL(sda_copy->get_userdata("tag"), "x");
+    BOOST_CHECK_THROW(sda->get_userdata("tag"), Exception);
+}
+
+
+BOOST_AUTO_TEST_CASE(copy_equal)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+    Gpt* gpt = Gpt::create(devicegraph);
+    User::create(devicegraph, sda, gpt);
+
+    Devicegraph* devicegraph_copy = storage.copy_devicegraph("staging", "copy");
+
+    BOOST_CHECK(*devicegraph == *devicegraph_copy);
+    BOOST_CHECK_EQUAL(devicegraph->get_impl().get_structure_hash(),
+		      devicegraph_copy->get_impl().get_structure_hash());
+
+    // a change of an attribute does not change the structure hash
+
+    Disk::find_by_name(devicegraph_copy, "/dev/sda")->set_userdata({ { "key", "value" } });
+
+    BOOST_CHECK(*devicegraph != *devicegraph_copy);
+    BOOST_CHECK_EQUAL(devicegraph->get_impl().get_structure_hash(),
+		      devicegraph_copy->get_impl().get_structure_hash());
+
+    // a change of the structure does
+
+    Disk::create(devicegraph_copy, "/dev/sdb");
+
+    BOOST_CHECK(*devicegraph != *devicegraph_copy);
+    BOOST_CHECK(devicegraph->get_impl().get_structure_hash() !=
+		devicegraph_copy->get_impl().get_structure_hash());
+}
+
+
+BOOST_AUTO_TEST_CASE(content_hash)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+    Gpt* gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 4096, 512), PartitionType::PRIMARY);
+    Encryption* encryption = sda1->create_encryption("cr-test", EncryptionType::LUKS1);
+    encryption->set_password("secret");
+    BlkFilesystem* ext4 = encryption->create_blk_filesystem(FsType::EXT4);
+    ext4->set_label("test");
+
+    Devicegraph* devicegraph_copy = storage.copy_devicegraph("staging", "copy");
+
+    BOOST_CHECK_EQUAL(devicegraph->get_impl().get_content_hash(), devicegraph_copy->get_impl().get_content_hash());
+    BOOST_CHECK(*devicegraph == *devicegraph_copy);
+
+    // a change of an attribute changes the content hash of the
+    // devicegraph, log_diff() only reports that device
+
+    BlkFilesystem* ext4_copy = to_blk_filesystem(devicegraph_copy->find_device(ext4->get_sid()));
+    ext4_copy->set_label("other");
+
+    BOOST_CHECK(devicegraph->get_impl().get_content_hash() != devicegraph_copy->get_impl().get_content_hash());
+    BOOST_CHECK(*devicegraph != *devicegraph_copy);
+
+    std::ostringstream log;
+    devicegraph->get_impl().log_diff(log, devicegraph_copy->get_impl());
+    BOOST_CHECK_EQUAL(log.str(), "sid " + std::to_string(ext4->get_sid()) + " device differ\n"
+		      " label:test-->other\n");
+
+    // reverting the change makes the devicegraphs equal again
+
+    ext4_copy->set_label("test");
+
+    BOOST_CHECK(*devicegraph == *devicegraph_copy);
+
+    // attributes not always saved are also included
+
+    to_encryption(devicegraph_copy->find_device(encryption->get_sid()))->set_password("other");
+
+    BOOST_CHECK(*devicegraph != *devicegraph_copy);
+}
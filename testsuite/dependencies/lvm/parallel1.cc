@@ -0,0 +1,22 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/Logger.h"
+#include "testsuite/helpers/TsCmp.h"
+
+
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(dependencies)
+{
+    set_logger(get_stdout_logger());
+
+    // Same as complex1 but committed with several threads. Growing firstlv
+    // and creating newlv are independent and can run in parallel
+    TsCmpActiongraph cmp("complex1", true, 4);
+    BOOST_CHECK_MESSAGE(cmp.ok(), cmp);
+}
@@ -0,0 +1,26 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/Logger.h"
+#include "storage/Actiongraph.h"
+#include "testsuite/helpers/TsCmp.h"
+
+
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(dependencies)
+{
+    set_logger(get_stdout_logger());
+
+    // Shrinking three LVs and growing two LVs of a VG. The groups are
+    // linked via a barrier that is not visible as an action.
+    TsCmpActiongraph cmp("resize1");
+    BOOST_CHECK_MESSAGE(cmp.ok(), cmp);
+
+    BOOST_CHECK_EQUAL(cmp.get_actiongraph()->num_actions(), 5);
+    BOOST_CHECK_EQUAL(cmp.get_actiongraph()->get_commit_actions().size(), 5);
+}
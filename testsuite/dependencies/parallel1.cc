@@ -0,0 +1,33 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/Logger.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "testsuite/helpers/TsCmp.h"
+
+
+using namespace storage;
+
+
+// Create several filesystems with several threads. Each mkfs action sets the
+// UUID of its filesystem in the same devicegraph and thus modifies the uuid
+// index concurrently.
+
+BOOST_AUTO_TEST_CASE(dependencies)
+{
+    set_logger(get_stdout_logger());
+
+    TsCmpActiongraph cmp("parallel1", true, 3);
+    BOOST_CHECK_MESSAGE(cmp.ok(), cmp);
+
+    const Devicegraph* staging = cmp.get_staging();
+
+    for (const char* uuid : { "4bb3e0b5-9cb3-4c48-a7b6-6d43f1a80101", "4bb3e0b5-9cb3-4c48-a7b6-6d43f1a80102",
+			      "4bb3e0b5-9cb3-4c48-a7b6-6d43f1a80103" })
+	BOOST_CHECK_EQUAL(BlkFilesystem::find_by_uuid(staging, uuid).size(), 1);
+
+    staging->check();
+}
@@ -0,0 +1,63 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/PartitionTable.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/Ext4.h"
+#include "storage/Holders/Holder.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/DevicegraphDiff.h"
+
+
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(devicegraph_diff)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* lhs = storage.get_staging();
+
+    Disk* sda = Disk::create(lhs, "/dev/sda", Region(0, 1000000, 512));
+    PartitionTable* gpt = sda->create_partition_table(PtType::GPT);
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 10000, 512), PartitionType::PRIMARY);
+    Partition* sda2 = gpt->create_partition("/dev/sda2", Region(12048, 10000, 512), PartitionType::PRIMARY);
+    sda2->create_blk_filesystem(FsType::EXT4);
+
+    Devicegraph* rhs = storage.copy_devicegraph("staging", "rhs");
+
+    BOOST_CHECK(DevicegraphDiff(lhs, rhs).empty());
+
+    Partition::find_by_name(rhs, "/dev/sda1")->set_size(20000 * 512);
+    Partition::find_by_name(rhs, "/dev/sda2")->remove_descendants(View::REMOVE);
+    PartitionTable* rhs_gpt = Disk::find_by_name(rhs, "/dev/sda")->get_partition_table();
+    Partition* sda3 = rhs_gpt->create_partition("/dev/sda3", Region(32048, 10000, 512), PartitionType::PRIMARY);
+
+    DevicegraphDiff diff(lhs, rhs);
+
+    BOOST_CHECK(!diff.empty());
+
+    BOOST_REQUIRE_EQUAL(diff.get_created_devices().size(), 1);
+    BOOST_CHECK_EQUAL(diff.get_created_devices()[0], sda3);
+
+    BOOST_REQUIRE_EQUAL(diff.get_modified_devices().size(), 1);
+    BOOST_CHECK_EQUAL(diff.get_modified_devices()[0]->get_sid(), sda1->get_sid());
+
+    BOOST_REQUIRE_EQUAL(diff.get_deleted_devices().size(), 1);
+    BOOST_CHECK(is_ext4(diff.get_deleted_devices()[0]));
+
+    BOOST_REQUIRE_EQUAL(diff.get_created_holders().size(), 1);
+    BOOST_CHECK_EQUAL(diff.get_created_holders()[0]->get_target_sid(), sda3->get_sid());
+
+    BOOST_CHECK(diff.get_modified_holders().empty());
+
+    BOOST_REQUIRE_EQUAL(diff.get_deleted_holders().size(), 1);
+    BOOST_CHECK_EQUAL(diff.get_deleted_holders()[0]->get_source_sid(), sda2->get_sid());
+}
@@ -7,12 +7,15 @@
 #include "storage/Devices/DiskImpl.h"
 #include "storage/Devices/Gpt.h"
 #include "storage/Devices/PartitionImpl.h"
+#include "storage/Devices/LvmVgImpl.h"
+#include "storage/Filesystems/BlkFilesystem.h"
 #include "storage/Holders/Subdevice.h"
 #include "storage/Environment.h"
 #include "storage/Storage.h"
 #include "storage/Devicegraph.h"
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/StorageDefines.h"
+#include "storage/FindBy.h"
 
 
 using namespace std;
@@ -90,4 +93,115 @@ BOOST_AUTO_TEST_CASE(find_vertex)
 			RemoteCommand( vector<string>({}), vector<string>({ "Unknown device, [...]" }), 4));
 
     BOOST_CHECK_THROW(BlkDevice::find_by_any_name(system, "/dev/does-not-exist"), DeviceNotFound);
+
+    // Looking up a device by a udev link always uses udevadm info calls
+    // since the udev links known to libstorage-ng can be outdated.
+
+    BlkDevice* system_sda = BlkDevice::find_by_name(storage.get_system(), "/dev/sda");
+    system_sda->get_impl().set_udev_ids({ "ata-WDC_WD10EFRX-68FYTN0_WD-WCC4J1234567" });
+
+    Mockup::set_command(UDEVADM_BIN " info '/dev/disk/by-id/ata-WDC_WD10EFRX-68FYTN0_WD-WCC4J1234567'", vector<string>({
+	"P: /devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda/sda1",
+	"N: sda1"
+    }));
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_any_name(system, "/dev/disk/by-id/ata-WDC_WD10EFRX-68FYTN0_WD-WCC4J1234567")->get_sid(),
+		      sda1->get_sid());
+
+    // Renaming a device must be reflected by lookups.
+
+    system_sda->set_name("/dev/sdz");
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_any_name(system, "/dev/sdz"), system_sda);
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(system, "/dev/sda"), DeviceNotFound);
+
+    system->check();
+}
+
+
+BOOST_AUTO_TEST_CASE(find_device)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+    Disk* sdb = Disk::create(devicegraph, "/dev/sdb");
+
+    sid_t sda_sid = sda->get_sid();
+    sid_t sdb_sid = sdb->get_sid();
+
+    BOOST_CHECK_EQUAL(devicegraph->find_device(sda_sid), sda);
+    BOOST_CHECK_EQUAL(devicegraph->find_device(sdb_sid), sdb);
+
+    devicegraph->remove_device(sda);
+
+    BOOST_CHECK(!devicegraph->device_exists(sda_sid));
+    BOOST_CHECK_THROW(devicegraph->find_device(sda_sid), DeviceNotFoundBySid);
+    BOOST_CHECK_EQUAL(devicegraph->find_device(sdb_sid), sdb);
+
+    devicegraph->check();
+
+    Devicegraph* devicegraph_copy = storage.copy_devicegraph("staging", "copy");
+
+    BOOST_CHECK(!devicegraph_copy->device_exists(sda_sid));
+    BOOST_CHECK_EQUAL(devicegraph_copy->find_device(sdb_sid)->get_devicegraph(), devicegraph_copy);
+
+    devicegraph_copy->check();
+
+    devicegraph_copy->clear();
+
+    BOOST_CHECK(!devicegraph_copy->device_exists(sdb_sid));
+    BOOST_CHECK(devicegraph->device_exists(sdb_sid));
+}
+
+
+BOOST_AUTO_TEST_CASE(uuid_index)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+
+    BlkFilesystem* ext4 = sda->create_blk_filesystem(FsType::EXT4);
+    ext4->set_uuid("a8b0d3c4-5b7e-4f1c-9a2b-6d3e8f0a1b2c");
+
+    LvmVg* lvm_vg = LvmVg::create(devicegraph, "system");
+    lvm_vg->get_impl().set_uuid("Zm6kNy-0Bd5-6Zzn-WKHH-dmnB-QJmm-iGDF8A");
+
+    BOOST_CHECK_EQUAL(BlkFilesystem::find_by_uuid(devicegraph, "a8b0d3c4-5b7e-4f1c-9a2b-6d3e8f0a1b2c").size(), 1);
+    BOOST_CHECK_EQUAL(LvmVg::Impl::find_by_uuid(devicegraph, "Zm6kNy-0Bd5-6Zzn-WKHH-dmnB-QJmm-iGDF8A"), lvm_vg);
+
+    // Lookups with the wrong type or an unknown UUID fail.
+
+    BOOST_CHECK_THROW(find_by_uuid<LvmVg>(devicegraph, "a8b0d3c4-5b7e-4f1c-9a2b-6d3e8f0a1b2c"), DeviceNotFoundByUuid);
+    BOOST_CHECK_THROW(LvmVg::Impl::find_by_uuid(devicegraph, "unknown"), DeviceNotFoundByUuid);
+
+    // The non-throwing lookups simply report a miss.
+
+    BOOST_CHECK(!try_find_by_uuid<LvmVg>(devicegraph, "a8b0d3c4-5b7e-4f1c-9a2b-6d3e8f0a1b2c"));
+    BOOST_CHECK(!try_find_by_uuid<const LvmVg>(static_cast<const Devicegraph*>(devicegraph), "unknown"));
+    BOOST_CHECK_EQUAL(try_find_by_uuid<LvmVg>(devicegraph, "Zm6kNy-0Bd5-6Zzn-WKHH-dmnB-QJmm-iGDF8A"), lvm_vg);
+    BOOST_CHECK(BlkFilesystem::find_by_uuid(devicegraph, "unknown").empty());
+
+    // Changing the UUID must be reflected by lookups.
+
+    ext4->set_uuid("1f2e3d4c-5b6a-4978-8a7b-6c5d4e3f2a1b");
+
+    BOOST_CHECK(BlkFilesystem::find_by_uuid(devicegraph, "a8b0d3c4-5b7e-4f1c-9a2b-6d3e8f0a1b2c").empty());
+    BOOST_CHECK_EQUAL(BlkFilesystem::find_by_uuid(devicegraph, "1f2e3d4c-5b6a-4978-8a7b-6c5d4e3f2a1b").size(), 1);
+
+    devicegraph->check();
+
+    Devicegraph* devicegraph_copy = storage.copy_devicegraph("staging", "copy");
+
+    BOOST_CHECK_EQUAL(BlkFilesystem::find_by_uuid(devicegraph_copy, "1f2e3d4c-5b6a-4978-8a7b-6c5d4e3f2a1b").front()->get_devicegraph(),
+		      devicegraph_copy);
+
+    devicegraph_copy->check();
 }
@@ -4,14 +4,22 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/BlkFilesystem.h"
 #include "storage/Filesystems/BtrfsSubvolume.h"
+#include "storage/Filesystems/BtrfsQgroupImpl.h"
+#include "storage/Filesystems/Btrfs.h"
 #include "storage/Holders/Subdevice.h"
 #include "storage/Holders/Snapshot.h"
+#include "storage/Holders/BtrfsQgroupRelation.h"
 #include "storage/Environment.h"
 #include "storage/Storage.h"
-#include "storage/Devicegraph.h"
+#include "storage/DevicegraphImpl.h"
 
 
+using namespace std;
 using namespace storage;
 
 
@@ -34,3 +42,443 @@ BOOST_AUTO_TEST_CASE(create1)
     BOOST_CHECK_THROW(Subdevice::create(devicegraph, btrfs_subvolume1, btrfs_subvolume2),
 		      HolderAlreadyExists);
 }
+
+
+BOOST_AUTO_TEST_CASE(find_holders)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    BtrfsSubvolume* btrfs_subvolume1 = BtrfsSubvolume::create(devicegraph, "1");
+    BtrfsSubvolume* btrfs_subvolume2 = BtrfsSubvolume::create(devicegraph, "1/2");
+
+    sid_t sid1 = btrfs_subvolume1->get_sid();
+    sid_t sid2 = btrfs_subvolume2->get_sid();
+
+    BOOST_CHECK(!devicegraph->holder_exists(sid1, sid2));
+
+    Subdevice* subdevice = Subdevice::create(devicegraph, btrfs_subvolume1, btrfs_subvolume2);
+    Snapshot* snapshot = Snapshot::create(devicegraph, btrfs_subvolume1, btrfs_subvolume2);
+
+    BOOST_CHECK(devicegraph->holder_exists(sid1, sid2));
+    BOOST_CHECK(!devicegraph->holder_exists(sid2, sid1));
+
+    // parallel holders are found in the order of creation
+
+    std::vector<Holder*> holders = devicegraph->find_holders(sid1, sid2);
+    BOOST_CHECK_EQUAL(holders.size(), 2);
+    BOOST_CHECK_EQUAL(holders[0], subdevice);
+    BOOST_CHECK_EQUAL(holders[1], snapshot);
+
+    devicegraph->remove_holder(subdevice);
+
+    BOOST_CHECK_EQUAL(devicegraph->find_holder(sid1, sid2), snapshot);
+
+    devicegraph->check();
+
+    devicegraph->remove_device(btrfs_subvolume2);
+
+    BOOST_CHECK(!devicegraph->holder_exists(sid1, sid2));
+
+    devicegraph->check();
+}
+
+
+BOOST_AUTO_TEST_CASE(get_all)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+    PartitionTable* gpt = sda->create_partition_table(PtType::GPT);
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 4096, 512), PartitionType::PRIMARY);
+
+    Disk* sdb = Disk::create(devicegraph, "/dev/sdb", Region(0, 1000000, 512));
+    BlkFilesystem* ext4 = sdb->create_blk_filesystem(FsType::EXT4);
+
+    // devices of base classes are found too and in the order of creation
+
+    BOOST_CHECK(BlkDevice::get_all(devicegraph) == vector<BlkDevice*>({ sda, sda1, sdb }));
+    BOOST_CHECK(Partitionable::get_all(devicegraph) == vector<Partitionable*>({ sda, sdb }));
+    BOOST_CHECK(Gpt::get_all(devicegraph).size() == 1);
+    BOOST_CHECK(Mountable::get_all(devicegraph) == vector<Mountable*>({ ext4 }));
+    BOOST_CHECK(Device::get_all(devicegraph).size() == 5);
+    BOOST_CHECK(BlkFilesystem::get_all(devicegraph) == vector<BlkFilesystem*>({ ext4 }));
+    BOOST_CHECK(Btrfs::get_all(devicegraph).empty());
+
+    devicegraph->remove_device(ext4);
+    devicegraph->remove_device(sdb);
+
+    BOOST_CHECK(BlkDevice::get_all(devicegraph) == vector<BlkDevice*>({ sda, sda1 }));
+    BOOST_CHECK(Partitionable::get_all(devicegraph) == vector<Partitionable*>({ sda }));
+    BOOST_CHECK(Mountable::get_all(devicegraph).empty());
+
+    Devicegraph copy(&storage);
+    devicegraph->copy(copy);
+
+    BOOST_CHECK(BlkDevice::get_all(&copy).size() == 2);
+    BOOST_CHECK(Gpt::get_all(&copy).size() == 1);
+
+    devicegraph->check();
+    copy.check();
+}
+
+
+BOOST_AUTO_TEST_CASE(children_and_parents)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    BtrfsSubvolume* btrfs_subvolume1 = BtrfsSubvolume::create(devicegraph, "1");
+    BtrfsSubvolume* btrfs_subvolume2 = BtrfsSubvolume::create(devicegraph, "1/2");
+    BtrfsSubvolume* btrfs_subvolume3 = BtrfsSubvolume::create(devicegraph, "3");
+
+    Subdevice::create(devicegraph, btrfs_subvolume1, btrfs_subvolume2);
+    Snapshot::create(devicegraph, btrfs_subvolume1, btrfs_subvolume2);
+    Snapshot::create(devicegraph, btrfs_subvolume1, btrfs_subvolume3);
+
+    // snapshot holders are not in the classic view
+
+    BOOST_CHECK(btrfs_subvolume1->has_children());
+    BOOST_CHECK_EQUAL(btrfs_subvolume1->num_children(), 1);
+    BOOST_CHECK(btrfs_subvolume1->get_children() == vector<Device*>({ btrfs_subvolume2 }));
+    BOOST_CHECK(btrfs_subvolume1->get_children(View::ALL) ==
+		vector<Device*>({ btrfs_subvolume2, btrfs_subvolume2, btrfs_subvolume3 }));
+    BOOST_CHECK_EQUAL(btrfs_subvolume1->get_out_holders().size(), 1);
+
+    BOOST_CHECK(!btrfs_subvolume3->has_parents());
+    BOOST_CHECK(btrfs_subvolume3->get_parents().empty());
+    BOOST_CHECK(btrfs_subvolume3->get_parents(View::ALL) == vector<Device*>({ btrfs_subvolume1 }));
+}
+
+
+BOOST_AUTO_TEST_CASE(cached_traversals)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    BtrfsSubvolume* btrfs_subvolume1 = BtrfsSubvolume::create(devicegraph, "1");
+    BtrfsSubvolume* btrfs_subvolume2 = BtrfsSubvolume::create(devicegraph, "1/2");
+    BtrfsSubvolume* btrfs_subvolume3 = BtrfsSubvolume::create(devicegraph, "1/2/3");
+
+    Subdevice::create(devicegraph, btrfs_subvolume1, btrfs_subvolume2);
+
+    BOOST_CHECK(btrfs_subvolume1->get_descendants(false) == vector<Device*>({ btrfs_subvolume2 }));
+    BOOST_CHECK(btrfs_subvolume3->get_ancestors(false).empty());
+
+    // the results are cached but every modification of the devicegraph
+    // invalidates the cache
+
+    unsigned long long generation = devicegraph->get_impl().get_generation();
+
+    Subdevice::create(devicegraph, btrfs_subvolume2, btrfs_subvolume3);
+
+    BOOST_CHECK(devicegraph->get_impl().get_generation() > generation);
+
+    BOOST_CHECK(btrfs_subvolume1->get_descendants(false) ==
+		vector<Device*>({ btrfs_subvolume2, btrfs_subvolume3 }));
+    BOOST_CHECK(btrfs_subvolume3->get_ancestors(false) ==
+		vector<Device*>({ btrfs_subvolume2, btrfs_subvolume1 }));
+
+    devicegraph->remove_device(btrfs_subvolume3);
+
+    BOOST_CHECK(btrfs_subvolume1->get_descendants(false) == vector<Device*>({ btrfs_subvolume2 }));
+}
+
+
+BOOST_AUTO_TEST_CASE(uncached_remove_view)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    BtrfsSubvolume* btrfs_subvolume = BtrfsSubvolume::create(devicegraph, "1");
+    BtrfsQgroup* btrfs_qgroup = BtrfsQgroup::create(devicegraph, BtrfsQgroup::Impl::unknown_id);
+
+    BtrfsQgroupRelation::create(devicegraph, btrfs_subvolume, btrfs_qgroup);
+
+    BOOST_CHECK(btrfs_subvolume->get_descendants(false, View::REMOVE) == vector<Device*>({ btrfs_qgroup }));
+
+    // the remove view depends on the id of the qgroup, changing it does not
+    // change the generation of the devicegraph
+
+    btrfs_qgroup->get_impl().set_id(make_pair(0, 257));
+
+    BOOST_CHECK(btrfs_subvolume->get_descendants(false, View::REMOVE).empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(checkpoint_and_rollback)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+    Gpt* gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 4096, 512), PartitionType::PRIMARY);
+
+    unsigned int checkpoint = devicegraph->checkpoint();
+
+    gpt->delete_partition(sda1);
+    Partition* sda2 = gpt->create_partition("/dev/sda2", Region(8192, 4096, 512), PartitionType::PRIMARY);
+    sda2->create_blk_filesystem(FsType::EXT4);
+
+    BOOST_CHECK_EQUAL(devicegraph->num_devices(), 4);
+
+    devicegraph->rollback(checkpoint);
+
+    BOOST_CHECK_EQUAL(devicegraph->num_devices(), 3);
+    BOOST_CHECK_EQUAL(devicegraph->num_holders(), 2);
+
+    // the removed partition is put back, so pointers to it stay valid
+
+    BOOST_CHECK(Partition::find_by_name(devicegraph, "/dev/sda1") == sda1);
+    BOOST_CHECK(sda1->get_partition_table() == gpt);
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(devicegraph, "/dev/sda2"), DeviceNotFound);
+
+    devicegraph->check();
+
+    // a rolled back checkpoint is released
+
+    BOOST_CHECK_THROW(devicegraph->rollback(checkpoint), Exception);
+}
+
+
+BOOST_AUTO_TEST_CASE(checkpoint_and_rollback_attributes)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+    Gpt* gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 4096, 512), PartitionType::PRIMARY);
+    BlkFilesystem* ext4 = sda1->create_blk_filesystem(FsType::EXT4);
+    ext4->set_uuid("1234");
+
+    unsigned int checkpoint = devicegraph->checkpoint();
+
+    // non-const access without modification records nothing, so the
+    // rollback does not restore the disk
+
+    const void* sda_impl = &sda->get_impl();
+    sda->get_partition_table()->get_partitions();
+
+    sda1->set_region(Region(2048, 8192, 512));
+    ext4->set_uuid("5678");
+    ext4->set_label("test");
+
+    devicegraph->rollback(checkpoint);
+
+    // the attributes are restored and pointers stay valid
+
+    BOOST_CHECK_EQUAL(sda1->get_region(), Region(2048, 4096, 512));
+    BOOST_CHECK_EQUAL(ext4->get_label(), "");
+    BOOST_CHECK(&sda->get_impl() == sda_impl);
+    BOOST_CHECK(sda1->get_blk_filesystem() == ext4);
+
+    // the indices are updated
+
+    BOOST_CHECK(BlkFilesystem::find_by_uuid(devicegraph, "1234") == vector<const BlkFilesystem*>({ ext4 }));
+    BOOST_CHECK(BlkFilesystem::find_by_uuid(devicegraph, "5678").empty());
+
+    devicegraph->check();
+
+    // ids of checkpoints are not reused
+
+    unsigned int checkpoint2 = devicegraph->checkpoint();
+    BOOST_CHECK(checkpoint2 != checkpoint);
+    BOOST_CHECK_THROW(devicegraph->rollback(checkpoint), Exception);
+    devicegraph->release_checkpoint(checkpoint2);
+}
+
+
+BOOST_AUTO_TEST_CASE(check_incremental)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+    Gpt* gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+
+    devicegraph->check();
+
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 4096, 512), PartitionType::PRIMARY);
+    sda1->create_blk_filesystem(FsType::EXT4);
+
+    devicegraph->check_incremental();
+
+    // a cycle created by a new holder is detected
+
+    Subdevice::create(devicegraph, sda1, sda);
+
+    BOOST_CHECK_THROW(devicegraph->check_incremental(), Exception);
+}
+
+
+BOOST_AUTO_TEST_CASE(check_incremental_attributes)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+    PartitionTable* msdos = sda->create_partition_table(PtType::MSDOS);
+    Partition* sda1 = msdos->create_partition("/dev/sda1", Region(2048, 4096, 512), PartitionType::PRIMARY);
+
+    devicegraph->check();
+
+    unsigned int checkpoint = devicegraph->checkpoint();
+
+    // a logical partition needs an extended partition as parent, only
+    // the setter is involved
+
+    sda1->set_type(PartitionType::LOGICAL);
+
+    BOOST_CHECK_THROW(devicegraph->check_incremental(), Exception);
+
+    // undoing the change is also detected
+
+    devicegraph->rollback(checkpoint);
+
+    devicegraph->check_incremental();
+}
+
+
+BOOST_AUTO_TEST_CASE(batch)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+    Gpt* gpt = to_gpt(sda->create_partition_table(PtType::GPT));
+
+    {
+	Devicegraph::Batch batch = devicegraph->batch();
+
+	for (unsigned int i = 1; i <= 10; ++i)
+	    gpt->create_partition("/dev/sda" + to_string(i), Region(2048 * i, 2048, 512),
+				  PartitionType::PRIMARY);
+
+	// lookups during the batch are correct
+
+	BOOST_CHECK(BlkDevice::find_by_name(devicegraph, "/dev/sda5")->get_name() == "/dev/sda5");
+
+	gpt->delete_partition(Partition::find_by_name(devicegraph, "/dev/sda10"));
+
+	batch.commit();
+    }
+
+    devicegraph->check();
+
+    BOOST_CHECK_EQUAL(gpt->get_partitions().size(), 9);
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(devicegraph, "/dev/sda10"), DeviceNotFound);
+
+    size_t num_devices = devicegraph->num_devices();
+    size_t num_holders = devicegraph->num_holders();
+
+    // a duplicate holder is detected when the batch ends and the batch is
+    // undone
+
+    {
+	Devicegraph::Batch batch = devicegraph->batch();
+
+	BtrfsSubvolume* btrfs_subvolume1 = BtrfsSubvolume::create(devicegraph, "1");
+	BtrfsSubvolume* btrfs_subvolume2 = BtrfsSubvolume::create(devicegraph, "1/2");
+
+	Subdevice::create(devicegraph, btrfs_subvolume1, btrfs_subvolume2);
+	Subdevice::create(devicegraph, btrfs_subvolume1, btrfs_subvolume2);
+
+	BOOST_CHECK_THROW(batch.commit(), HolderAlreadyExists);
+    }
+
+    BOOST_CHECK_EQUAL(devicegraph->num_devices(), num_devices);
+    BOOST_CHECK_EQUAL(devicegraph->num_holders(), num_holders);
+
+    // a batch that is not committed is undone
+
+    {
+	Devicegraph::Batch batch = devicegraph->batch();
+
+	gpt->create_partition("/dev/sda10", Region(2048 * 10, 2048, 512), PartitionType::PRIMARY);
+	gpt->delete_partition(Partition::find_by_name(devicegraph, "/dev/sda1"));
+    }
+
+    devicegraph->check();
+
+    BOOST_CHECK_EQUAL(devicegraph->num_devices(), num_devices);
+    BOOST_CHECK_EQUAL(devicegraph->num_holders(), num_holders);
+    BOOST_CHECK(BlkDevice::find_by_name(devicegraph, "/dev/sda1")->get_name() == "/dev/sda1");
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(devicegraph, "/dev/sda10"), DeviceNotFound);
+
+    // lookups interleaved with additions see all additions and an outer
+    // checkpoint also undoes a committed batch
+
+    unsigned int checkpoint = devicegraph->checkpoint();
+
+    {
+	Devicegraph::Batch batch = devicegraph->batch();
+
+	gpt->create_partition("/dev/sda10", Region(2048 * 10, 2048, 512), PartitionType::PRIMARY);
+	BOOST_CHECK(BlkDevice::find_by_name(devicegraph, "/dev/sda10")->get_name() == "/dev/sda10");
+
+	gpt->create_partition("/dev/sda11", Region(2048 * 11, 2048, 512), PartitionType::PRIMARY);
+	BOOST_CHECK(BlkDevice::find_by_name(devicegraph, "/dev/sda11")->get_name() == "/dev/sda11");
+	BOOST_CHECK_EQUAL(gpt->get_partitions().size(), 11);
+
+	batch.commit();
+    }
+
+    devicegraph->check();
+
+    devicegraph->rollback(checkpoint);
+
+    devicegraph->check();
+
+    BOOST_CHECK_EQUAL(devicegraph->num_devices(), num_devices);
+    BOOST_CHECK_EQUAL(devicegraph->num_holders(), num_holders);
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(devicegraph, "/dev/sda10"), DeviceNotFound);
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(devicegraph, "/dev/sda11"), DeviceNotFound);
+
+    // the batch also ends if clear() invalidated its checkpoint, so
+    // afterwards a duplicate holder is detected immediately again
+
+    {
+	Devicegraph::Batch batch = devicegraph->batch();
+
+	devicegraph->clear();
+    }
+
+    BtrfsSubvolume* btrfs_subvolume1 = BtrfsSubvolume::create(devicegraph, "1");
+    BtrfsSubvolume* btrfs_subvolume2 = BtrfsSubvolume::create(devicegraph, "1/2");
+
+    Subdevice::create(devicegraph, btrfs_subvolume1, btrfs_subvolume2);
+    BOOST_CHECK_THROW(Subdevice::create(devicegraph, btrfs_subvolume1, btrfs_subvolume2), HolderAlreadyExists);
+}
@@ -193,7 +193,7 @@ namespace storage
     }
 
 
-    TsCmpActiongraph::TsCmpActiongraph(const string& name, bool commit)
+    TsCmpActiongraph::TsCmpActiongraph(const string& name, bool commit, unsigned int max_parallel_actions)
     {
 	Environment environment(true, ProbeMode::READ_DEVICEGRAPH, TargetMode::DIRECT);
 	environment.set_devicegraph_filename(name + "-probed.xml");
@@ -236,6 +236,7 @@ namespace storage
 	Mockup::load(name + "-mockup.xml");
 
 	CommitOptions commit_options(false);
+	commit_options.max_parallel_actions = max_parallel_actions;
 
 	storage->commit(commit_options);
 
@@ -296,7 +297,7 @@ namespace storage
 
 	for (const Entry& entry : entries)
 	{
-	    for (const string dep_id : entry.dep_ids)
+	    for (const string& dep_id : entry.dep_ids)
 	    {
 		if (ids.find(dep_id) == ids.end())
 		    ST_THROW(Exception("unknown dependency-id"));
@@ -314,12 +315,38 @@ namespace storage
     }
 
 
+    vector<Actiongraph::Impl::vertex_descriptor>
+    TsCmpActiongraph::children(const CommitData& commit_data, Actiongraph::Impl::vertex_descriptor vertex) const
+    {
+	// The expected dependencies do not include barriers, so look through
+	// them.
+
+	vector<Actiongraph::Impl::vertex_descriptor> ret;
+
+	for (Actiongraph::Impl::vertex_descriptor child : commit_data.actiongraph.children(vertex))
+	{
+	    if (is_barrier(commit_data.actiongraph[child]))
+	    {
+		vector<Actiongraph::Impl::vertex_descriptor> tmp = children(commit_data, child);
+		ret.insert(ret.end(), tmp.begin(), tmp.end());
+	    }
+	    else
+	    {
+		ret.push_back(child);
+	    }
+	}
+
+	return ret;
+    }
+
+
     void
     TsCmpActiongraph::cmp_texts(const CommitData& commit_data)
     {
 	set<string> tmp1;
 	for (Actiongraph::Impl::vertex_descriptor vertex : commit_data.actiongraph.vertices())
-	    tmp1.insert(text(commit_data, vertex));
+	    if (!is_barrier(commit_data.actiongraph[vertex]))
+		tmp1.insert(text(commit_data, vertex));
 
 	set<string> tmp2;
 	for (const Entry& entry : entries)
@@ -358,7 +385,7 @@ namespace storage
 	    Actiongraph::Impl::vertex_descriptor vertex = text_to_vertex[entry.text];
 
 	    set<string> tmp;
-	    for (Actiongraph::Impl::vertex_descriptor child : commit_data.actiongraph.children(vertex))
+	    for (Actiongraph::Impl::vertex_descriptor child : children(commit_data, vertex))
 		tmp.insert(text_to_id[text(commit_data, child)]);
 
 	    if (tmp != entry.dep_ids)
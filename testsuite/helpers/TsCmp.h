@@ -82,8 +82,11 @@ namespace storage
 	 * in the mockup file (otherwise an exception is raised). Due
 	 * to possible interaction of external programs and files this
 	 * is likely only useful for testing a few actions at once.
+	 *
+	 * The actions are committed by up to max_parallel_actions
+	 * threads, see CommitOptions.
 	 */
-	TsCmpActiongraph(const string& name, bool commit = false);
+	TsCmpActiongraph(const string& name, bool commit = false, unsigned int max_parallel_actions = 1);
 
 	const Devicegraph* get_probed() const { return probed; }
 	const Devicegraph* get_staging() const { return staging; }
@@ -121,6 +124,9 @@ namespace storage
 
 	string text(const CommitData& commit_data, Actiongraph::Impl::vertex_descriptor vertex) const;
 
+	vector<Actiongraph::Impl::vertex_descriptor> children(const CommitData& commit_data,
+							      Actiongraph::Impl::vertex_descriptor vertex) const;
+
     };
 
 
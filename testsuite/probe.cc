@@ -7,6 +7,7 @@
 #include "storage/Environment.h"
 #include "storage/Storage.h"
 #include "storage/Devicegraph.h"
+#include "storage/Utils/Exception.h"
 
 
 using namespace storage;
@@ -33,3 +34,28 @@ BOOST_AUTO_TEST_CASE(dependencies)
     BOOST_CHECK_EQUAL(staging->num_devices(), 3);
     BOOST_CHECK_EQUAL(staging->num_holders(), 2);
 }
+
+
+BOOST_AUTO_TEST_CASE(wrong_root_element)
+{
+    Environment environment(true, ProbeMode::READ_DEVICEGRAPH, TargetMode::DIRECT);
+    environment.set_devicegraph_filename("probe-wrong-root.xml");
+
+    Storage storage(environment);
+
+    BOOST_CHECK_THROW(storage.probe(), Exception);
+}
+
+
+BOOST_AUTO_TEST_CASE(holders_before_devices)
+{
+    // The devices must precede the holders in the file since the holders
+    // are loaded while reading the file.
+
+    Environment environment(true, ProbeMode::READ_DEVICEGRAPH, TargetMode::DIRECT);
+    environment.set_devicegraph_filename("probe-holders-first.xml");
+
+    Storage storage(environment);
+
+    BOOST_CHECK_THROW(storage.probe(), Exception);
+}
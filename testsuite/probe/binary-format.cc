@@ -0,0 +1,116 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <glob.h>
+#include <unistd.h>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/Devicegraph.h"
+
+#include "testsuite/helpers/TsCmp.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+vector<string>
+devicegraph_filenames()
+{
+    vector<string> ret;
+
+    glob_t globbuf;
+    if (glob("*-devicegraph*.xml", 0, nullptr, &globbuf) == 0)
+    {
+	for (size_t i = 0; i < globbuf.gl_pathc; ++i)
+	    ret.push_back(globbuf.gl_pathv[i]);
+    }
+    globfree(&globbuf);
+
+    return ret;
+}
+
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+    set_logger(get_stdout_logger());
+
+    vector<string> filenames = devicegraph_filenames();
+    BOOST_CHECK(!filenames.empty());
+
+    for (const string& filename : filenames)
+    {
+	BOOST_TEST_MESSAGE("checking " << filename);
+
+	Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+	Storage storage(environment);
+
+	Devicegraph* xml = storage.create_devicegraph("xml");
+	xml->load(filename);
+
+	xml->save("binary-format.bin", DevicegraphFormat::BINARY);
+
+	Devicegraph* binary = storage.create_devicegraph("binary");
+	binary->load("binary-format.bin");
+	binary->check();
+
+	BOOST_CHECK_MESSAGE(*xml == *binary, filename);
+
+	TsCmpDevicegraph cmp(*xml, *binary);
+	BOOST_CHECK_MESSAGE(cmp.ok(), cmp);
+    }
+
+    unlink("binary-format.bin");
+}
+
+
+BOOST_AUTO_TEST_CASE(read_devicegraph)
+{
+    // a binary devicegraph can be loaded in ProbeMode::READ_DEVICEGRAPH
+
+    {
+	Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+	Storage storage(environment);
+
+	storage.get_staging()->load("lvm1-devicegraph.xml");
+	storage.get_staging()->save("binary-format-probe.bin", DevicegraphFormat::BINARY);
+    }
+
+    Environment environment(true, ProbeMode::READ_DEVICEGRAPH, TargetMode::DIRECT);
+    environment.set_devicegraph_filename("binary-format-probe.bin");
+
+    Storage storage(environment);
+    storage.probe();
+
+    Devicegraph* xml = storage.create_devicegraph("xml");
+    xml->load("lvm1-devicegraph.xml");
+
+    BOOST_CHECK(*storage.get_probed() == *xml);
+
+    unlink("binary-format-probe.bin");
+}
+
+
+BOOST_AUTO_TEST_CASE(corrupt)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    storage.get_staging()->load("lvm1-devicegraph.xml");
+    storage.get_staging()->save("binary-format-corrupt.bin", DevicegraphFormat::BINARY);
+
+    // a truncated file is rejected
+
+    BOOST_CHECK_EQUAL(truncate("binary-format-corrupt.bin", 100), 0);
+
+    BOOST_CHECK_THROW(storage.get_staging()->load("binary-format-corrupt.bin"), Exception);
+    BOOST_CHECK(storage.get_staging()->empty());
+
+    unlink("binary-format-corrupt.bin");
+}